@@ -54,6 +54,12 @@
  * <tr><td>@ref nBitsSet           </td>
  * <td><a href="https://github.com/gibsjose/BitHacks/blob/master/BitHacks.md#counting-bits-set-in-14-24-or-32-bit-words-using-64-bit-instructions">
  * Counting bits set in 14, 24, or 32-bit words using 64-bit instructions</a></td></tr>
+ * <tr><td>@ref nBitsSet64         </td>
+ * <td><a href="https://github.com/gibsjose/BitHacks/blob/master/BitHacks.md#counting-bits-set-in-parallel">
+ * Counting bits set, in parallel</a></td></tr>
+ * <tr><td>@ref nTrailingZeros64   </td>
+ * <td><a href="https://github.com/gibsjose/BitHacks/blob/master/BitHacks.md#count-the-consecutive-zero-bits-trailing-on-the-right-with-multiply-and-lookup">
+ * Count the consecutive zero bits (trailing) on the right with multiply and lookup</a></td></tr>
  * <tr><td>@ref isOddParity        </td>
  * <td><a href="https://github.com/gibsjose/BitHacks/blob/master/BitHacks.md#compute-parity-of-word-with-a-multiply">
  * Compute parity of word with a multiply</a></td></tr>
@@ -69,6 +75,9 @@
  * <tr><td>@ref roundUpToPowerOf2  </td>
  * <td><a href="https://github.com/gibsjose/BitHacks/blob/master/BitHacks.md#round-up-to-the-next-highest-power-of-2-by-float-casting">
  * Round up to the next highest power of 2 by float casting</a></td></tr>
+ * <tr><td>@ref mortonEncode2D     </td>
+ * <td><a href="https://github.com/gibsjose/BitHacks/blob/master/BitHacks.md#interleave-bits-by-binary-magic-numbers">
+ * Interleave bits by Binary Magic Numbers</a></td></tr>
  * </table>
  *
  ******************************************************************************/
@@ -92,6 +101,7 @@ extern "C" {
  * Includes
  ******************************************************************************/
 //#include <xc.h>                       /* Include for PIC microcontrollers. */
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -99,6 +109,34 @@ extern "C" {
  * Defines
  ******************************************************************************/
 #define BITOPERATIONS_NCHAR_BITS    8   /**< Number of bits in a byte. */
+#define HIERARCHICAL_BITMAP_LEVELS  11  /**< Levels of a 2^64-bit bitmap. */
+#define PRIORITY_BITMAP_LEVELS      256 /**< Priorities, a multiple of 64. */
+#define TIMING_WHEEL_LEVELS         6   /**< Levels of 64 slots of a wheel. */
+/** Default minimum number of words of a chunk of a thread, 128 KiB. */
+#define BUFFER_PARTITION_MIN_WORDS  16384
+/** Maximum number of threads of a parallel large-buffer function. */
+#define BUFFER_THREADS_MAX          64
+
+/* Define to not use the BMI2 PEXT and PDEP instructions when compiling for
+ * BMI2, for example for AMD processors before Zen 3 on which those are slow.
+ */
+//#define BITOPERATIONS_NO_BMI2
+
+#ifdef __GNUC__
+/** The atomic bitmap functions are available, built on the GCC atomics. */
+#define BITOPERATIONS_ATOMIC
+#endif
+
+/* Define to not build the parallel large-buffer functions, which create POSIX
+ * threads and need linking with -pthread.
+ */
+//#define BITOPERATIONS_NO_THREADS
+
+#if defined(BITOPERATIONS_ATOMIC) && !defined(BITOPERATIONS_NO_THREADS) \
+        && (defined(__unix__) || defined(__APPLE__))
+/** The parallel large-buffer functions are available, built on pthreads. */
+#define BITOPERATIONS_THREADS
+#endif
 
 /*******************************************************************************
  * Function macros
@@ -183,6 +221,288 @@ extern "C" {
  */
 #define SHIFT_RIGHT(v, n) ((v) >>= (n))
 
+/**
+ * @brief   Get the number of 64-bit words needed for a buffer of bits.
+ *
+ * Buffers of bits are arrays of uint64_t in which bit n is bit (n % 64) of
+ * word (n / 64).
+ *
+ * @param   nBits Number of bits in the buffer.
+ * @return  size_t Number of 64-bit words needed to hold nBits bits.
+ */
+#define BITBUF_NWORDS(nBits) (((nBits) + 63) / 64)
+
+/*******************************************************************************
+ * Type definitions
+ ******************************************************************************/
+/** @brief Order in which the bits of a bit stream are packed into bytes. */
+typedef enum {
+    BIT_ORDER_MSB_FIRST,    /**< First bit goes to bit 7 of a byte (JPEG). */
+    BIT_ORDER_LSB_FIRST     /**< First bit goes to bit 0 of a byte (Deflate). */
+} BitOrder;
+
+/**
+ * @brief   Writer for a stream of variable-width bit fields.
+ *
+ * Bits are collected in a 64-bit accumulator of which whole bytes are stored
+ * to the buffer after every write. Initialise with @ref bitWriterInit.
+ */
+typedef struct {
+    uint8_t *buf;           /**< Output buffer. */
+    size_t size;            /**< Size of the output buffer in bytes. */
+    size_t pos;             /**< Index of the next byte to store. */
+    uint64_t acc;           /**< Bit accumulator. */
+    uint8_t nBits;          /**< Number of pending bits in the accumulator. */
+    BitOrder order;         /**< Bit order of the stream. */
+} BitWriter;
+
+/**
+ * @brief   Reader for a stream of variable-width bit fields.
+ *
+ * Bits are read from a 64-bit accumulator that is refilled with whole bytes.
+ * Reading beyond the end of the buffer yields zero bits. Initialise with
+ * @ref bitReaderInit.
+ */
+typedef struct {
+    uint8_t const *buf;     /**< Input buffer. */
+    size_t size;            /**< Size of the input buffer in bytes. */
+    size_t pos;             /**< Index of the next byte to load. */
+    uint64_t acc;           /**< Bit accumulator. */
+    uint8_t nBits;          /**< Number of valid bits in the accumulator. */
+    BitOrder order;         /**< Bit order of the stream. */
+} BitReader;
+
+/**
+ * @brief   Precomputed plan for extracting or depositing bits according to a
+ * fixed mask.
+ *
+ * Holds the masks of the six steps of the parallel suffix method (Hacker's
+ * Delight, section 7-4). Initialise with @ref bitExtractPlanInit.
+ */
+typedef struct {
+    uint64_t mask;          /**< Mask to extract or deposit the bits of. */
+    uint64_t move[6];       /**< Bits to move 2^i places in step i. */
+} BitExtractPlan;
+
+/**
+ * @brief   The k codes nearest to a query by Hamming distance.
+ *
+ * The results are kept in caller-provided arrays of k entries, as a max-heap
+ * with the furthest result at the root. Equal distances are ranked by index.
+ * Initialise with @ref hammingTopKInit.
+ */
+typedef struct {
+    size_t *index;          /**< Indices of the results. */
+    uint32_t *distance;     /**< Distances of the results. */
+    size_t k;               /**< Maximum number of results. */
+    size_t n;               /**< Number of results found. */
+} HammingTopK;
+
+/**
+ * @brief   The k codes most similar to a query by Tanimoto similarity.
+ *
+ * The results are kept in caller-provided arrays of k entries, as a min-heap
+ * with the least similar result at the root. Equal similarities are ranked by
+ * index. Initialise with @ref tanimotoTopKInit.
+ */
+typedef struct {
+    size_t *index;          /**< Indices of the results. */
+    double *similarity;     /**< Similarities of the results. */
+    size_t k;               /**< Maximum number of results. */
+    size_t n;               /**< Number of results found. */
+    double threshold;       /**< Minimum similarity of a result. */
+} TanimotoTopK;
+
+/**
+ * @brief   Blocked Bloom filter.
+ *
+ * Every key sets one bit in each of the eight words of one 64-byte block, so
+ * that an insert or query touches a single cache line. Initialise with
+ * @ref bloomFilterInit.
+ */
+typedef struct {
+    uint64_t *blocks;       /**< Blocks of 8 words. */
+    size_t nBlocks;         /**< Number of blocks. */
+} BloomFilter;
+
+/**
+ * @brief   Binary fuse filter for a static set of keys.
+ *
+ * A key is in the filter when the XOR of three fingerprints, at positions
+ * derived from its hash in three consecutive segments, equals the fingerprint
+ * of the key (Graf and Lemire, 2022). Initialise with
+ * @ref binaryFuseFilterInit.
+ */
+typedef struct {
+    void *fingerprints;         /**< Array of 8 or 16-bit fingerprints. */
+    uint64_t seed;              /**< Seed of the hash of the keys. */
+    uint32_t segmentLength;     /**< Fingerprints in a segment, a power of 2. */
+    uint32_t segmentCountLength;/**< Fingerprints in all first segments. */
+    uint32_t arrayLength;       /**< Number of fingerprints. */
+    uint8_t bits;               /**< Bits of a fingerprint, 8 or 16. */
+} BinaryFuseFilter;
+
+/**
+ * @brief   Bitmap with a 64-ary summary tree.
+ *
+ * Every bit of summary level l + 1 records whether a word of level l has any
+ * bit set, and whether it has any bit cleared, so that searches skip 64^l
+ * bits at a time. Initialise with @ref hierarchicalBitmapInit.
+ */
+typedef struct {
+    /** Words of every level, of which level 0 is the bitmap itself. */
+    uint64_t *nonEmpty[HIERARCHICAL_BITMAP_LEVELS];
+    /** Words of every summary level that record which words are not full. */
+    uint64_t *nonFull[HIERARCHICAL_BITMAP_LEVELS];
+    size_t nWords[HIERARCHICAL_BITMAP_LEVELS];  /**< Words of every level. */
+    size_t nBits;           /**< Number of bits in the bitmap. */
+    uint8_t nLevels;        /**< Number of levels, the bitmap included. */
+} HierarchicalBitmap;
+
+/**
+ * @brief   Bitmap of the non-empty queues of a priority scheduler.
+ *
+ * A summary word records which words of the bitmap have any bit set, so that
+ * the highest priority is found with two leading zero counts. Initialise with
+ * @ref priorityBitmapInit. The atomic functions leave the summary alone, so a
+ * bitmap shared between threads is only accessed with those.
+ */
+typedef struct {
+    uint64_t summary;       /**< Bit i is set if word i has any bit set. */
+    /** Bit p % 64 of word p / 64 is set if priority p is non-empty. */
+    uint64_t words[PRIORITY_BITMAP_LEVELS / 64];
+} PriorityBitmap;
+
+/**
+ * @brief   Timer of a timing wheel, to embed in the object it times.
+ *
+ * Initialise with @ref timingWheelTimerInit. A timer is also used as the head
+ * of a circular list of timers.
+ */
+typedef struct TimingWheelTimer {
+    struct TimingWheelTimer *next;  /**< Next timer in the list. */
+    struct TimingWheelTimer *prev;  /**< Previous timer in the list. */
+    uint64_t expiry;                /**< Tick at which the timer expires. */
+    uint16_t slot;                  /**< Slot of the wheel holding the timer. */
+} TimingWheelTimer;
+
+/**
+ * @brief   Hierarchical timing wheel.
+ *
+ * Level l has 64 slots of 64^l ticks. A timer is kept in the level of the
+ * highest 6-bit digit in which its expiry differs from the current tick, and
+ * moves down a level when the current tick reaches its slot. A word per level
+ * records which slots hold timers, so that the next tick with work is found
+ * with a trailing zero count per level. Initialise with
+ * @ref timingWheelInit.
+ */
+typedef struct {
+    uint64_t now;           /**< Next tick of which to expire the timers. */
+    uint64_t later;         /**< Tick at which to place the later timers. */
+    uint64_t occupied[TIMING_WHEEL_LEVELS];  /**< Slots holding timers. */
+    /** List heads of the slots of every level, and of the later timers. */
+    TimingWheelTimer slots[64 * TIMING_WHEEL_LEVELS + 1];
+} TimingWheel;
+
+/**
+ * @brief   Allocator of fixed-size objects from slabs of caller memory.
+ *
+ * A bitmap per slab records which of its slots are allocated, so that a free
+ * slot is found with a trailing zero count per word. Objects freed by other
+ * threads are recorded in a second bitmap with atomic bit sets, and are
+ * collected by the owning thread when its active slab runs full. Use an
+ * allocator per CPU or thread. Initialise with @ref slabAllocatorInit.
+ */
+typedef struct {
+    uint8_t *objects;       /**< Objects of all slabs, slab after slab. */
+    uint64_t *used;         /**< Allocated slots of all slabs. */
+    uint64_t *freed;        /**< Slots freed by other threads, not collected. */
+    size_t objectSize;      /**< Size of an object in bytes. */
+    size_t slabObjects;     /**< Number of objects in a slab. */
+    size_t nSlabs;          /**< Number of slabs. */
+    size_t active;          /**< Slab to allocate from. */
+} SlabAllocator;
+
+/**
+ * @brief   Index of the runs of zeros of a buffer of bits.
+ *
+ * For every chunk of 512 bits, one cache line, the index keeps the longest
+ * run of zeros and the zeros at its start and end, so that a search for a run
+ * skips the chunks that cannot hold it. Initialise with
+ * @ref zeroRunIndexInit.
+ */
+typedef struct {
+    uint64_t *bits;         /**< Buffer of bits, in which zeros are free. */
+    uint16_t *longest;      /**< Longest run of zeros of every chunk. */
+    uint16_t *head;         /**< Zeros at the start of every chunk. */
+    uint16_t *tail;         /**< Zeros at the end of every chunk. */
+    size_t nBits;           /**< Number of bits in the buffer. */
+    size_t nChunks;         /**< Number of chunks. */
+} ZeroRunIndex;
+
+/**
+ * @brief   Work-stealing deque of tasks of a worker thread.
+ *
+ * The owner pushes and pops tasks at the bottom, and other workers steal them
+ * from the top, without locking (Chase and Lev, in the C11 form of Lê et al.).
+ * A task is a 64-bit value, e.g. an index or a pointer. Initialise with
+ * @ref workDequeInit.
+ */
+typedef struct {
+    uint64_t *tasks;        /**< Ring buffer of the tasks. */
+    int64_t mask;           /**< Capacity minus one. */
+    int64_t top;            /**< Position of the oldest task, to steal. */
+    int64_t bottom;         /**< Position after the newest task. */
+} WorkDeque;
+
+/**
+ * @brief   Function that runs a task of a work-stealing deque.
+ */
+typedef void (*WorkFunction)(void *_context, uint64_t _task);
+
+/**
+ * @brief   Threads of the parallel large-buffer functions.
+ *
+ * Initialise with @ref bufferThreadsInit.
+ */
+typedef struct {
+    size_t nThreads;        /**< Threads, 1 to BUFFER_THREADS_MAX. */
+    size_t minWords;        /**< Minimum number of words of a chunk. */
+    bool pin;               /**< Pin thread i to allowed CPU i, on Linux. */
+} BufferThreads;
+
+/**
+ * @brief   Bit-sliced index of a column of unsigned integers.
+ *
+ * Slice s is a bitmap of the rows of which bit s of the value is set, so that
+ * range predicates and sums are evaluated with a pass over every slice
+ * instead of a pass over the values (O'Neil and Quass). Initialise with
+ * @ref bitSlicedIndexInit.
+ */
+typedef struct {
+    uint64_t *slices;       /**< Slices of nWords words, from bit 0 up. */
+    size_t nRows;           /**< Number of rows. */
+    size_t nWords;          /**< Number of words of a slice. */
+    uint8_t nSlices;        /**< Number of bits of the values, at most 32. */
+} BitSlicedIndex;
+
+/** @brief Comparison of the values of a column with a constant. */
+typedef enum {
+    COMPARE_LESS,           /**< Value < constant. */
+    COMPARE_LESS_EQUAL,     /**< Value <= constant. */
+    COMPARE_EQUAL,          /**< Value == constant. */
+    COMPARE_NOT_EQUAL,      /**< Value != constant. */
+    COMPARE_GREATER_EQUAL,  /**< Value >= constant. */
+    COMPARE_GREATER         /**< Value > constant. */
+} CompareOp;
+
+/** @brief How a selection is combined with the selection bitmap. */
+typedef enum {
+    SELECT_SET,             /**< Replace the bitmap with the selection. */
+    SELECT_AND,             /**< AND the selection into the bitmap. */
+    SELECT_OR               /**< OR the selection into the bitmap. */
+} SelectMode;
+
 /*******************************************************************************
  * Function prototypes
  ******************************************************************************/
@@ -306,6 +626,35 @@ mergeBits(uint32_t const _x, uint32_t const _y, uint32_t const _mask);
 uint8_t
 nBitsSet(uint32_t const _var);
 
+/**
+ * @brief   Counting bits set in a 64-bit variable.
+ *
+ * @param   _var Variable of which to check how much bits are set.
+ * @return  uint8_t Number of bits set in _var.
+ */
+uint8_t
+nBitsSet64(uint64_t const _var);
+
+/**
+ * @brief   Count the consecutive zero bits on the right.
+ *
+ * @param   _var Variable of which to count the trailing zero bits.
+ * @return  uint8_t Number of zero bits below the lowest set bit of _var, or 64
+ * if _var is 0.
+ */
+uint8_t
+nTrailingZeros64(uint64_t const _var);
+
+/**
+ * @brief   Count the consecutive zero bits on the left.
+ *
+ * @param   _var Variable of which to count the leading zero bits.
+ * @return  uint8_t Number of zero bits above the highest set bit of _var, or
+ * 64 if _var is 0.
+ */
+uint8_t
+nLeadingZeros64(uint64_t const _var);
+
 /**
  * @brief   Compute parity of word with a multiply.
  *
@@ -343,6 +692,20 @@ reverseBitOrderByte(uint8_t const _var);
 uint32_t
 reverseBitOrder(uint32_t const _var);
 
+/**
+ * @brief   Reverse the order of the lowest bits of a variable.
+ *
+ * This converts a code between MSB-first and LSB-first bit order, for example
+ * to write a Huffman code to a stream with @ref BIT_ORDER_LSB_FIRST.
+ *
+ * @param   _var Variable of which the bit order needs to be reversed.
+ * @param   _nBits Number of lowest bits to reverse (0-32).
+ * @return  uint32_t The reversed _nBits lowest bits of _var, or 0 when _nBits
+ * is 0.
+ */
+uint32_t
+reverseBitOrderN(uint32_t const _var, uint8_t const _nBits);
+
 /**
  * @brief   Round up to the next highest power of 2 by float casting.
  *
@@ -354,6 +717,2451 @@ reverseBitOrder(uint32_t const _var);
 uint32_t
 roundUpToPowerOf2(uint32_t const _var);
 
+/********** Bit stream ********************************************************/
+/**
+ * @brief   Initialise a bit writer.
+ *
+ * @param   _w Bit writer to initialise.
+ * @param   _buf Buffer to write the bit stream to.
+ * @param   _size Size of _buf in bytes.
+ * @param   _order Bit order of the stream.
+ */
+void
+bitWriterInit(BitWriter *const _w, uint8_t *const _buf, size_t const _size,
+        BitOrder const _order);
+
+/**
+ * @brief   Write a bit field to a bit stream.
+ *
+ * @param   _w Bit writer to write to.
+ * @param   _value Value of which the _nBits lowest bits are written.
+ * @param   _nBits Number of bits to write (0-64).
+ * @return  bool True if the bits were written, false if the buffer is full.
+ */
+bool
+bitWriterPut(BitWriter *const _w, uint64_t const _value, uint8_t const _nBits);
+
+/**
+ * @brief   Write the pending bits of a bit stream, padded with zero bits to a
+ * whole byte.
+ *
+ * @param   _w Bit writer to flush.
+ * @return  size_t Number of bytes of the buffer that hold the bit stream.
+ */
+size_t
+bitWriterFlush(BitWriter *const _w);
+
+/**
+ * @brief   Get the number of bits written to a bit stream.
+ *
+ * @param   _w Bit writer to get the number of written bits of.
+ * @return  size_t Number of bits written.
+ */
+size_t
+bitWriterBitsWritten(BitWriter const *const _w);
+
+/**
+ * @brief   Initialise a bit reader.
+ *
+ * @param   _r Bit reader to initialise.
+ * @param   _buf Buffer that holds the bit stream.
+ * @param   _size Size of _buf in bytes.
+ * @param   _order Bit order of the stream.
+ */
+void
+bitReaderInit(BitReader *const _r, uint8_t const *const _buf,
+        size_t const _size, BitOrder const _order);
+
+/**
+ * @brief   Get the next bits of a bit stream without consuming them.
+ *
+ * @param   _r Bit reader to peek in.
+ * @param   _nBits Number of bits to peek (0-56).
+ * @return  uint64_t The next _nBits bits, the first bit of the stream being the
+ * most significant bit for @ref BIT_ORDER_MSB_FIRST and the least significant
+ * bit for @ref BIT_ORDER_LSB_FIRST.
+ */
+uint64_t
+bitReaderPeek(BitReader *const _r, uint8_t const _nBits);
+
+/**
+ * @brief   Skip bits of a bit stream.
+ *
+ * @pre     The bits need to be peeked first using @ref bitReaderPeek with at
+ * least _nBits.
+ * @param   _r Bit reader to skip the bits in.
+ * @param   _nBits Number of bits to skip (0-56).
+ */
+void
+bitReaderSkip(BitReader *const _r, uint8_t const _nBits);
+
+/**
+ * @brief   Read and consume a bit field of a bit stream.
+ *
+ * @param   _r Bit reader to read from.
+ * @param   _nBits Number of bits to read (0-64).
+ * @return  uint64_t The read bit field, see @ref bitReaderPeek.
+ */
+uint64_t
+bitReaderGet(BitReader *const _r, uint8_t const _nBits);
+
+/**
+ * @brief   Get the number of bits left in a bit stream.
+ *
+ * @param   _r Bit reader to get the number of bits left of.
+ * @return  int64_t Number of bits left, which is negative when more bits were
+ * read than the stream holds.
+ */
+int64_t
+bitReaderBitsLeft(BitReader const *const _r);
+
+/********** Bit buffer ********************************************************/
+/**
+ * @brief   Copy a range of bits between buffers of bits.
+ *
+ * The bits that are not in the destination range keep their value, as with
+ * @ref mergeBits. See @ref BITBUF_NWORDS for the layout of a buffer of bits.
+ *
+ * @pre     The source and destination ranges may not overlap, use
+ * @ref moveBits for that.
+ * @param   _dst Buffer to copy the bits to.
+ * @param   _dstOffset Number of the first bit to copy to in _dst.
+ * @param   _src Buffer to copy the bits from.
+ * @param   _srcOffset Number of the first bit to copy from in _src.
+ * @param   _nBits Number of bits to copy.
+ */
+void
+copyBits(uint64_t *const _dst, size_t const _dstOffset,
+        uint64_t const *const _src, size_t const _srcOffset,
+        size_t const _nBits);
+
+/**
+ * @brief   Copy a range of bits between possibly overlapping buffers of bits.
+ *
+ * @param   _dst Buffer to copy the bits to.
+ * @param   _dstOffset Number of the first bit to copy to in _dst.
+ * @param   _src Buffer to copy the bits from.
+ * @param   _srcOffset Number of the first bit to copy from in _src.
+ * @param   _nBits Number of bits to copy.
+ */
+void
+moveBits(uint64_t *const _dst, size_t const _dstOffset,
+        uint64_t const *const _src, size_t const _srcOffset,
+        size_t const _nBits);
+
+/**
+ * @brief   Set or clear a range of bits in a buffer of bits.
+ *
+ * @param   _dst Buffer to set or clear the bits in.
+ * @param   _offset Number of the first bit to set or clear.
+ * @param   _nBits Number of bits to set or clear.
+ * @param   _f Flag whether the bits need to be set or cleared (1 or 0).
+ */
+void
+fillBits(uint64_t *const _dst, size_t const _offset, size_t const _nBits,
+        bool const _f);
+
+/**
+ * @brief   Shift a buffer of bits n places left, towards the higher bit
+ * numbers, filling in zero bits.
+ *
+ * Bits of the last word beyond _nBits keep their value in _dst.
+ *
+ * @param   _dst Buffer to store the shifted bits in, which is either _src or
+ * does not overlap _src.
+ * @param   _src Buffer to shift.
+ * @param   _nBits Number of bits in the buffers.
+ * @param   _n Number of positions to shift the buffer left.
+ */
+void
+shiftBitsLeft(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _nBits, size_t const _n);
+
+/**
+ * @brief   Shift a buffer of bits n places right, towards the lower bit
+ * numbers, filling in zero bits.
+ *
+ * @param   _dst Buffer to store the shifted bits in, which is either _src or
+ * does not overlap _src.
+ * @param   _src Buffer to shift.
+ * @param   _nBits Number of bits in the buffers.
+ * @param   _n Number of positions to shift the buffer right.
+ */
+void
+shiftBitsRight(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _nBits, size_t const _n);
+
+/**
+ * @brief   Rotate a buffer of bits n places left, towards the higher bit
+ * numbers.
+ *
+ * When _dst is _src the buffer is rotated in place by swapping blocks of bits,
+ * without a temporary buffer.
+ *
+ * @param   _dst Buffer to store the rotated bits in, which is either _src or
+ * does not overlap _src.
+ * @param   _src Buffer to rotate.
+ * @param   _nBits Number of bits in the buffers.
+ * @param   _n Number of positions to rotate the buffer left.
+ */
+void
+rotateBitsLeft(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _nBits, size_t const _n);
+
+/**
+ * @brief   Rotate a buffer of bits n places right, towards the lower bit
+ * numbers.
+ *
+ * @param   _dst Buffer to store the rotated bits in, which is either _src or
+ * does not overlap _src.
+ * @param   _src Buffer to rotate.
+ * @param   _nBits Number of bits in the buffers.
+ * @param   _n Number of positions to rotate the buffer right.
+ */
+void
+rotateBitsRight(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _nBits, size_t const _n);
+
+/**
+ * @brief   OR a buffer of bits shifted n places left into another buffer, so
+ * <code>dst |= src << n</code>, in a single pass.
+ *
+ * This is the step of bitset dynamic programming such as subset sums, where
+ * _dst may be _src.
+ *
+ * @param   _dst Buffer to OR the shifted bits into, which is either _src or
+ * does not overlap _src.
+ * @param   _src Buffer to shift.
+ * @param   _nBits Number of bits in the buffers.
+ * @param   _n Number of positions to shift _src left.
+ */
+void
+orShiftedBitsLeft(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _nBits, size_t const _n);
+
+/**
+ * @brief   OR a buffer of bits shifted n places right into another buffer, so
+ * <code>dst |= src >> n</code>, in a single pass.
+ *
+ * @param   _dst Buffer to OR the shifted bits into, which is either _src or
+ * does not overlap _src.
+ * @param   _src Buffer to shift.
+ * @param   _nBits Number of bits in the buffers.
+ * @param   _n Number of positions to shift _src right.
+ */
+void
+orShiftedBitsRight(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _nBits, size_t const _n);
+
+/********** Bit extract and deposit *******************************************/
+/**
+ * @brief   Extract the bits of a variable according to a mask, and pack them
+ * into the lowest bits (PEXT).
+ *
+ * @note    This will for example return 3 for the variable 0xA and mask 0xC,
+ * where @ref bitGetm returns 8.
+ * @param   _var Variable to extract the bits from.
+ * @param   _mask Mask of the bits to extract.
+ * @return  uint32_t The extracted bits.
+ */
+uint32_t
+extractBits32(uint32_t const _var, uint32_t const _mask);
+
+/**
+ * @brief   Extract the bits of a variable according to a mask, and pack them
+ * into the lowest bits (PEXT).
+ *
+ * @param   _var Variable to extract the bits from.
+ * @param   _mask Mask of the bits to extract.
+ * @return  uint64_t The extracted bits.
+ */
+uint64_t
+extractBits64(uint64_t const _var, uint64_t const _mask);
+
+/**
+ * @brief   Deposit the lowest bits of a variable at the set bits of a mask
+ * (PDEP), the inverse of @ref extractBits32.
+ *
+ * @param   _var Variable of which the lowest bits are deposited.
+ * @param   _mask Mask of the bits to deposit to.
+ * @return  uint32_t The deposited bits.
+ */
+uint32_t
+depositBits32(uint32_t const _var, uint32_t const _mask);
+
+/**
+ * @brief   Deposit the lowest bits of a variable at the set bits of a mask
+ * (PDEP), the inverse of @ref extractBits64.
+ *
+ * @param   _var Variable of which the lowest bits are deposited.
+ * @param   _mask Mask of the bits to deposit to.
+ * @return  uint64_t The deposited bits.
+ */
+uint64_t
+depositBits64(uint64_t const _var, uint64_t const _mask);
+
+/**
+ * @brief   Compile a mask into a plan for extracting or depositing bits.
+ *
+ * Extracting or depositing with a plan takes six mask-and-shift steps,
+ * independent of the number of bits in the mask.
+ *
+ * @param   _plan Plan to initialise.
+ * @param   _mask Mask of the bits to extract or deposit.
+ */
+void
+bitExtractPlanInit(BitExtractPlan *const _plan, uint64_t const _mask);
+
+/**
+ * @brief   Extract the bits of a variable according to a plan.
+ *
+ * @param   _plan Plan of the mask of the bits to extract.
+ * @param   _var Variable to extract the bits from.
+ * @return  uint64_t The extracted bits, see @ref extractBits64.
+ */
+uint64_t
+extractBitsPlanned(BitExtractPlan const *const _plan, uint64_t const _var);
+
+/**
+ * @brief   Deposit the lowest bits of a variable according to a plan.
+ *
+ * @param   _plan Plan of the mask of the bits to deposit to.
+ * @param   _var Variable of which the lowest bits are deposited.
+ * @return  uint64_t The deposited bits, see @ref depositBits64.
+ */
+uint64_t
+depositBitsPlanned(BitExtractPlan const *const _plan, uint64_t const _var);
+
+/**
+ * @brief   Extract the bits of an array of variables according to one plan.
+ *
+ * @param   _dst Array to store the extracted bits in, which may be _src.
+ * @param   _src Array of variables to extract the bits from.
+ * @param   _n Number of variables in the arrays.
+ * @param   _plan Plan of the mask of the bits to extract.
+ */
+void
+extractBitsBatch(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _n, BitExtractPlan const *const _plan);
+
+/**
+ * @brief   Deposit the lowest bits of an array of variables according to one
+ * plan.
+ *
+ * @param   _dst Array to store the deposited bits in, which may be _src.
+ * @param   _src Array of variables of which the lowest bits are deposited.
+ * @param   _n Number of variables in the arrays.
+ * @param   _plan Plan of the mask of the bits to deposit to.
+ */
+void
+depositBitsBatch(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _n, BitExtractPlan const *const _plan);
+
+/********** Morton code *******************************************************/
+/**
+ * @brief   Interleave the bits of two coordinates into a 2D Morton (Z-order)
+ * code.
+ *
+ * @param   _x X-coordinate, which goes to the even bits of the code.
+ * @param   _y Y-coordinate, which goes to the odd bits of the code.
+ * @return  uint64_t The Morton code.
+ */
+uint64_t
+mortonEncode2D(uint32_t const _x, uint32_t const _y);
+
+/**
+ * @brief   Split a 2D Morton (Z-order) code into its coordinates.
+ *
+ * @param   _code The Morton code.
+ * @param   _x Pointer to store the X-coordinate in.
+ * @param   _y Pointer to store the Y-coordinate in.
+ */
+void
+mortonDecode2D(uint64_t const _code, uint32_t *const _x, uint32_t *const _y);
+
+/**
+ * @brief   Interleave the bits of three coordinates into a 3D Morton (Z-order)
+ * code.
+ *
+ * @param   _x X-coordinate (0-0x1FFFFF), which goes to bits 0, 3, 6, ...
+ * @param   _y Y-coordinate (0-0x1FFFFF), which goes to bits 1, 4, 7, ...
+ * @param   _z Z-coordinate (0-0x1FFFFF), which goes to bits 2, 5, 8, ...
+ * @return  uint64_t The Morton code.
+ */
+uint64_t
+mortonEncode3D(uint32_t const _x, uint32_t const _y, uint32_t const _z);
+
+/**
+ * @brief   Split a 3D Morton (Z-order) code into its coordinates.
+ *
+ * @param   _code The Morton code.
+ * @param   _x Pointer to store the X-coordinate in.
+ * @param   _y Pointer to store the Y-coordinate in.
+ * @param   _z Pointer to store the Z-coordinate in.
+ */
+void
+mortonDecode3D(uint64_t const _code, uint32_t *const _x, uint32_t *const _y,
+        uint32_t *const _z);
+
+/**
+ * @brief   Encode arrays of coordinates into 2D Morton codes.
+ *
+ * @param   _codes Array to store the Morton codes in.
+ * @param   _x Array of X-coordinates.
+ * @param   _y Array of Y-coordinates.
+ * @param   _n Number of points.
+ */
+void
+mortonEncode2DBatch(uint64_t *const _codes, uint32_t const *const _x,
+        uint32_t const *const _y, size_t const _n);
+
+/**
+ * @brief   Decode an array of 2D Morton codes into arrays of coordinates.
+ *
+ * @param   _x Array to store the X-coordinates in.
+ * @param   _y Array to store the Y-coordinates in.
+ * @param   _codes Array of Morton codes.
+ * @param   _n Number of points.
+ */
+void
+mortonDecode2DBatch(uint32_t *const _x, uint32_t *const _y,
+        uint64_t const *const _codes, size_t const _n);
+
+/**
+ * @brief   Encode arrays of coordinates into 3D Morton codes.
+ *
+ * @param   _codes Array to store the Morton codes in.
+ * @param   _x Array of X-coordinates.
+ * @param   _y Array of Y-coordinates.
+ * @param   _z Array of Z-coordinates.
+ * @param   _n Number of points.
+ */
+void
+mortonEncode3DBatch(uint64_t *const _codes, uint32_t const *const _x,
+        uint32_t const *const _y, uint32_t const *const _z, size_t const _n);
+
+/**
+ * @brief   Decode an array of 3D Morton codes into arrays of coordinates.
+ *
+ * @param   _x Array to store the X-coordinates in.
+ * @param   _y Array to store the Y-coordinates in.
+ * @param   _z Array to store the Z-coordinates in.
+ * @param   _codes Array of Morton codes.
+ * @param   _n Number of points.
+ */
+void
+mortonDecode3DBatch(uint32_t *const _x, uint32_t *const _y, uint32_t *const _z,
+        uint64_t const *const _codes, size_t const _n);
+
+/**
+ * @brief   Add two 2D Morton codes coordinate by coordinate, without decoding.
+ *
+ * Adding the code of (1, 0) gives the right neighbour, adding the code of
+ * ((uint32_t)-1, 0) the left neighbour; coordinates wrap around.
+ *
+ * @param   _a First Morton code.
+ * @param   _b Second Morton code.
+ * @return  uint64_t Morton code of the sum of the points.
+ */
+uint64_t
+mortonAdd2D(uint64_t const _a, uint64_t const _b);
+
+/**
+ * @brief   Add two 3D Morton codes coordinate by coordinate, without decoding.
+ *
+ * @param   _a First Morton code.
+ * @param   _b Second Morton code.
+ * @return  uint64_t Morton code of the sum of the points, modulo 2^21 for each
+ * coordinate.
+ */
+uint64_t
+mortonAdd3D(uint64_t const _a, uint64_t const _b);
+
+/**
+ * @brief   Find the smallest 2D Morton code in a box that is larger than a
+ * code outside the box (BIGMIN).
+ *
+ * When a Z-order scan over a range query box [_min, _max] reaches a code
+ * outside the box, it can continue at BIGMIN instead of scanning the codes in
+ * between. Algorithm of Tropf and Herzog.
+ *
+ * @param   _code Morton code between _min and _max, outside the box.
+ * @param   _min Morton code of the lower corner of the box.
+ * @param   _max Morton code of the upper corner of the box.
+ * @return  uint64_t The smallest code in the box larger than _code.
+ */
+uint64_t
+mortonBigMin2D(uint64_t const _code, uint64_t const _min, uint64_t const _max);
+
+/**
+ * @brief   Find the largest 2D Morton code in a box that is smaller than a
+ * code outside the box (LITMAX).
+ *
+ * @param   _code Morton code between _min and _max, outside the box.
+ * @param   _min Morton code of the lower corner of the box.
+ * @param   _max Morton code of the upper corner of the box.
+ * @return  uint64_t The largest code in the box smaller than _code.
+ */
+uint64_t
+mortonLitMax2D(uint64_t const _code, uint64_t const _min, uint64_t const _max);
+
+/**
+ * @brief   Find the smallest 3D Morton code in a box that is larger than a
+ * code outside the box (BIGMIN), see @ref mortonBigMin2D.
+ *
+ * @param   _code Morton code between _min and _max, outside the box.
+ * @param   _min Morton code of the lower corner of the box.
+ * @param   _max Morton code of the upper corner of the box.
+ * @return  uint64_t The smallest code in the box larger than _code.
+ */
+uint64_t
+mortonBigMin3D(uint64_t const _code, uint64_t const _min, uint64_t const _max);
+
+/**
+ * @brief   Find the largest 3D Morton code in a box that is smaller than a
+ * code outside the box (LITMAX), see @ref mortonLitMax2D.
+ *
+ * @param   _code Morton code between _min and _max, outside the box.
+ * @param   _min Morton code of the lower corner of the box.
+ * @param   _max Morton code of the upper corner of the box.
+ * @return  uint64_t The largest code in the box smaller than _code.
+ */
+uint64_t
+mortonLitMax3D(uint64_t const _code, uint64_t const _min, uint64_t const _max);
+
+/********** Hilbert curve *****************************************************/
+/**
+ * @brief   Get the index of a point on the 2D Hilbert curve.
+ *
+ * The curve runs from (0, 0) to (0xFFFFFFFF, 0) and is the curve of John
+ * Skilling's "Programming the Hilbert curve". Unlike the Morton code the
+ * curve never jumps, so points with nearby indices are nearby in space.
+ *
+ * @param   _x X-coordinate.
+ * @param   _y Y-coordinate.
+ * @return  uint64_t The Hilbert index.
+ */
+uint64_t
+hilbertEncode2D(uint32_t const _x, uint32_t const _y);
+
+/**
+ * @brief   Get the point of an index on the 2D Hilbert curve.
+ *
+ * @param   _index The Hilbert index.
+ * @param   _x Pointer to store the X-coordinate in.
+ * @param   _y Pointer to store the Y-coordinate in.
+ */
+void
+hilbertDecode2D(uint64_t const _index, uint32_t *const _x, uint32_t *const _y);
+
+/**
+ * @brief   Get the index of a point on the 3D Hilbert curve.
+ *
+ * The curve runs from (0, 0, 0) to (0x1FFFFF, 0, 0), see
+ * @ref hilbertEncode2D.
+ *
+ * @param   _x X-coordinate (0-0x1FFFFF).
+ * @param   _y Y-coordinate (0-0x1FFFFF).
+ * @param   _z Z-coordinate (0-0x1FFFFF).
+ * @return  uint64_t The Hilbert index.
+ */
+uint64_t
+hilbertEncode3D(uint32_t const _x, uint32_t const _y, uint32_t const _z);
+
+/**
+ * @brief   Get the point of an index on the 3D Hilbert curve.
+ *
+ * @param   _index The Hilbert index.
+ * @param   _x Pointer to store the X-coordinate in.
+ * @param   _y Pointer to store the Y-coordinate in.
+ * @param   _z Pointer to store the Z-coordinate in.
+ */
+void
+hilbertDecode3D(uint64_t const _index, uint32_t *const _x, uint32_t *const _y,
+        uint32_t *const _z);
+
+/**
+ * @brief   Get the 2D Hilbert indices of arrays of coordinates.
+ *
+ * @param   _indices Array to store the Hilbert indices in.
+ * @param   _x Array of X-coordinates.
+ * @param   _y Array of Y-coordinates.
+ * @param   _n Number of points.
+ */
+void
+hilbertEncode2DBatch(uint64_t *const _indices, uint32_t const *const _x,
+        uint32_t const *const _y, size_t const _n);
+
+/**
+ * @brief   Get the points of an array of 2D Hilbert indices.
+ *
+ * @param   _x Array to store the X-coordinates in.
+ * @param   _y Array to store the Y-coordinates in.
+ * @param   _indices Array of Hilbert indices.
+ * @param   _n Number of points.
+ */
+void
+hilbertDecode2DBatch(uint32_t *const _x, uint32_t *const _y,
+        uint64_t const *const _indices, size_t const _n);
+
+/**
+ * @brief   Get the 3D Hilbert indices of arrays of coordinates.
+ *
+ * @param   _indices Array to store the Hilbert indices in.
+ * @param   _x Array of X-coordinates.
+ * @param   _y Array of Y-coordinates.
+ * @param   _z Array of Z-coordinates.
+ * @param   _n Number of points.
+ */
+void
+hilbertEncode3DBatch(uint64_t *const _indices, uint32_t const *const _x,
+        uint32_t const *const _y, uint32_t const *const _z, size_t const _n);
+
+/**
+ * @brief   Get the points of an array of 3D Hilbert indices.
+ *
+ * @param   _x Array to store the X-coordinates in.
+ * @param   _y Array to store the Y-coordinates in.
+ * @param   _z Array to store the Z-coordinates in.
+ * @param   _indices Array of Hilbert indices.
+ * @param   _n Number of points.
+ */
+void
+hilbertDecode3DBatch(uint32_t *const _x, uint32_t *const _y, uint32_t *const _z,
+        uint64_t const *const _indices, size_t const _n);
+
+/********** Bit matrix transpose **********************************************/
+/**
+ * @brief   Transpose an 8x8 bit matrix.
+ *
+ * Row i of the matrix is byte i of the variable, and column j of a row is bit
+ * j of that byte.
+ *
+ * @param   _var The bit matrix to transpose.
+ * @return  uint64_t The transposed bit matrix.
+ */
+uint64_t
+transposeBits8x8(uint64_t const _var);
+
+/**
+ * @brief   Transpose a 32x32 bit matrix.
+ *
+ * Row i of the matrix is _src[i], and column j of a row is bit j.
+ *
+ * @param   _dst Array of 32 rows to store the transposed matrix in, which may
+ * be _src.
+ * @param   _src Array of the 32 rows of the matrix to transpose.
+ */
+void
+transposeBits32x32(uint32_t *const _dst, uint32_t const *const _src);
+
+/**
+ * @brief   Transpose a 64x64 bit matrix.
+ *
+ * Row i of the matrix is _src[i], and column j of a row is bit j.
+ *
+ * @param   _dst Array of 64 rows to store the transposed matrix in, which may
+ * be _src.
+ * @param   _src Array of the 64 rows of the matrix to transpose.
+ */
+void
+transposeBits64x64(uint64_t *const _dst, uint64_t const *const _src);
+
+/**
+ * @brief   Transpose an array of 8x8 bit matrices.
+ *
+ * @param   _dst Array to store the transposed matrices in, which may be _src.
+ * @param   _src Array of matrices to transpose, see @ref transposeBits8x8.
+ * @param   _n Number of matrices.
+ */
+void
+transposeBits8x8Batch(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _n);
+
+/**
+ * @brief   Transpose an array of 32x32 bit matrices.
+ *
+ * @param   _dst Array to store the transposed matrices in, which may be _src.
+ * @param   _src Array of matrices of 32 rows each to transpose.
+ * @param   _n Number of matrices.
+ */
+void
+transposeBits32x32Batch(uint32_t *const _dst, uint32_t const *const _src,
+        size_t const _n);
+
+/**
+ * @brief   Transpose an array of 64x64 bit matrices.
+ *
+ * @param   _dst Array to store the transposed matrices in, which may be _src.
+ * @param   _src Array of matrices of 64 rows each to transpose.
+ * @param   _n Number of matrices.
+ */
+void
+transposeBits64x64Batch(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _n);
+
+/********** Positional population count ***************************************/
+/**
+ * @brief   Count for every bit position how many variables of an array have
+ * that bit set.
+ *
+ * @param   _counts Array of 8 counters, to which the count of bit i is added
+ * in _counts[i].
+ * @param   _data Array of variables to count the bits of.
+ * @param   _n Number of variables in the array.
+ */
+void
+positionalPopcount8(uint64_t *const _counts, uint8_t const *const _data,
+        size_t const _n);
+
+/**
+ * @brief   Count for every bit position how many variables of an array have
+ * that bit set.
+ *
+ * @param   _counts Array of 16 counters, to which the count of bit i is added
+ * in _counts[i].
+ * @param   _data Array of variables to count the bits of.
+ * @param   _n Number of variables in the array.
+ */
+void
+positionalPopcount16(uint64_t *const _counts, uint16_t const *const _data,
+        size_t const _n);
+
+/**
+ * @brief   Count for every bit position how many variables of an array have
+ * that bit set.
+ *
+ * @param   _counts Array of 32 counters, to which the count of bit i is added
+ * in _counts[i].
+ * @param   _data Array of variables to count the bits of.
+ * @param   _n Number of variables in the array.
+ */
+void
+positionalPopcount32(uint64_t *const _counts, uint32_t const *const _data,
+        size_t const _n);
+
+/********** Hamming distance search *******************************************/
+/**
+ * @brief   Count the number of bits that differ between two codes.
+ *
+ * @param   _a First code.
+ * @param   _b Second code.
+ * @param   _nWords Length of the codes in 64-bit words.
+ * @return  uint32_t Hamming distance between _a and _b.
+ */
+uint32_t
+hammingDistance(uint64_t const *const _a, uint64_t const *const _b,
+        size_t const _nWords);
+
+/**
+ * @brief   Initialise an empty top-k result set.
+ *
+ * @param   _t Result set to initialise.
+ * @param   _index Array of _k entries for the indices of the results.
+ * @param   _distance Array of _k entries for the distances of the results.
+ * @param   _k Maximum number of results to keep.
+ */
+void
+hammingTopKInit(HammingTopK *const _t, size_t *const _index,
+        uint32_t *const _distance, size_t const _k);
+
+/**
+ * @brief   Add the codes nearest to a query to a top-k result set.
+ *
+ * Once k results are found, the distance to a long code is not computed
+ * further than the distance of the furthest result.
+ *
+ * @param   _t Result set to add to.
+ * @param   _query Code to search for.
+ * @param   _codes Contiguous array of _nCodes codes.
+ * @param   _nCodes Number of codes to scan.
+ * @param   _nWords Length of a code in 64-bit words.
+ * @param   _firstIndex Index reported for the first code of _codes.
+ *
+ * @note    Large arrays can be scanned in parallel by giving every thread its
+ * own result set and range of codes, with _firstIndex set to the start of the
+ * range, and merging the result sets with @ref hammingTopKMerge.
+ */
+void
+hammingTopKScan(HammingTopK *const _t, uint64_t const *const _query,
+        uint64_t const *const _codes, size_t const _nCodes,
+        size_t const _nWords, size_t const _firstIndex);
+
+/**
+ * @brief   Add the codes nearest to each of several queries to their top-k
+ * result sets.
+ *
+ * The codes are scanned in blocks that stay in the cache while all queries
+ * are compared with them.
+ *
+ * @param   _t Array of _nQueries result sets, one for every query.
+ * @param   _queries Contiguous array of _nQueries codes to search for.
+ * @param   _nQueries Number of queries.
+ * @param   _codes Contiguous array of _nCodes codes.
+ * @param   _nCodes Number of codes to scan.
+ * @param   _nWords Length of a code in 64-bit words.
+ * @param   _firstIndex Index reported for the first code of _codes.
+ */
+void
+hammingTopKScanBatch(HammingTopK *const _t, uint64_t const *const _queries,
+        size_t const _nQueries, uint64_t const *const _codes,
+        size_t const _nCodes, size_t const _nWords, size_t const _firstIndex);
+
+/**
+ * @brief   Add the results of one top-k result set to another.
+ *
+ * @param   _dst Result set to add to.
+ * @param   _src Result set to add the results of.
+ */
+void
+hammingTopKMerge(HammingTopK *const _dst, HammingTopK const *const _src);
+
+/**
+ * @brief   Sort the results of a top-k result set by ascending distance.
+ *
+ * Results with equal distances are sorted by ascending index.
+ *
+ * @param   _t Result set to sort.
+ * @return  size_t Number of results.
+ *
+ * @note    No results can be added to a sorted result set.
+ */
+size_t
+hammingTopKSort(HammingTopK *const _t);
+
+/********** Tanimoto similarity search ****************************************/
+/**
+ * @brief   Count the bits set in every code of an array.
+ *
+ * @param   _counts Array of _nCodes entries for the counts.
+ * @param   _codes Contiguous array of _nCodes codes.
+ * @param   _nCodes Number of codes.
+ * @param   _nWords Length of a code in 64-bit words.
+ */
+void
+nBitsSetBatch(uint32_t *const _counts, uint64_t const *const _codes,
+        size_t const _nCodes, size_t const _nWords);
+
+/**
+ * @brief   Compute the Tanimoto (Jaccard) similarity of two codes.
+ *
+ * The numbers of bits set in both codes and in either code are counted in one
+ * pass.
+ *
+ * @param   _a First code.
+ * @param   _b Second code.
+ * @param   _nWords Length of the codes in 64-bit words.
+ * @return  double Number of bits set in _a & _b divided by the number of bits
+ * set in _a | _b, or 0 if no bits are set in either code.
+ */
+double
+tanimotoSimilarity(uint64_t const *const _a, uint64_t const *const _b,
+        size_t const _nWords);
+
+/**
+ * @brief   Initialise an empty top-k result set.
+ *
+ * @param   _t Result set to initialise.
+ * @param   _index Array of _k entries for the indices of the results.
+ * @param   _similarity Array of _k entries for the similarities of the
+ * results.
+ * @param   _k Maximum number of results to keep.
+ * @param   _threshold Minimum similarity of a result, 0 to keep the _k most
+ * similar codes.
+ */
+void
+tanimotoTopKInit(TanimotoTopK *const _t, size_t *const _index,
+        double *const _similarity, size_t const _k, double const _threshold);
+
+/**
+ * @brief   Add the codes most similar to a query to a top-k result set.
+ *
+ * With the number of bits set in every code given, only the bits set in both
+ * codes have to be counted. Codes of which the number of bits set is too
+ * different from that of the query to reach the threshold or the least
+ * similar result are skipped without being read (Swamidass-Baldi bound).
+ *
+ * @param   _t Result set to add to.
+ * @param   _query Code to search for.
+ * @param   _codes Contiguous array of _nCodes codes.
+ * @param   _counts Number of bits set in every code, see @ref nBitsSetBatch.
+ * @param   _nCodes Number of codes to scan.
+ * @param   _nWords Length of a code in 64-bit words.
+ * @param   _firstIndex Index reported for the first code of _codes.
+ *
+ * @note    Large arrays can be scanned in parallel by giving every thread its
+ * own result set and range of codes, and merging the result sets with
+ * @ref tanimotoTopKMerge.
+ */
+void
+tanimotoTopKScan(TanimotoTopK *const _t, uint64_t const *const _query,
+        uint64_t const *const _codes, uint32_t const *const _counts,
+        size_t const _nCodes, size_t const _nWords, size_t const _firstIndex);
+
+/**
+ * @brief   Add the results of one top-k result set to another.
+ *
+ * @param   _dst Result set to add to.
+ * @param   _src Result set to add the results of.
+ */
+void
+tanimotoTopKMerge(TanimotoTopK *const _dst, TanimotoTopK const *const _src);
+
+/**
+ * @brief   Sort the results of a top-k result set by descending similarity.
+ *
+ * Results with equal similarities are sorted by ascending index.
+ *
+ * @param   _t Result set to sort.
+ * @return  size_t Number of results.
+ *
+ * @note    No results can be added to a sorted result set.
+ */
+size_t
+tanimotoTopKSort(TanimotoTopK *const _t);
+
+/********** Blocked Bloom filter **********************************************/
+/**
+ * @brief   Initialise an empty Bloom filter.
+ *
+ * @param   _f Bloom filter to initialise.
+ * @param   _words Array to hold the filter, which is cleared.
+ * @param   _nWords Number of words in _words, of which whole blocks of 8 words
+ * are used, up to 2^32 blocks (256 GiB).
+ *
+ * @pre     _nWords is at least 8. Align _words to 64 bytes for every block to
+ * be in one cache line.
+ * @note    About 16 bits per key give a false positive rate below 1%.
+ */
+void
+bloomFilterInit(BloomFilter *const _f, uint64_t *const _words,
+        size_t const _nWords);
+
+/**
+ * @brief   Insert a key into a Bloom filter.
+ *
+ * @param   _f Bloom filter to insert into.
+ * @param   _hash Well-mixed 64-bit hash of the key.
+ */
+void
+bloomFilterInsert(BloomFilter *const _f, uint64_t const _hash);
+
+/**
+ * @brief   Query whether a key may have been inserted into a Bloom filter.
+ *
+ * @param   _f Bloom filter to query.
+ * @param   _hash Well-mixed 64-bit hash of the key.
+ * @return  bool False if the key was not inserted, true if it may have been.
+ */
+bool
+bloomFilterQuery(BloomFilter const *const _f, uint64_t const _hash);
+
+/**
+ * @brief   Insert an array of keys into a Bloom filter.
+ *
+ * The blocks of a group of keys are prefetched before any of them is updated,
+ * so that the cache misses overlap.
+ *
+ * @param   _f Bloom filter to insert into.
+ * @param   _hashes Array of _n hashes of the keys.
+ * @param   _n Number of keys.
+ */
+void
+bloomFilterInsertBatch(BloomFilter *const _f, uint64_t const *const _hashes,
+        size_t const _n);
+
+/**
+ * @brief   Query whether the keys of an array may have been inserted into a
+ * Bloom filter.
+ *
+ * The blocks of a group of keys are prefetched before any of them is probed,
+ * so that the cache misses overlap.
+ *
+ * @param   _f Bloom filter to query.
+ * @param   _result Buffer of _n bits, of which bit i is set if key i may have
+ * been inserted and cleared if not.
+ * @param   _hashes Array of _n hashes of the keys.
+ * @param   _n Number of keys.
+ * @return  size_t Number of keys that may have been inserted.
+ */
+size_t
+bloomFilterQueryBatch(BloomFilter const *const _f, uint64_t *const _result,
+        uint64_t const *const _hashes, size_t const _n);
+
+/********** Binary fuse filter ************************************************/
+/**
+ * @brief   Initialise the dimensions of a binary fuse filter for a number of
+ * keys.
+ *
+ * @param   _f Binary fuse filter to initialise.
+ * @param   _n Number of keys.
+ * @param   _bits Bits of a fingerprint, 8 or 16, for a false positive rate of
+ * about 1/256 or 1/65536.
+ * @return  size_t Number of fingerprints of the filter, of _bits / 8 bytes
+ * each, which is about 1.13 times _n for large sets.
+ *
+ * @pre     _n is less than 2^31.
+ */
+size_t
+binaryFuseFilterInit(BinaryFuseFilter *const _f, size_t const _n,
+        uint8_t const _bits);
+
+/**
+ * @brief   Get the size of the scratch memory to build a binary fuse filter.
+ *
+ * @param   _f Binary fuse filter initialised for _n keys.
+ * @param   _n Number of keys.
+ * @return  size_t Size of the scratch memory in bytes, about 24 bytes per key.
+ */
+size_t
+binaryFuseFilterScratchSize(BinaryFuseFilter const *const _f, size_t const _n);
+
+/**
+ * @brief   Build a binary fuse filter of a set of keys.
+ *
+ * @param   _f Binary fuse filter initialised for _n keys.
+ * @param   _fingerprints Array for the fingerprints of the filter.
+ * @param   _scratch Scratch memory of @ref binaryFuseFilterScratchSize bytes,
+ * aligned to 8 bytes.
+ * @param   _keys Array of _n keys.
+ * @param   _n Number of keys.
+ * @return  bool True if the filter is built, false if no seed was found for
+ * which the keys could be placed.
+ *
+ * @note    Duplicate keys are removed while building, but when many keys are
+ * duplicated building can fail.
+ */
+bool
+binaryFuseFilterBuild(BinaryFuseFilter *const _f, void *const _fingerprints,
+        void *const _scratch, uint64_t const *const _keys, size_t const _n);
+
+/**
+ * @brief   Query whether a key may be in a binary fuse filter.
+ *
+ * @param   _f Binary fuse filter to query.
+ * @param   _key Key to query.
+ * @return  bool False if the key is not in the set, true if it may be.
+ */
+bool
+binaryFuseFilterContains(BinaryFuseFilter const *const _f,
+        uint64_t const _key);
+
+/**
+ * @brief   Query whether the keys of an array may be in a binary fuse filter.
+ *
+ * The fingerprints of a group of keys are prefetched before any of them is
+ * read, so that the cache misses overlap.
+ *
+ * @param   _f Binary fuse filter to query.
+ * @param   _result Buffer of _n bits, of which bit i is set if key i may be in
+ * the set and cleared if not.
+ * @param   _keys Array of _n keys to query.
+ * @param   _n Number of keys.
+ * @return  size_t Number of keys that may be in the set.
+ */
+size_t
+binaryFuseFilterContainsBatch(BinaryFuseFilter const *const _f,
+        uint64_t *const _result, uint64_t const *const _keys,
+        size_t const _n);
+
+/********** Atomic bitmap *****************************************************/
+#ifdef BITOPERATIONS_ATOMIC
+/**
+ * @brief   Atomically set a bit in a buffer of bits.
+ *
+ * @param   _bits Buffer of bits.
+ * @param   _n Number of the bit to set.
+ *
+ * @note    All atomic bitmap functions are lock-free read-modify-writes of a
+ * single word with acquire and release ordering.
+ */
+void
+atomicBitSet(uint64_t *const _bits, size_t const _n);
+
+/**
+ * @brief   Atomically clear a bit in a buffer of bits.
+ *
+ * @param   _bits Buffer of bits.
+ * @param   _n Number of the bit to clear.
+ */
+void
+atomicBitClear(uint64_t *const _bits, size_t const _n);
+
+/**
+ * @brief   Atomically set a bit in a buffer of bits and get its old value.
+ *
+ * @param   _bits Buffer of bits.
+ * @param   _n Number of the bit to set.
+ * @return  bool True if the bit was set already, false if it was set by this
+ * call.
+ */
+bool
+atomicBitTestAndSet(uint64_t *const _bits, size_t const _n);
+
+/**
+ * @brief   Atomically clear a bit in a buffer of bits and get its old value.
+ *
+ * @param   _bits Buffer of bits.
+ * @param   _n Number of the bit to clear.
+ * @return  bool True if the bit was cleared by this call, false if it was
+ * cleared already.
+ */
+bool
+atomicBitTestAndClear(uint64_t *const _bits, size_t const _n);
+
+/**
+ * @brief   Atomically find and set a cleared bit in a buffer of bits.
+ *
+ * The words are scanned from the word of bit _hint onwards, wrapping around,
+ * and the lowest cleared bit of a word is claimed. When another thread claims
+ * the bit first, the scan retries on the updated word.
+ *
+ * @param   _bits Buffer of bits.
+ * @param   _nBits Number of bits in the buffer.
+ * @param   _hint Bit to start the scan at. Threads that start at different
+ * cache lines, e.g. 512 * thread number, contend less.
+ * @return  size_t Number of the bit that was set, or _nBits if all bits are
+ * set.
+ */
+size_t
+atomicBitAcquireFirstZero(uint64_t *const _bits, size_t const _nBits,
+        size_t const _hint);
+#endif	/* BITOPERATIONS_ATOMIC */
+
+/********** Hierarchical bitmap ***********************************************/
+/**
+ * @brief   Get the number of words to hold a hierarchical bitmap.
+ *
+ * @param   _nBits Number of bits in the bitmap.
+ * @return  size_t Number of 64-bit words for the bitmap and its summaries,
+ * about 1.03 times BITBUF_NWORDS(_nBits).
+ */
+size_t
+hierarchicalBitmapNWords(size_t const _nBits);
+
+/**
+ * @brief   Initialise a hierarchical bitmap with all bits cleared.
+ *
+ * @param   _b Hierarchical bitmap to initialise.
+ * @param   _words Array of @ref hierarchicalBitmapNWords words to hold the
+ * bitmap, of which the first BITBUF_NWORDS(_nBits) words are the bitmap as a
+ * buffer of bits.
+ * @param   _nBits Number of bits in the bitmap.
+ */
+void
+hierarchicalBitmapInit(HierarchicalBitmap *const _b, uint64_t *const _words,
+        size_t const _nBits);
+
+/**
+ * @brief   Set a bit of a hierarchical bitmap.
+ *
+ * @param   _b Hierarchical bitmap.
+ * @param   _n Number of the bit to set.
+ */
+void
+hierarchicalBitmapSet(HierarchicalBitmap *const _b, size_t const _n);
+
+/**
+ * @brief   Clear a bit of a hierarchical bitmap.
+ *
+ * @param   _b Hierarchical bitmap.
+ * @param   _n Number of the bit to clear.
+ */
+void
+hierarchicalBitmapClear(HierarchicalBitmap *const _b, size_t const _n);
+
+/**
+ * @brief   Get a bit of a hierarchical bitmap.
+ *
+ * @param   _b Hierarchical bitmap.
+ * @param   _n Number of the bit to get.
+ * @return  bool True if the bit is set, false else.
+ */
+bool
+hierarchicalBitmapGet(HierarchicalBitmap const *const _b, size_t const _n);
+
+/**
+ * @brief   Find the first set bit at or after a bit of a hierarchical bitmap.
+ *
+ * @param   _b Hierarchical bitmap.
+ * @param   _n Number of the bit to start at.
+ * @return  size_t Number of the set bit, or the number of bits in the bitmap
+ * if no bit from _n onwards is set.
+ */
+size_t
+hierarchicalBitmapNextSet(HierarchicalBitmap const *const _b, size_t const _n);
+
+/**
+ * @brief   Find the last set bit at or before a bit of a hierarchical bitmap.
+ *
+ * @param   _b Hierarchical bitmap.
+ * @param   _n Number of the bit to start at.
+ * @return  size_t Number of the set bit, or the number of bits in the bitmap
+ * if no bit up to _n is set.
+ */
+size_t
+hierarchicalBitmapPrevSet(HierarchicalBitmap const *const _b, size_t const _n);
+
+/**
+ * @brief   Find the first cleared bit at or after a bit of a hierarchical
+ * bitmap.
+ *
+ * @param   _b Hierarchical bitmap.
+ * @param   _n Number of the bit to start at, 0 for the first cleared bit.
+ * @return  size_t Number of the cleared bit, or the number of bits in the
+ * bitmap if all bits from _n onwards are set.
+ */
+size_t
+hierarchicalBitmapNextZero(HierarchicalBitmap const *const _b,
+        size_t const _n);
+
+/**
+ * @brief   Check whether a range of bits of a hierarchical bitmap is empty.
+ *
+ * @param   _b Hierarchical bitmap.
+ * @param   _first Number of the first bit of the range.
+ * @param   _nBits Number of bits in the range.
+ * @return  bool True if no bit of the range is set, false else.
+ */
+bool
+hierarchicalBitmapIsRangeEmpty(HierarchicalBitmap const *const _b,
+        size_t const _first, size_t const _nBits);
+
+/********** Priority bitmap ***************************************************/
+/**
+ * @brief   Initialise a priority bitmap with all priorities empty.
+ *
+ * @param   _b Priority bitmap to initialise.
+ */
+void
+priorityBitmapInit(PriorityBitmap *const _b);
+
+/**
+ * @brief   Mark a priority as non-empty, e.g. when a task is enqueued.
+ *
+ * @param   _b Priority bitmap.
+ * @param   _priority Priority to mark (0 to PRIORITY_BITMAP_LEVELS - 1).
+ */
+void
+priorityBitmapSet(PriorityBitmap *const _b, uint16_t const _priority);
+
+/**
+ * @brief   Mark a priority as empty, e.g. when its last task is dequeued.
+ *
+ * @param   _b Priority bitmap.
+ * @param   _priority Priority to mark (0 to PRIORITY_BITMAP_LEVELS - 1).
+ */
+void
+priorityBitmapClear(PriorityBitmap *const _b, uint16_t const _priority);
+
+/**
+ * @brief   Find the highest non-empty priority.
+ *
+ * @param   _b Priority bitmap.
+ * @return  int16_t Highest non-empty priority, or -1 if all are empty.
+ */
+int16_t
+priorityBitmapHighest(PriorityBitmap const *const _b);
+
+#ifdef BITOPERATIONS_ATOMIC
+/**
+ * @brief   Atomically mark a priority as non-empty.
+ *
+ * @param   _b Priority bitmap shared between threads.
+ * @param   _priority Priority to mark (0 to PRIORITY_BITMAP_LEVELS - 1).
+ */
+void
+atomicPriorityBitmapSet(PriorityBitmap *const _b, uint16_t const _priority);
+
+/**
+ * @brief   Atomically mark a priority as empty.
+ *
+ * @param   _b Priority bitmap shared between threads.
+ * @param   _priority Priority to mark (0 to PRIORITY_BITMAP_LEVELS - 1).
+ */
+void
+atomicPriorityBitmapClear(PriorityBitmap *const _b, uint16_t const _priority);
+
+/**
+ * @brief   Atomically find the highest non-empty priority.
+ *
+ * The result is at least every priority that was set before the call and is
+ * not cleared during it. The words are scanned one by one, in
+ * PRIORITY_BITMAP_LEVELS / 64 loads.
+ *
+ * @param   _b Priority bitmap shared between threads.
+ * @return  int16_t Highest non-empty priority, or -1 if all are empty.
+ */
+int16_t
+atomicPriorityBitmapHighest(PriorityBitmap const *const _b);
+#endif	/* BITOPERATIONS_ATOMIC */
+
+/********** Timing wheel ******************************************************/
+/**
+ * @brief   Initialise a timer, or an empty list of timers.
+ *
+ * @param   _t Timer to initialise.
+ */
+void
+timingWheelTimerInit(TimingWheelTimer *const _t);
+
+/**
+ * @brief   Initialise an empty timing wheel.
+ *
+ * @param   _w Timing wheel to initialise.
+ * @param   _now Current tick.
+ */
+void
+timingWheelInit(TimingWheel *const _w, uint64_t const _now);
+
+/**
+ * @brief   Start a timer, or restart it if it was started already.
+ *
+ * @param   _w Timing wheel.
+ * @param   _t Timer to start.
+ * @param   _expiry Tick at which the timer expires. A timer of which the expiry
+ * has passed expires at the next advance.
+ */
+void
+timingWheelInsert(TimingWheel *const _w, TimingWheelTimer *const _t,
+        uint64_t const _expiry);
+
+/**
+ * @brief   Stop a timer.
+ *
+ * @param   _w Timing wheel.
+ * @param   _t Timer to stop. Stopping a timer that is not started, or that is
+ * in a list of expired timers, takes it out of that list only.
+ */
+void
+timingWheelCancel(TimingWheel *const _w, TimingWheelTimer *const _t);
+
+/**
+ * @brief   Find the next tick at which the wheel has work.
+ *
+ * @param   _w Timing wheel.
+ * @return  uint64_t Earliest tick at which a timer may expire, or UINT64_MAX
+ * if the wheel is empty. No timer expires before it, so it can be used to
+ * sleep until then.
+ */
+uint64_t
+timingWheelNextTick(TimingWheel const *const _w);
+
+/**
+ * @brief   Advance the current tick and collect the timers that expire.
+ *
+ * Only the ticks at which a slot holds timers are visited.
+ *
+ * @param   _w Timing wheel.
+ * @param   _now Tick to advance to, of which the timers expire as well.
+ * @param   _expired List to append the expired timers to, in order of
+ * expiry. Save the next timer before restarting a timer while walking it.
+ * @return  size_t Number of expired timers.
+ *
+ * @pre     _now is less than UINT64_MAX.
+ */
+size_t
+timingWheelAdvance(TimingWheel *const _w, uint64_t const _now,
+        TimingWheelTimer *const _expired);
+
+/********** Slab allocator ****************************************************/
+/**
+ * @brief   Get the number of words the bitmaps of a slab allocator need.
+ *
+ * @param   _nSlabs Number of slabs.
+ * @param   _slabObjects Number of objects in a slab.
+ * @return  size_t Number of words.
+ */
+size_t
+slabAllocatorNWords(size_t const _nSlabs, size_t const _slabObjects);
+
+/**
+ * @brief   Initialise a slab allocator with all objects free.
+ *
+ * @param   _a Slab allocator to initialise.
+ * @param   _objects Memory of _nSlabs * _slabObjects objects.
+ * @param   _objectSize Size of an object in bytes.
+ * @param   _words Memory of @ref slabAllocatorNWords words for the bitmaps.
+ * @param   _nSlabs Number of slabs, at least 1.
+ * @param   _slabObjects Number of objects in a slab.
+ *
+ * @pre     _slabObjects is a multiple of 64.
+ */
+void
+slabAllocatorInit(SlabAllocator *const _a, void *const _objects,
+        size_t const _objectSize, uint64_t *const _words,
+        size_t const _nSlabs, size_t const _slabObjects);
+
+/**
+ * @brief   Allocate an object.
+ *
+ * When the active slab is full, the objects freed by other threads are
+ * collected and the fullest slab with a free object becomes active, so that
+ * the emptier slabs drain and can be reclaimed.
+ *
+ * @param   _a Slab allocator, of the calling thread.
+ * @return  void* Allocated object, or NULL if all slabs are full.
+ */
+void *
+slabAllocatorAlloc(SlabAllocator *const _a);
+
+/**
+ * @brief   Free an object from the thread owning the allocator.
+ *
+ * @param   _a Slab allocator, of the calling thread.
+ * @param   _object Object allocated from _a.
+ */
+void
+slabAllocatorFree(SlabAllocator *const _a, void *const _object);
+
+/**
+ * @brief   Get the number of allocated objects of a slab.
+ *
+ * @param   _a Slab allocator, of the calling thread.
+ * @param   _slab Slab to count the objects of.
+ * @return  size_t Number of allocated objects, after collecting the objects
+ * freed by other threads.
+ */
+size_t
+slabAllocatorOccupancy(SlabAllocator *const _a, size_t const _slab);
+
+/**
+ * @brief   Find the slab that is best to reclaim.
+ *
+ * @param   _a Slab allocator, of the calling thread.
+ * @return  size_t The least occupied slab other than the active slab, or the
+ * active slab if it is the only one. Its memory can be released when
+ * @ref slabAllocatorOccupancy is 0 for it.
+ */
+size_t
+slabAllocatorReclaimCandidate(SlabAllocator *const _a);
+
+#ifdef BITOPERATIONS_ATOMIC
+/**
+ * @brief   Free an object from any thread, without locking.
+ *
+ * @param   _a Slab allocator the object was allocated from.
+ * @param   _object Object allocated from _a.
+ */
+void
+atomicSlabAllocatorFree(SlabAllocator *const _a, void *const _object);
+#endif	/* BITOPERATIONS_ATOMIC */
+
+/********** Runs of zeros *****************************************************/
+/**
+ * @brief   Find the first run of zeros of a length from a hint, e.g. free
+ * blocks of a disk.
+ *
+ * @param   _bits Buffer of bits to search.
+ * @param   _nBits Number of bits in the buffer.
+ * @param   _length Number of zeros of the run, at least 1.
+ * @param   _hint Bit to start searching from, after which the search wraps
+ * around to the start of the buffer.
+ * @return  size_t First bit of the run, or _nBits if there is none.
+ */
+size_t
+findZeroRun(uint64_t const *const _bits, size_t const _nBits,
+        size_t const _length, size_t const _hint);
+
+/**
+ * @brief   Find the shortest run of zeros of at least a length.
+ *
+ * @param   _bits Buffer of bits to search.
+ * @param   _nBits Number of bits in the buffer.
+ * @param   _length Number of zeros of the run, at least 1.
+ * @return  size_t First bit of the first of the shortest runs, or _nBits if
+ * there is none.
+ */
+size_t
+findZeroRunBestFit(uint64_t const *const _bits, size_t const _nBits,
+        size_t const _length);
+
+/**
+ * @brief   Get the number of chunks of a zero run index.
+ *
+ * @param   _nBits Number of bits in the buffer.
+ * @return  size_t Number of chunks.
+ */
+size_t
+zeroRunIndexNChunks(size_t const _nBits);
+
+/**
+ * @brief   Initialise a zero run index of a buffer of bits.
+ *
+ * @param   _x Zero run index to initialise.
+ * @param   _bits Buffer of bits to index.
+ * @param   _nBits Number of bits in the buffer.
+ * @param   _summary Memory of 3 * @ref zeroRunIndexNChunks counts.
+ */
+void
+zeroRunIndexInit(ZeroRunIndex *const _x, uint64_t *const _bits,
+        size_t const _nBits, uint16_t *const _summary);
+
+/**
+ * @brief   Set or clear a range of bits of an indexed buffer.
+ *
+ * @param   _x Zero run index.
+ * @param   _offset Number of the first bit to set or clear.
+ * @param   _nBits Number of bits to set or clear.
+ * @param   _f Flag whether the bits need to be set or cleared (1 or 0).
+ */
+void
+zeroRunIndexFill(ZeroRunIndex *const _x, size_t const _offset,
+        size_t const _nBits, bool const _f);
+
+/**
+ * @brief   Find the first run of zeros of a length from a hint.
+ *
+ * @param   _x Zero run index.
+ * @param   _length Number of zeros of the run, at least 1.
+ * @param   _hint Bit to start searching from, after which the search wraps
+ * around to the start of the buffer.
+ * @return  size_t First bit of the run, or the number of bits if there is
+ * none.
+ */
+size_t
+zeroRunIndexFirstFit(ZeroRunIndex const *const _x, size_t const _length,
+        size_t const _hint);
+
+/**
+ * @brief   Find the shortest run of zeros of at least a length.
+ *
+ * @param   _x Zero run index.
+ * @param   _length Number of zeros of the run, at least 1.
+ * @return  size_t First bit of the first of the shortest runs, or the number
+ * of bits if there is none.
+ */
+size_t
+zeroRunIndexBestFit(ZeroRunIndex const *const _x, size_t const _length);
+
+/********** Work stealing *****************************************************/
+/**
+ * @brief   Initialise an empty work-stealing deque.
+ *
+ * @param   _d Deque to initialise.
+ * @param   _tasks Memory of _capacity tasks.
+ * @param   _capacity Maximum number of tasks, a power of 2.
+ */
+void
+workDequeInit(WorkDeque *const _d, uint64_t *const _tasks,
+        size_t const _capacity);
+
+#ifdef BITOPERATIONS_ATOMIC
+/**
+ * @brief   Push a task, by the owner of the deque.
+ *
+ * @param   _d Deque of the calling worker.
+ * @param   _task Task to push.
+ * @return  bool True if the task was pushed, false if the deque is full.
+ */
+bool
+atomicWorkDequePush(WorkDeque *const _d, uint64_t const _task);
+
+/**
+ * @brief   Pop the newest task, by the owner of the deque.
+ *
+ * @param   _d Deque of the calling worker.
+ * @param   _task Popped task.
+ * @return  bool True if a task was popped, false if the deque is empty.
+ */
+bool
+atomicWorkDequePop(WorkDeque *const _d, uint64_t *const _task);
+
+/**
+ * @brief   Steal the oldest task, by any other worker.
+ *
+ * @param   _d Deque of the victim.
+ * @param   _task Stolen task.
+ * @return  bool True if a task was stolen, false if the deque is empty or
+ * another worker took the task first.
+ */
+bool
+atomicWorkDequeSteal(WorkDeque *const _d, uint64_t *const _task);
+
+/**
+ * @brief   Pick the worker to steal from.
+ *
+ * A worker sets its bit with @ref atomicBitSet when it pushes to its empty
+ * deque, and clears it with @ref atomicBitClear when a pop finds it empty.
+ * The bits are searched from the worker after the thief, so that thieves
+ * spread over the victims, with one trailing zero count per word of 64
+ * workers.
+ *
+ * @param   _nonEmpty Bitmap of the workers of which the deque is not empty,
+ * with the bits beyond _nWorkers cleared.
+ * @param   _nWorkers Number of workers.
+ * @param   _thief Worker looking for work, which is never picked.
+ * @return  size_t Worker to steal from, or _nWorkers if all other deques are
+ * empty.
+ */
+size_t
+atomicStealVictim(uint64_t const *const _nonEmpty, size_t const _nWorkers,
+        size_t const _thief);
+
+/**
+ * @brief   Run tasks, by a worker, until the deques of all workers are empty.
+ *
+ * The worker runs its own tasks, newest first, then clears its bit of
+ * _nonEmpty and steals the oldest task of the victim of
+ * @ref atomicStealVictim, and runs its own tasks again. A thief that finds
+ * the deque of a victim empty clears the bit of the victim, so that a worker
+ * that has not started yet does not keep the others spinning. A task may push
+ * tasks to the deque of its worker and set the bit of the worker; those are
+ * run by the worker itself if the others have returned already.
+ *
+ * @param   _deques Deques of the workers.
+ * @param   _nonEmpty Bitmap of the workers of which the deque is not empty.
+ * @param   _nWorkers Number of workers.
+ * @param   _self Number of the calling worker.
+ * @param   _run Function to run the tasks with.
+ * @param   _context First argument of _run.
+ * @return  size_t Number of tasks run by the worker.
+ */
+size_t
+atomicWorkerRun(WorkDeque *const _deques, uint64_t *const _nonEmpty,
+        size_t const _nWorkers, size_t const _self, WorkFunction const _run,
+        void *const _context);
+#endif	/* BITOPERATIONS_ATOMIC */
+
+/********** Large buffers *****************************************************/
+/**
+ * @brief   Split a buffer of words in chunks for threads to process.
+ *
+ * The chunks are contiguous and a multiple of 8 words, one cache line, long,
+ * so that threads do not share cache lines of a buffer aligned to 64 bytes.
+ * No more threads are used than there are chunks of _minWords, so that small
+ * buffers stay single-threaded. The partial results of the chunks are
+ * combined by adding the counts and XORing the parities, as the parallel
+ * functions such as @ref parallelCountBits do.
+ *
+ * @param   _first First word of the chunk of the thread.
+ * @param   _nWords Number of words in the buffer.
+ * @param   _minWords Minimum number of words of a chunk, e.g.
+ * BUFFER_PARTITION_MIN_WORDS.
+ * @param   _nThreads Number of threads, at least 1.
+ * @param   _thread Number of the calling thread, less than _nThreads.
+ * @return  size_t Number of words of the chunk, 0 if the thread is not
+ * needed.
+ */
+size_t
+bufferPartition(size_t *const _first, size_t const _nWords,
+        size_t const _minWords, size_t const _nThreads, size_t const _thread);
+
+/**
+ * @brief   Count the set bits of a buffer of words.
+ *
+ * @param   _src Buffer to count the bits of.
+ * @param   _nWords Number of words in the buffer.
+ * @return  uint64_t Number of set bits.
+ */
+uint64_t
+countBits(uint64_t const *const _src, size_t const _nWords);
+
+/**
+ * @brief   Get the parity of a buffer of words.
+ *
+ * @param   _src Buffer to get the parity of.
+ * @param   _nWords Number of words in the buffer.
+ * @return  bool True if the number of set bits is odd.
+ */
+bool
+parityBits(uint64_t const *const _src, size_t const _nWords);
+
+/**
+ * @brief   AND two buffers of words.
+ *
+ * @param   _dst Buffer to store the result in, which may be _a or _b.
+ * @param   _a First buffer.
+ * @param   _b Second buffer.
+ * @param   _nWords Number of words in the buffers.
+ */
+void
+andBits(uint64_t *const _dst, uint64_t const *const _a,
+        uint64_t const *const _b, size_t const _nWords);
+
+/**
+ * @brief   OR two buffers of words.
+ *
+ * @param   _dst Buffer to store the result in, which may be _a or _b.
+ * @param   _a First buffer.
+ * @param   _b Second buffer.
+ * @param   _nWords Number of words in the buffers.
+ */
+void
+orBits(uint64_t *const _dst, uint64_t const *const _a,
+        uint64_t const *const _b, size_t const _nWords);
+
+/**
+ * @brief   XOR two buffers of words.
+ *
+ * @param   _dst Buffer to store the result in, which may be _a or _b.
+ * @param   _a First buffer.
+ * @param   _b Second buffer.
+ * @param   _nWords Number of words in the buffers.
+ */
+void
+xorBits(uint64_t *const _dst, uint64_t const *const _a,
+        uint64_t const *const _b, size_t const _nWords);
+
+/**
+ * @brief   OR any number of buffers of words, and count the set bits.
+ *
+ * The buffers are aggregated a block of 4 KiB of the result at a time, so
+ * that the result is written once and stays in the cache while all buffers
+ * are read. Threads aggregate the chunks of @ref bufferPartition and add the
+ * counts.
+ *
+ * @param   _dst Buffer to store the result in, which may be _srcs[0] but no
+ * other buffer, or NULL to only count the bits.
+ * @param   _srcs Buffers to OR.
+ * @param   _nSrcs Number of buffers, at least 1.
+ * @param   _first First word to aggregate.
+ * @param   _nWords Number of words to aggregate.
+ * @return  uint64_t Number of set bits of the result.
+ */
+uint64_t
+orBitsN(uint64_t *const _dst, uint64_t const *const *const _srcs,
+        size_t const _nSrcs, size_t const _first, size_t const _nWords);
+
+/**
+ * @brief   AND any number of buffers of words, and count the set bits.
+ *
+ * As @ref orBitsN, and the buffers that follow are not read for a block of
+ * which the result has become zero.
+ *
+ * @param   _dst Buffer to store the result in, which may be _srcs[0] but no
+ * other buffer, or NULL to only count the bits.
+ * @param   _srcs Buffers to AND.
+ * @param   _nSrcs Number of buffers, at least 1.
+ * @param   _first First word to aggregate.
+ * @param   _nWords Number of words to aggregate.
+ * @return  uint64_t Number of set bits of the result.
+ */
+uint64_t
+andBitsN(uint64_t *const _dst, uint64_t const *const *const _srcs,
+        size_t const _nSrcs, size_t const _first, size_t const _nWords);
+
+/**
+ * @brief   Reverse the order of the bits of a buffer of words.
+ *
+ * A chunk of _n words from word i of a buffer of N words is reversed into
+ * word N - i - _n of the result, so that threads reverse their chunks
+ * independently.
+ *
+ * @param   _dst Buffer to store the reversed bits in, not overlapping _src.
+ * @param   _src Buffer to reverse.
+ * @param   _nWords Number of words in the buffers.
+ */
+void
+reverseBits(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _nWords);
+
+#ifdef BITOPERATIONS_THREADS
+/**
+ * @brief   Initialise the threads of the parallel large-buffer functions.
+ *
+ * The minimum number of words of a chunk is set to
+ * BUFFER_PARTITION_MIN_WORDS, and may be changed afterwards.
+ *
+ * @param   _t Threads to initialise.
+ * @param   _nThreads Number of threads, including the calling thread, 1 to
+ * BUFFER_THREADS_MAX.
+ * @param   _pin True to pin the threads to CPUs, see @ref parallelClearBits.
+ */
+void
+bufferThreadsInit(BufferThreads *const _t, size_t const _nThreads,
+        bool const _pin);
+
+/**
+ * @brief   Clear a buffer of words with threads, to place its pages.
+ *
+ * Every thread clears the chunk of @ref bufferPartition that it processes in
+ * the other parallel functions, and does not steal, so that the first touch
+ * places the pages of a chunk on the NUMA node of its thread. Thread i,
+ * from 1, is pinned to the i-th CPU that the calling thread may run on when
+ * _t->pin is set, so that it runs on the same node in every call; chunk 0 is
+ * processed by the calling thread itself. Tasks that are stolen in the other
+ * functions, to balance the load, are processed on another node.
+ *
+ * @param   _t Threads to use.
+ * @param   _dst Buffer to clear.
+ * @param   _nWords Number of words in the buffer.
+ */
+void
+parallelClearBits(BufferThreads const *const _t, uint64_t *const _dst,
+        size_t const _nWords);
+
+/**
+ * @brief   Count the set bits of a buffer of words with threads.
+ *
+ * The chunks of @ref bufferPartition are split into tasks on the
+ * work-stealing deques of the threads, which run them with
+ * @ref atomicWorkerRun, and the counts of the threads are added. A buffer of
+ * less than two chunks of _t->minWords is counted by the calling thread only.
+ *
+ * @param   _t Threads to use.
+ * @param   _src Buffer to count the bits of.
+ * @param   _nWords Number of words in the buffer.
+ * @return  uint64_t Number of set bits.
+ */
+uint64_t
+parallelCountBits(BufferThreads const *const _t, uint64_t const *const _src,
+        size_t const _nWords);
+
+/**
+ * @brief   Get the parity of a buffer of words with threads.
+ *
+ * As @ref parallelCountBits, with the parities of the threads XORed.
+ *
+ * @param   _t Threads to use.
+ * @param   _src Buffer to get the parity of.
+ * @param   _nWords Number of words in the buffer.
+ * @return  bool True if the number of set bits is odd.
+ */
+bool
+parallelParityBits(BufferThreads const *const _t, uint64_t const *const _src,
+        size_t const _nWords);
+
+/**
+ * @brief   AND two buffers of words with threads.
+ *
+ * As @ref parallelCountBits, with @ref andBits.
+ *
+ * @param   _t Threads to use.
+ * @param   _dst Buffer to store the result in, which may be _a or _b.
+ * @param   _a First buffer.
+ * @param   _b Second buffer.
+ * @param   _nWords Number of words in the buffers.
+ */
+void
+parallelAndBits(BufferThreads const *const _t, uint64_t *const _dst,
+        uint64_t const *const _a, uint64_t const *const _b,
+        size_t const _nWords);
+
+/**
+ * @brief   OR two buffers of words with threads.
+ *
+ * As @ref parallelCountBits, with @ref orBits.
+ *
+ * @param   _t Threads to use.
+ * @param   _dst Buffer to store the result in, which may be _a or _b.
+ * @param   _a First buffer.
+ * @param   _b Second buffer.
+ * @param   _nWords Number of words in the buffers.
+ */
+void
+parallelOrBits(BufferThreads const *const _t, uint64_t *const _dst,
+        uint64_t const *const _a, uint64_t const *const _b,
+        size_t const _nWords);
+
+/**
+ * @brief   XOR two buffers of words with threads.
+ *
+ * As @ref parallelCountBits, with @ref xorBits.
+ *
+ * @param   _t Threads to use.
+ * @param   _dst Buffer to store the result in, which may be _a or _b.
+ * @param   _a First buffer.
+ * @param   _b Second buffer.
+ * @param   _nWords Number of words in the buffers.
+ */
+void
+parallelXorBits(BufferThreads const *const _t, uint64_t *const _dst,
+        uint64_t const *const _a, uint64_t const *const _b,
+        size_t const _nWords);
+
+/**
+ * @brief   Reverse the order of the bits of a buffer of words with threads.
+ *
+ * As @ref parallelCountBits, with @ref reverseBits.
+ *
+ * @param   _t Threads to use.
+ * @param   _dst Buffer to store the reversed bits in, not overlapping _src.
+ * @param   _src Buffer to reverse.
+ * @param   _nWords Number of words in the buffers.
+ */
+void
+parallelReverseBits(BufferThreads const *const _t, uint64_t *const _dst,
+        uint64_t const *const _src, size_t const _nWords);
+#endif	/* BITOPERATIONS_THREADS */
+
+/********** Sorted sets *******************************************************/
+/**
+ * @brief   Intersect two sorted sets of integers.
+ *
+ * Sets of a similar size are merged four values of each set at a time, of
+ * which all pairs are compared with three rotations. The values of a set that
+ * is much smaller are searched in the other set with exponential steps
+ * instead.
+ *
+ * @param   _dst Buffer for at least the size of the smaller set of values to
+ * store the intersection in, or NULL to only count the values.
+ * @param   _a First set, in strictly increasing order.
+ * @param   _nA Number of values of the first set.
+ * @param   _b Second set, in strictly increasing order.
+ * @param   _nB Number of values of the second set.
+ * @return  size_t Number of values of the intersection.
+ */
+size_t
+intersectSorted(uint32_t *const _dst, uint32_t const *const _a,
+        size_t const _nA, uint32_t const *const _b, size_t const _nB);
+
+/**
+ * @brief   Unite two sorted sets of integers.
+ *
+ * @param   _dst Buffer for _nA + _nB values to store the union in, or NULL to
+ * only count the values.
+ * @param   _a First set, in strictly increasing order.
+ * @param   _nA Number of values of the first set.
+ * @param   _b Second set, in strictly increasing order.
+ * @param   _nB Number of values of the second set.
+ * @return  size_t Number of values of the union.
+ */
+size_t
+uniteSorted(uint32_t *const _dst, uint32_t const *const _a,
+        size_t const _nA, uint32_t const *const _b, size_t const _nB);
+
+/**
+ * @brief   Subtract a sorted set of integers from another.
+ *
+ * @param   _dst Buffer for _nA values to store the values of _a that are not
+ * in _b in, or NULL to only count the values.
+ * @param   _a Set to subtract from, in strictly increasing order.
+ * @param   _nA Number of values of the first set.
+ * @param   _b Set to subtract, in strictly increasing order.
+ * @param   _nB Number of values of the second set.
+ * @return  size_t Number of values of the difference.
+ */
+size_t
+subtractSorted(uint32_t *const _dst, uint32_t const *const _a,
+        size_t const _nA, uint32_t const *const _b, size_t const _nB);
+
+/**
+ * @brief   Set the bits of a buffer of bits of a sorted set of integers.
+ *
+ * @param   _bits Buffer of bits to set the bits in.
+ * @param   _values Values of the bits to set, each less than the number of
+ * bits in the buffer.
+ * @param   _n Number of values.
+ */
+void
+sortedToBits(uint64_t *const _bits, uint32_t const *const _values,
+        size_t const _n);
+
+/**
+ * @brief   Get the sorted set of the set bits of a buffer of bits.
+ *
+ * @param   _values Buffer for as many values as there are set bits.
+ * @param   _bits Buffer of bits.
+ * @param   _nWords Number of words in the buffer, at most 2^26.
+ * @return  size_t Number of values.
+ */
+size_t
+bitsToSorted(uint32_t *const _values, uint64_t const *const _bits,
+        size_t const _nWords);
+
+/********** Bit-sliced index **************************************************/
+/**
+ * @brief   Get the number of words of the slices of a bit-sliced index.
+ *
+ * @param   _nRows Number of rows.
+ * @param   _nSlices Number of bits of the values.
+ * @return  size_t Number of words.
+ */
+size_t
+bitSlicedIndexNWords(size_t const _nRows, uint8_t const _nSlices);
+
+/**
+ * @brief   Initialise a bit-sliced index with all values 0.
+ *
+ * @param   _x Bit-sliced index to initialise.
+ * @param   _slices Memory of @ref bitSlicedIndexNWords words.
+ * @param   _nRows Number of rows.
+ * @param   _nSlices Number of bits of the values, 1 to 32.
+ */
+void
+bitSlicedIndexInit(BitSlicedIndex *const _x, uint64_t *const _slices,
+        size_t const _nRows, uint8_t const _nSlices);
+
+/**
+ * @brief   Load the values of a column into a bit-sliced index.
+ *
+ * The values are transposed 64 rows at a time with
+ * @ref transposeBits64x64.
+ *
+ * @param   _x Bit-sliced index, of at least _n rows.
+ * @param   _values Values of rows 0 to _n - 1, less than 2^nSlices.
+ * @param   _n Number of values.
+ */
+void
+bitSlicedIndexLoad(BitSlicedIndex *const _x, uint32_t const *const _values,
+        size_t const _n);
+
+/**
+ * @brief   Set the value of a row of a bit-sliced index.
+ *
+ * @param   _x Bit-sliced index.
+ * @param   _row Row to set the value of.
+ * @param   _value Value, less than 2^nSlices.
+ */
+void
+bitSlicedIndexSet(BitSlicedIndex *const _x, size_t const _row,
+        uint32_t const _value);
+
+/**
+ * @brief   Get the value of a row of a bit-sliced index.
+ *
+ * @param   _x Bit-sliced index.
+ * @param   _row Row to get the value of.
+ * @return  uint32_t Value of the row.
+ */
+uint32_t
+bitSlicedIndexGet(BitSlicedIndex const *const _x, size_t const _row);
+
+/**
+ * @brief   Select the rows of which the value is between two bounds.
+ *
+ * Both comparisons are made in one pass over the slices, from the highest
+ * bit down, a block of rows at a time.
+ *
+ * @param   _x Bit-sliced index.
+ * @param   _dst Bitmap of nWords words to store the selected rows in.
+ * @param   _lo Lowest value to select.
+ * @param   _hi Highest value to select.
+ * @return  size_t Number of selected rows.
+ */
+size_t
+bitSlicedIndexBetween(BitSlicedIndex const *const _x, uint64_t *const _dst,
+        uint32_t const _lo, uint32_t const _hi);
+
+/**
+ * @brief   Select the rows of which the value is less than a constant.
+ *
+ * @param   _x Bit-sliced index.
+ * @param   _dst Bitmap of nWords words to store the selected rows in.
+ * @param   _c Constant to compare with.
+ * @return  size_t Number of selected rows.
+ */
+size_t
+bitSlicedIndexLess(BitSlicedIndex const *const _x, uint64_t *const _dst,
+        uint32_t const _c);
+
+/**
+ * @brief   Select the rows of which the value is at most a constant.
+ *
+ * @param   _x Bit-sliced index.
+ * @param   _dst Bitmap of nWords words to store the selected rows in.
+ * @param   _c Constant to compare with.
+ * @return  size_t Number of selected rows.
+ */
+size_t
+bitSlicedIndexLessEqual(BitSlicedIndex const *const _x, uint64_t *const _dst,
+        uint32_t const _c);
+
+/**
+ * @brief   Select the rows of which the value equals a constant.
+ *
+ * @param   _x Bit-sliced index.
+ * @param   _dst Bitmap of nWords words to store the selected rows in.
+ * @param   _c Constant to compare with.
+ * @return  size_t Number of selected rows.
+ */
+size_t
+bitSlicedIndexEqual(BitSlicedIndex const *const _x, uint64_t *const _dst,
+        uint32_t const _c);
+
+/**
+ * @brief   Sum the values of a selection of rows.
+ *
+ * @param   _x Bit-sliced index.
+ * @param   _filter Bitmap of nWords words of the rows to sum, or NULL to sum
+ * all rows.
+ * @return  uint64_t Sum of the values, of the set bits of every slice times
+ * its weight.
+ */
+uint64_t
+bitSlicedIndexSum(BitSlicedIndex const *const _x,
+        uint64_t const *const _filter);
+
+/**
+ * @brief   Select the rows with the largest values.
+ *
+ * @param   _x Bit-sliced index.
+ * @param   _dst Bitmap of nWords words to store the selected rows in.
+ * @param   _scratch Memory of nWords words.
+ * @param   _k Number of rows to select.
+ * @return  size_t Number of selected rows, the lesser of _k and nRows. Of
+ * the rows with the smallest selected value, the first ones are selected.
+ */
+size_t
+bitSlicedIndexTopK(BitSlicedIndex const *const _x, uint64_t *const _dst,
+        uint64_t *const _scratch, size_t const _k);
+
+/********** Predicates ********************************************************/
+/**
+ * @brief   Select the rows of a column of 8-bit integers that compare with a
+ * constant.
+ *
+ * The comparisons of 64 rows give a word of the selection bitmap at a time,
+ * from the masks of the AVX-512 compare instructions when available.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words. The bits
+ * beyond _n are kept.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL if all are
+ * valid. Null rows are never selected.
+ * @param   _n Number of rows.
+ * @param   _op Comparison.
+ * @param   _c Constant to compare with.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectCompareInt8(uint64_t *const _dst, int8_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, CompareOp const _op,
+        int8_t const _c, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of 8-bit integers between two bounds.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL.
+ * @param   _n Number of rows.
+ * @param   _lo Lowest value to select.
+ * @param   _hi Highest value to select.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectBetweenInt8(uint64_t *const _dst, int8_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, int8_t const _lo,
+        int8_t const _hi, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of 8-bit integers in a small set.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL.
+ * @param   _n Number of rows.
+ * @param   _set Values to select.
+ * @param   _nSet Number of values to select.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectInInt8(uint64_t *const _dst, int8_t const *const _col,
+        uint64_t const *const _valid, size_t const _n,
+        int8_t const *const _set, size_t const _nSet, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of 16-bit integers that compare with a
+ * constant.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words. The bits
+ * beyond _n are kept.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL if all are
+ * valid. Null rows are never selected.
+ * @param   _n Number of rows.
+ * @param   _op Comparison.
+ * @param   _c Constant to compare with.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectCompareInt16(uint64_t *const _dst, int16_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, CompareOp const _op,
+        int16_t const _c, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of 16-bit integers between two bounds.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL.
+ * @param   _n Number of rows.
+ * @param   _lo Lowest value to select.
+ * @param   _hi Highest value to select.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectBetweenInt16(uint64_t *const _dst, int16_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, int16_t const _lo,
+        int16_t const _hi, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of 16-bit integers in a small set.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL.
+ * @param   _n Number of rows.
+ * @param   _set Values to select.
+ * @param   _nSet Number of values to select.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectInInt16(uint64_t *const _dst, int16_t const *const _col,
+        uint64_t const *const _valid, size_t const _n,
+        int16_t const *const _set, size_t const _nSet, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of 32-bit integers that compare with a
+ * constant.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words. The bits
+ * beyond _n are kept.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL if all are
+ * valid. Null rows are never selected.
+ * @param   _n Number of rows.
+ * @param   _op Comparison.
+ * @param   _c Constant to compare with.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectCompareInt32(uint64_t *const _dst, int32_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, CompareOp const _op,
+        int32_t const _c, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of 32-bit integers between two bounds.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL.
+ * @param   _n Number of rows.
+ * @param   _lo Lowest value to select.
+ * @param   _hi Highest value to select.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectBetweenInt32(uint64_t *const _dst, int32_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, int32_t const _lo,
+        int32_t const _hi, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of 32-bit integers in a small set.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL.
+ * @param   _n Number of rows.
+ * @param   _set Values to select.
+ * @param   _nSet Number of values to select.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectInInt32(uint64_t *const _dst, int32_t const *const _col,
+        uint64_t const *const _valid, size_t const _n,
+        int32_t const *const _set, size_t const _nSet, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of 64-bit integers that compare with a
+ * constant.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words. The bits
+ * beyond _n are kept.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL if all are
+ * valid. Null rows are never selected.
+ * @param   _n Number of rows.
+ * @param   _op Comparison.
+ * @param   _c Constant to compare with.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectCompareInt64(uint64_t *const _dst, int64_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, CompareOp const _op,
+        int64_t const _c, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of 64-bit integers between two bounds.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL.
+ * @param   _n Number of rows.
+ * @param   _lo Lowest value to select.
+ * @param   _hi Highest value to select.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectBetweenInt64(uint64_t *const _dst, int64_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, int64_t const _lo,
+        int64_t const _hi, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of 64-bit integers in a small set.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL.
+ * @param   _n Number of rows.
+ * @param   _set Values to select.
+ * @param   _nSet Number of values to select.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectInInt64(uint64_t *const _dst, int64_t const *const _col,
+        uint64_t const *const _valid, size_t const _n,
+        int64_t const *const _set, size_t const _nSet, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of floats that compare with a
+ * constant.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words. The bits
+ * beyond _n are kept.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL if all are
+ * valid. Null rows are never selected.
+ * @param   _n Number of rows.
+ * @param   _op Comparison.
+ * @param   _c Constant to compare with.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectCompareFloat(uint64_t *const _dst, float const *const _col,
+        uint64_t const *const _valid, size_t const _n, CompareOp const _op,
+        float const _c, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of floats between two bounds.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL.
+ * @param   _n Number of rows.
+ * @param   _lo Lowest value to select.
+ * @param   _hi Highest value to select.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectBetweenFloat(uint64_t *const _dst, float const *const _col,
+        uint64_t const *const _valid, size_t const _n, float const _lo,
+        float const _hi, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of floats in a small set.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL.
+ * @param   _n Number of rows.
+ * @param   _set Values to select.
+ * @param   _nSet Number of values to select.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectInFloat(uint64_t *const _dst, float const *const _col,
+        uint64_t const *const _valid, size_t const _n,
+        float const *const _set, size_t const _nSet, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of doubles that compare with a
+ * constant.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words. The bits
+ * beyond _n are kept.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL if all are
+ * valid. Null rows are never selected.
+ * @param   _n Number of rows.
+ * @param   _op Comparison.
+ * @param   _c Constant to compare with.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectCompareDouble(uint64_t *const _dst, double const *const _col,
+        uint64_t const *const _valid, size_t const _n, CompareOp const _op,
+        double const _c, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of doubles between two bounds.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL.
+ * @param   _n Number of rows.
+ * @param   _lo Lowest value to select.
+ * @param   _hi Highest value to select.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectBetweenDouble(uint64_t *const _dst, double const *const _col,
+        uint64_t const *const _valid, size_t const _n, double const _lo,
+        double const _hi, SelectMode const _mode);
+
+/**
+ * @brief   Select the rows of a column of doubles in a small set.
+ *
+ * @param   _dst Selection bitmap of BITBUF_NWORDS(_n) words.
+ * @param   _col Column of values.
+ * @param   _valid Bitmap of the rows that are not null, or NULL.
+ * @param   _n Number of rows.
+ * @param   _set Values to select.
+ * @param   _nSet Number of values to select.
+ * @param   _mode How to combine the selection with _dst.
+ * @return  size_t Number of rows set in _dst.
+ */
+size_t
+selectInDouble(uint64_t *const _dst, double const *const _col,
+        uint64_t const *const _valid, size_t const _n,
+        double const *const _set, size_t const _nSet, SelectMode const _mode);
+
+/********** Eytzinger search **************************************************/
+/**
+ * @brief   Lay out sorted keys in Eytzinger (breadth-first) order.
+ *
+ * Node k of the implicit search tree is at index k, and its children at 2k
+ * and 2k + 1, so that a search walks down the array without branches.
+ *
+ * @param   _dst Array of _n + 1 keys to store the layout in, from index 1,
+ * preferably aligned to 64 bytes.
+ * @param   _order Array of _n + 1 positions to store the index in _src of
+ * every node in, from index 1, or NULL.
+ * @param   _src Keys in increasing order.
+ * @param   _n Number of keys.
+ */
+void
+eytzingerBuild(uint32_t *const _dst, size_t *const _order,
+        uint32_t const *const _src, size_t const _n);
+
+/**
+ * @brief   Find the first key that is not less than a value.
+ *
+ * Every level is one comparison added to the index, and the cache line of
+ * the nodes four levels down is prefetched while the levels in between are
+ * compared. The node of the result is found from the final index by
+ * removing the trailing ones, the right turns after the last left turn, with
+ * a trailing zero count.
+ *
+ * @param   _keys Keys laid out with @ref eytzingerBuild.
+ * @param   _n Number of keys.
+ * @param   _x Value to search for.
+ * @return  size_t Index in _keys of the first key not less than _x, or 0 if
+ * all keys are less than _x.
+ */
+size_t
+eytzingerLowerBound(uint32_t const *const _keys, size_t const _n,
+        uint32_t const _x);
+
 #ifdef	__cplusplus
 }
 #endif
@@ -34,9 +34,12 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <math.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <time.h>
 #include "greatest.h"                   /* Unit test framework. */
 #include "BitOperations_UnitTest.h"
@@ -1420,6 +1423,58 @@ nBitsSet_magic32BitNumbers_Generated()
     PASS();
 }
 
+/**
+ * @testname    nBitsSet64_randomNumbers_Counted
+ * @testcase    @ref nBitsSet64 determines the correct amount of bits that are
+ * set in a 64-bit variable.
+ * @testvalues
+ * | Argument           |
+ * | ------------------ |
+ * | 0x0000000000000000 |
+ * | 0xFFFFFFFFFFFFFFFF |
+ * | 1000 x rand64()    |
+ */
+TEST
+nBitsSet64_randomNumbers_Counted()
+{
+    GREATEST_ASSERT_EQ(0, nBitsSet64(0x0000000000000000));
+    GREATEST_ASSERT_EQ(64, nBitsSet64(0xFFFFFFFFFFFFFFFF));
+    for (uint16_t i = 0; i < 1000; i++) {
+        uint64_t const v = rand64() ^ (rand64() << 1);
+
+        GREATEST_ASSERT_EQ(nBitsSet((uint32_t)v) + nBitsSet(v >> 32),
+                           nBitsSet64(v));
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    nTrailingZeros64_randomNumbers_Counted
+ * @testcase    @ref nTrailingZeros64 and @ref nLeadingZeros64 count the zero
+ * bits below the lowest and above the highest set bit of a 64-bit variable.
+ * @testvalues
+ * | Argument                             |
+ * | ------------------------------------ |
+ * | 0x0000000000000000                   |
+ * | (rand64() \| 1) << 0 - 63            |
+ * | (rand64() \| 1ULL << 63) >> 0 - 63   |
+ */
+TEST
+nTrailingZeros64_randomNumbers_Counted()
+{
+    GREATEST_ASSERT_EQ(64, nTrailingZeros64(0));
+    GREATEST_ASSERT_EQ(64, nLeadingZeros64(0));
+    for (uint8_t i = 0; i < 64; i++) {
+        uint64_t const v = rand64() ^ (rand64() << 1);
+
+        GREATEST_ASSERT_EQ(i, nTrailingZeros64((v | 1) << i));
+        GREATEST_ASSERT_EQ(i, nLeadingZeros64((v | (1ULL << 63)) >> i));
+    }
+
+    PASS();
+}
+
 /**
  * @testname    isOddParity_powersOfTwoUpTo64Bit_ParityGenerated
  * @testcase    @ref isOddParity determines the correct parity of a 64-bit
@@ -1834,6 +1889,2602 @@ roundUpToPowerOf2_zero_GeneratePower()
     PASS();
 }
 
+/**
+ * @testname    reverseBitOrderN_codesOfDifferentLengths_Reversed
+ * @testcase    @ref reverseBitOrderN correctly reverses the lowest bits of a
+ * 32-bit variable.
+ * @testvalues
+ * | Argument 1 | Argument 2 |
+ * | ---------- | ---------- |
+ * | 0x00000001 | 1          |
+ * | 0x00000006 | 3          |
+ * | 0x000000F0 | 8          |
+ * | 0x00001234 | 16         |
+ * | 0x12345678 | 32         |
+ * | 0xFFFFFFFF | 0          |
+ */
+TEST
+reverseBitOrderN_codesOfDifferentLengths_Reversed()
+{
+    GREATEST_ASSERT_EQ(0x00000001, reverseBitOrderN(0x00000001, 1));
+    GREATEST_ASSERT_EQ(0x00000003, reverseBitOrderN(0x00000006, 3));
+    GREATEST_ASSERT_EQ(0x0000000F, reverseBitOrderN(0x000000F0, 8));
+    GREATEST_ASSERT_EQ(0x00002C48, reverseBitOrderN(0x00001234, 16));
+    GREATEST_ASSERT_EQ(0x1E6A2C48, reverseBitOrderN(0x12345678, 32));
+    GREATEST_ASSERT_EQ(0x00000000, reverseBitOrderN(0xFFFFFFFF, 0));
+
+    PASS();
+}
+
+/**
+ * @testname    bitWriter_msbFirstFields_Packed
+ * @testcase    @ref bitWriterPut packs bit fields with the first bit in the
+ * most significant bit of a byte.
+ * @testvalues
+ * | Argument 1 | Argument 2 |
+ * | ---------- | ---------- |
+ * | 0x1        | 1          |
+ * | 0x1        | 2          |
+ * | 0x1F       | 5          |
+ * | 0xA5       | 8          |
+ * | 0x3        | 2          |
+ */
+TEST
+bitWriter_msbFirstFields_Packed()
+{
+    uint8_t buf[4] = {0};
+    BitWriter w;
+
+    bitWriterInit(&w, buf, sizeof(buf), BIT_ORDER_MSB_FIRST);
+    GREATEST_ASSERT(bitWriterPut(&w, 0x1, 1));
+    GREATEST_ASSERT(bitWriterPut(&w, 0x1, 2));
+    GREATEST_ASSERT(bitWriterPut(&w, 0x1F, 5));
+    GREATEST_ASSERT(bitWriterPut(&w, 0xA5, 8));
+    GREATEST_ASSERT(bitWriterPut(&w, 0x3, 2));
+    GREATEST_ASSERT_EQ(18, bitWriterBitsWritten(&w));
+    GREATEST_ASSERT_EQ(3, bitWriterFlush(&w));
+    GREATEST_ASSERT_EQ(0xBF, buf[0]);
+    GREATEST_ASSERT_EQ(0xA5, buf[1]);
+    GREATEST_ASSERT_EQ(0xC0, buf[2]);
+
+    PASS();
+}
+
+/**
+ * @testname    bitWriter_lsbFirstFields_Packed
+ * @testcase    @ref bitWriterPut packs bit fields with the first bit in the
+ * least significant bit of a byte.
+ * @testvalues
+ * | Argument 1 | Argument 2 |
+ * | ---------- | ---------- |
+ * | 0x1        | 1          |
+ * | 0x1        | 2          |
+ * | 0x1F       | 5          |
+ * | 0xA5       | 8          |
+ * | 0x3        | 2          |
+ */
+TEST
+bitWriter_lsbFirstFields_Packed()
+{
+    uint8_t buf[4] = {0};
+    BitWriter w;
+
+    bitWriterInit(&w, buf, sizeof(buf), BIT_ORDER_LSB_FIRST);
+    GREATEST_ASSERT(bitWriterPut(&w, 0x1, 1));
+    GREATEST_ASSERT(bitWriterPut(&w, 0x1, 2));
+    GREATEST_ASSERT(bitWriterPut(&w, 0x1F, 5));
+    GREATEST_ASSERT(bitWriterPut(&w, 0xA5, 8));
+    GREATEST_ASSERT(bitWriterPut(&w, 0x3, 2));
+    GREATEST_ASSERT_EQ(3, bitWriterFlush(&w));
+    GREATEST_ASSERT_EQ(0xFB, buf[0]);
+    GREATEST_ASSERT_EQ(0xA5, buf[1]);
+    GREATEST_ASSERT_EQ(0x03, buf[2]);
+
+    PASS();
+}
+
+/**
+ * @testname    bitWriter_fullBuffer_ShouldFail
+ * @testcase    @ref bitWriterPut refuses to write more bits than the buffer
+ * holds.
+ * @testvalues
+ * | Argument 1 | Argument 2 |
+ * | ---------- | ---------- |
+ * | 0xFFFF     | 15         |
+ * | 0x3        | 2          |
+ * | 0x1        | 1          |
+ */
+TEST
+bitWriter_fullBuffer_ShouldFail()
+{
+    uint8_t buf[2] = {0};
+    BitWriter w;
+
+    bitWriterInit(&w, buf, sizeof(buf), BIT_ORDER_MSB_FIRST);
+    GREATEST_ASSERT(bitWriterPut(&w, 0xFFFF, 15));
+    GREATEST_ASSERT_FALSE(bitWriterPut(&w, 0x3, 2));
+    GREATEST_ASSERT(bitWriterPut(&w, 0x1, 1));
+    GREATEST_ASSERT_EQ(2, bitWriterFlush(&w));
+    GREATEST_ASSERT_EQ(0xFF, buf[0]);
+    GREATEST_ASSERT_EQ(0xFF, buf[1]);
+
+    PASS();
+}
+
+/**
+ * @testname    bitReader_randomFieldsBothOrders_ReadBack
+ * @testcase    @ref bitReaderGet reads back random bit fields of 0 to 64 bits
+ * written by @ref bitWriterPut, in both bit orders.
+ * @testvalues
+ * | Argument 1 | Argument 2 |
+ * | ---------- | ---------- |
+ * | rand64()   | 0 - 64     |
+ */
+TEST
+bitReader_randomFieldsBothOrders_ReadBack()
+{
+    uint8_t buf[1024];
+    uint64_t values[200];
+    uint8_t lengths[200];
+    BitOrder const orders[] = {BIT_ORDER_MSB_FIRST, BIT_ORDER_LSB_FIRST};
+    BitWriter w;
+    BitReader r;
+    size_t nBits = 0;
+
+    for (uint8_t i = 0; i < 200; i++) {
+        lengths[i] = rand() % 65;
+        values[i] = (lengths[i] == 0) ? 0 : rand64() >> (64 - lengths[i]);
+        nBits += lengths[i];
+    }
+
+    for (uint8_t o = 0; o < 2; o++) {
+        bitWriterInit(&w, buf, sizeof(buf), orders[o]);
+        for (uint8_t i = 0; i < 200; i++) {
+            GREATEST_ASSERT(bitWriterPut(&w, values[i], lengths[i]));
+        }
+        GREATEST_ASSERT_EQ(nBits, bitWriterBitsWritten(&w));
+        GREATEST_ASSERT_EQ((nBits + 7) / 8, bitWriterFlush(&w));
+
+        bitReaderInit(&r, buf, (nBits + 7) / 8, orders[o]);
+        for (uint8_t i = 0; i < 200; i++) {
+            GREATEST_ASSERT_EQ(values[i], bitReaderGet(&r, lengths[i]));
+        }
+        GREATEST_ASSERT_EQ((int64_t)((8 - nBits % 8) % 8),
+                           bitReaderBitsLeft(&r));
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    bitReader_peekSkipAndOverrun_Generated
+ * @testcase    @ref bitReaderPeek does not consume bits, @ref bitReaderSkip
+ * does, and reading past the end yields zero bits.
+ * @testvalues
+ * | Argument 1     | Argument 2 |
+ * | -------------- | ---------- |
+ * | {0xA5, 0x0F}   | 4          |
+ * | {0xA5, 0x0F}   | 12         |
+ * | {0xA5, 0x0F}   | 8          |
+ */
+TEST
+bitReader_peekSkipAndOverrun_Generated()
+{
+    uint8_t const buf[] = {0xA5, 0x0F};
+    BitReader r;
+
+    bitReaderInit(&r, buf, sizeof(buf), BIT_ORDER_MSB_FIRST);
+    GREATEST_ASSERT_EQ(0xA, bitReaderPeek(&r, 4));
+    GREATEST_ASSERT_EQ(0xA5, bitReaderPeek(&r, 8));
+    GREATEST_ASSERT_EQ(0, bitReaderPeek(&r, 0));
+    bitReaderSkip(&r, 4);
+    GREATEST_ASSERT_EQ(12, bitReaderBitsLeft(&r));
+    GREATEST_ASSERT_EQ(0x50F, bitReaderGet(&r, 12));
+    GREATEST_ASSERT_EQ(0, bitReaderBitsLeft(&r));
+    GREATEST_ASSERT_EQ(0, bitReaderGet(&r, 8));
+    GREATEST_ASSERT_EQ(-8, bitReaderBitsLeft(&r));
+
+    bitReaderInit(&r, buf, sizeof(buf), BIT_ORDER_LSB_FIRST);
+    GREATEST_ASSERT_EQ(0x5, bitReaderPeek(&r, 4));
+    bitReaderSkip(&r, 4);
+    GREATEST_ASSERT_EQ(0x0FA, bitReaderGet(&r, 12));
+    GREATEST_ASSERT_EQ(0, bitReaderGet(&r, 8));
+
+    PASS();
+}
+
+/**
+ * @testname    copyBits_randomRanges_Copied
+ * @testcase    @ref copyBits copies random ranges of bits to random offsets
+ * and leaves the other destination bits unchanged.
+ * @testvalues
+ * | Argument 1 | Argument 2 | Argument 3 | Argument 4 | Argument 5 |
+ * | ---------- | ---------- | ---------- | ---------- | ---------- |
+ * | rand64()   | 0 - 511    | rand64()   | 0 - 511    | 0 - 512    |
+ */
+TEST
+copyBits_randomRanges_Copied()
+{
+    uint64_t src[16], dst[16], exp[16];
+
+    for (uint16_t t = 0; t < 1000; t++) {
+        size_t const nBits = rand() % 513;
+        size_t const srcOffset = rand() % (1024 - nBits + 1);
+        size_t const dstOffset = rand() % (1024 - nBits + 1);
+
+        for (uint8_t i = 0; i < 16; i++) {
+            src[i] = rand64();
+            dst[i] = exp[i] = rand64();
+        }
+        for (size_t i = 0; i < nBits; i++) {
+            BIT_CLEAR(exp[(dstOffset + i) / 64], (dstOffset + i) % 64);
+            if (bitGet(src[(srcOffset + i) / 64], (srcOffset + i) % 64)) {
+                BIT_SET(exp[(dstOffset + i) / 64], (dstOffset + i) % 64);
+            }
+        }
+
+        copyBits(dst, dstOffset, src, srcOffset, nBits);
+        for (uint8_t i = 0; i < 16; i++) {
+            GREATEST_ASSERT_EQ(exp[i], dst[i]);
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    moveBits_randomOverlappingRanges_Moved
+ * @testcase    @ref moveBits copies random, overlapping ranges of bits within
+ * one buffer in both directions.
+ * @testvalues
+ * | Argument 1 | Argument 2 | Argument 3 | Argument 4 | Argument 5 |
+ * | ---------- | ---------- | ---------- | ---------- | ---------- |
+ * | buf        | 0 - 1023   | buf        | 0 - 1023   | 0 - 1024   |
+ */
+TEST
+moveBits_randomOverlappingRanges_Moved()
+{
+    uint64_t buf[16], orig[16], exp[16];
+
+    for (uint16_t t = 0; t < 1000; t++) {
+        size_t const nBits = rand() % 1025;
+        size_t const srcOffset = rand() % (1024 - nBits + 1);
+        size_t const dstOffset = rand() % (1024 - nBits + 1);
+
+        for (uint8_t i = 0; i < 16; i++) {
+            buf[i] = orig[i] = exp[i] = rand64();
+        }
+        for (size_t i = 0; i < nBits; i++) {
+            BIT_CLEAR(exp[(dstOffset + i) / 64], (dstOffset + i) % 64);
+            if (bitGet(orig[(srcOffset + i) / 64], (srcOffset + i) % 64)) {
+                BIT_SET(exp[(dstOffset + i) / 64], (dstOffset + i) % 64);
+            }
+        }
+
+        moveBits(buf, dstOffset, buf, srcOffset, nBits);
+        for (uint8_t i = 0; i < 16; i++) {
+            GREATEST_ASSERT_EQ(exp[i], buf[i]);
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    fillBits_randomRanges_SetAndCleared
+ * @testcase    @ref fillBits sets or clears random ranges of bits and leaves
+ * the other bits unchanged.
+ * @testvalues
+ * | Argument 1 | Argument 2 | Argument 3 | Argument 4 |
+ * | ---------- | ---------- | ---------- | ---------- |
+ * | rand64()   | 0 - 511    | 0 - 512    | 0 or 1     |
+ */
+TEST
+fillBits_randomRanges_SetAndCleared()
+{
+    uint64_t buf[8], exp[8];
+
+    for (uint16_t t = 0; t < 1000; t++) {
+        size_t const nBits = rand() % 513;
+        size_t const offset = rand() % (512 - nBits + 1);
+        bool const f = rand() % 2;
+
+        for (uint8_t i = 0; i < 8; i++) {
+            buf[i] = exp[i] = rand64();
+        }
+        for (size_t i = offset; i < offset + nBits; i++) {
+            if (f) {
+                BIT_SET(exp[i / 64], i % 64);
+            } else {
+                BIT_CLEAR(exp[i / 64], i % 64);
+            }
+        }
+
+        fillBits(buf, offset, nBits, f);
+        for (uint8_t i = 0; i < 8; i++) {
+            GREATEST_ASSERT_EQ(exp[i], buf[i]);
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    shiftBits_randomBuffersInAndOutOfPlace_Shifted
+ * @testcase    @ref shiftBitsLeft and @ref shiftBitsRight shift random buffers
+ * of random lengths, both in place and to another buffer.
+ * @testvalues
+ * | Argument 1 | Argument 2 | Argument 3 | Argument 4 |
+ * | ---------- | ---------- | ---------- | ---------- |
+ * | rand64()   | rand64()   | 1 - 600    | 0 - 610    |
+ */
+TEST
+shiftBits_randomBuffersInAndOutOfPlace_Shifted()
+{
+    uint64_t src[10], dst[10], expL[10], expR[10];
+
+    for (uint16_t t = 0; t < 1000; t++) {
+        size_t const nBits = 1 + rand() % 600;
+        size_t const n = rand() % (nBits + 10);
+        bool const inPlace = rand() % 2;
+
+        for (uint8_t i = 0; i < 10; i++) {
+            src[i] = expL[i] = expR[i] = rand64();
+        }
+        for (size_t i = 0; i < nBits; i++) {
+            BIT_CLEAR(expL[i / 64], i % 64);
+            BIT_CLEAR(expR[i / 64], i % 64);
+            if (i >= n && bitGet(src[(i - n) / 64], (i - n) % 64)) {
+                BIT_SET(expL[i / 64], i % 64);
+            }
+            if (i + n < nBits && bitGet(src[(i + n) / 64], (i + n) % 64)) {
+                BIT_SET(expR[i / 64], i % 64);
+            }
+        }
+
+        for (uint8_t i = 0; i < 10; i++) {
+            dst[i] = src[i];
+        }
+        shiftBitsLeft(dst, inPlace ? dst : src, nBits, n);
+        for (uint8_t i = 0; i < 10; i++) {
+            GREATEST_ASSERT_EQ(expL[i], dst[i]);
+        }
+
+        for (uint8_t i = 0; i < 10; i++) {
+            dst[i] = src[i];
+        }
+        shiftBitsRight(dst, inPlace ? dst : src, nBits, n);
+        for (uint8_t i = 0; i < 10; i++) {
+            GREATEST_ASSERT_EQ(expR[i], dst[i]);
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    rotateBits_randomBuffersInAndOutOfPlace_Rotated
+ * @testcase    @ref rotateBitsLeft and @ref rotateBitsRight rotate random
+ * buffers of random lengths, both in place and to another buffer.
+ * @testvalues
+ * | Argument 1 | Argument 2 | Argument 3 | Argument 4 |
+ * | ---------- | ---------- | ---------- | ---------- |
+ * | rand64()   | rand64()   | 1 - 600    | 0 - 1200   |
+ */
+TEST
+rotateBits_randomBuffersInAndOutOfPlace_Rotated()
+{
+    uint64_t src[10], dst[10], expL[10], expR[10];
+
+    for (uint16_t t = 0; t < 1000; t++) {
+        size_t const nBits = 1 + rand() % 600;
+        size_t const n = rand() % (2 * nBits);
+        bool const inPlace = rand() % 2;
+
+        for (uint8_t i = 0; i < 10; i++) {
+            src[i] = expL[i] = expR[i] = rand64();
+        }
+        for (size_t i = 0; i < nBits; i++) {
+            size_t const l = (i + n) % nBits;
+            size_t const r = (i + nBits - n % nBits) % nBits;
+
+            BIT_CLEAR(expL[l / 64], l % 64);
+            BIT_CLEAR(expR[r / 64], r % 64);
+            if (bitGet(src[i / 64], i % 64)) {
+                BIT_SET(expL[l / 64], l % 64);
+                BIT_SET(expR[r / 64], r % 64);
+            }
+        }
+
+        for (uint8_t i = 0; i < 10; i++) {
+            dst[i] = src[i];
+        }
+        rotateBitsLeft(dst, inPlace ? dst : src, nBits, n);
+        for (uint8_t i = 0; i < 10; i++) {
+            GREATEST_ASSERT_EQ(expL[i], dst[i]);
+        }
+
+        for (uint8_t i = 0; i < 10; i++) {
+            dst[i] = src[i];
+        }
+        rotateBitsRight(dst, inPlace ? dst : src, nBits, n);
+        for (uint8_t i = 0; i < 10; i++) {
+            GREATEST_ASSERT_EQ(expR[i], dst[i]);
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    orShiftedBits_randomBuffersInAndOutOfPlace_Merged
+ * @testcase    @ref orShiftedBitsLeft and @ref orShiftedBitsRight OR shifted
+ * random buffers into another buffer or into themselves.
+ * @testvalues
+ * | Argument 1 | Argument 2 | Argument 3 | Argument 4 |
+ * | ---------- | ---------- | ---------- | ---------- |
+ * | rand64()   | rand64()   | 1 - 600    | 0 - 610    |
+ */
+TEST
+orShiftedBits_randomBuffersInAndOutOfPlace_Merged()
+{
+    uint64_t src[10], dst[10], orig[10], expL[10], expR[10];
+
+    for (uint16_t t = 0; t < 1000; t++) {
+        size_t const nBits = 1 + rand() % 600;
+        size_t const n = rand() % (nBits + 10);
+        bool const inPlace = rand() % 2;
+
+        for (uint8_t i = 0; i < 10; i++) {
+            src[i] = rand64();
+            orig[i] = inPlace ? src[i] : rand64();
+            expL[i] = expR[i] = orig[i];
+        }
+        for (size_t i = 0; i < nBits; i++) {
+            if (i >= n && bitGet(src[(i - n) / 64], (i - n) % 64)) {
+                BIT_SET(expL[i / 64], i % 64);
+            }
+            if (i + n < nBits && bitGet(src[(i + n) / 64], (i + n) % 64)) {
+                BIT_SET(expR[i / 64], i % 64);
+            }
+        }
+
+        for (uint8_t i = 0; i < 10; i++) {
+            dst[i] = orig[i];
+        }
+        orShiftedBitsLeft(dst, inPlace ? dst : src, nBits, n);
+        for (uint8_t i = 0; i < 10; i++) {
+            GREATEST_ASSERT_EQ(expL[i], dst[i]);
+        }
+
+        for (uint8_t i = 0; i < 10; i++) {
+            dst[i] = orig[i];
+        }
+        orShiftedBitsRight(dst, inPlace ? dst : src, nBits, n);
+        for (uint8_t i = 0; i < 10; i++) {
+            GREATEST_ASSERT_EQ(expR[i], dst[i]);
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    extractAndDepositBits_magicNumbers_Generated
+ * @testcase    @ref extractBits32, @ref extractBits64, @ref depositBits32 and
+ * @ref depositBits64 pack and scatter the correct bits.
+ * @testvalues
+ * | Argument 1         | Argument 2         |
+ * | ------------------ | ------------------ |
+ * | 0x0000000A         | 0x0000000C         |
+ * | 0x12345678         | 0xFF00FF00         |
+ * | 0x0000000000000003 | 0x8000000000000001 |
+ * | 0xFFFFFFFFFFFFFFFF | 0xAAAAAAAAAAAAAAAA |
+ * | 0xFFFFFFFFFFFFFFFF | 0x0000000000000000 |
+ */
+TEST
+extractAndDepositBits_magicNumbers_Generated()
+{
+    GREATEST_ASSERT_EQ(0x00000002, extractBits32(0x0000000A, 0x0000000C));
+    GREATEST_ASSERT_EQ(0x00001256, extractBits32(0x12345678, 0xFF00FF00));
+    GREATEST_ASSERT_EQ(0x00000008, depositBits32(0x00000002, 0x0000000C));
+    GREATEST_ASSERT_EQ(0x12003400, depositBits32(0x00001234, 0xFF00FF00));
+    GREATEST_ASSERT_EQ(0x0000000000000001,
+                       extractBits64(0x0000000000000003, 0x8000000000000001));
+    GREATEST_ASSERT_EQ(0x00000000FFFFFFFF,
+                       extractBits64(0xFFFFFFFFFFFFFFFF, 0xAAAAAAAAAAAAAAAA));
+    GREATEST_ASSERT_EQ(0x8000000000000001,
+                       depositBits64(0x0000000000000003, 0x8000000000000001));
+    GREATEST_ASSERT_EQ(0xAAAAAAAAAAAAAAAA,
+                       depositBits64(0xFFFFFFFFFFFFFFFF, 0xAAAAAAAAAAAAAAAA));
+    GREATEST_ASSERT_EQ(0x0000000000000000,
+                       extractBits64(0xFFFFFFFFFFFFFFFF, 0x0000000000000000));
+    GREATEST_ASSERT_EQ(0x0000000000000000,
+                       depositBits64(0xFFFFFFFFFFFFFFFF, 0x0000000000000000));
+
+    PASS();
+}
+
+/**
+ * @testname    extractAndDepositBits_randomNumbersAndMasks_Generated
+ * @testcase    @ref extractBits64, @ref depositBits64, the planned and the
+ * batch variants give the same result as extracting and depositing bit by bit.
+ * @testvalues
+ * | Argument 1 | Argument 2                       |
+ * | ---------- | -------------------------------- |
+ * | rand64()   | rand64()                         |
+ * | rand64()   | rand64() & rand64()              |
+ * | rand64()   | rand64() \| rand64()             |
+ */
+TEST
+extractAndDepositBits_randomNumbersAndMasks_Generated()
+{
+    BitExtractPlan plan;
+    uint64_t src[16], ext[16], dep[16];
+
+    for (uint16_t t = 0; t < 1000; t++) {
+        uint64_t mask = rand64();
+
+        if (t % 3 == 1) {
+            mask &= rand64();
+        } else if (t % 3 == 2) {
+            mask |= rand64();
+        }
+        bitExtractPlanInit(&plan, mask);
+        for (uint8_t i = 0; i < 16; i++) {
+            src[i] = rand64();
+        }
+        extractBitsBatch(ext, src, 16, &plan);
+        depositBitsBatch(dep, src, 16, &plan);
+
+        for (uint8_t i = 0; i < 16; i++) {
+            uint64_t expExt = 0, expDep = 0;
+            uint8_t k = 0;
+
+            for (uint8_t b = 0; b < 64; b++) {
+                if (bitGet(mask, b)) {
+                    if (bitGet(src[i], b)) {
+                        BIT_SET(expExt, k);
+                    }
+                    if (bitGet(src[i], k)) {
+                        BIT_SET(expDep, b);
+                    }
+                    k++;
+                }
+            }
+            GREATEST_ASSERT_EQ(expExt, extractBits64(src[i], mask));
+            GREATEST_ASSERT_EQ(expExt, extractBitsPlanned(&plan, src[i]));
+            GREATEST_ASSERT_EQ(expExt, ext[i]);
+            GREATEST_ASSERT_EQ(expDep, depositBits64(src[i], mask));
+            GREATEST_ASSERT_EQ(expDep, depositBitsPlanned(&plan, src[i]));
+            GREATEST_ASSERT_EQ(expDep, dep[i]);
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    morton2D_randomCoordinates_EncodedAndDecoded
+ * @testcase    @ref mortonEncode2D interleaves the bits of random coordinates,
+ * and @ref mortonDecode2D and the batch functions reverse that.
+ * @testvalues
+ * | Argument 1 | Argument 2 |
+ * | ---------- | ---------- |
+ * | rand()     | rand()     |
+ */
+TEST
+morton2D_randomCoordinates_EncodedAndDecoded()
+{
+    uint32_t x[64], y[64], dx[64], dy[64];
+    uint64_t codes[64];
+
+    for (uint8_t i = 0; i < 64; i++) {
+        x[i] = (uint32_t)rand64();
+        y[i] = (uint32_t)rand64();
+    }
+    x[0] = y[1] = 0xFFFFFFFF;
+    mortonEncode2DBatch(codes, x, y, 64);
+    mortonDecode2DBatch(dx, dy, codes, 64);
+
+    for (uint8_t i = 0; i < 64; i++) {
+        uint64_t exp = 0;
+        uint32_t gx, gy;
+
+        for (uint8_t b = 0; b < 32; b++) {
+            exp |= (uint64_t)bitGet(x[i], b) << (2 * b);
+            exp |= (uint64_t)bitGet(y[i], b) << (2 * b + 1);
+        }
+        GREATEST_ASSERT_EQ(exp, mortonEncode2D(x[i], y[i]));
+        GREATEST_ASSERT_EQ(exp, codes[i]);
+        mortonDecode2D(exp, &gx, &gy);
+        GREATEST_ASSERT_EQ(x[i], gx);
+        GREATEST_ASSERT_EQ(y[i], gy);
+        GREATEST_ASSERT_EQ(x[i], dx[i]);
+        GREATEST_ASSERT_EQ(y[i], dy[i]);
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    morton3D_randomCoordinates_EncodedAndDecoded
+ * @testcase    @ref mortonEncode3D interleaves the bits of random 21-bit
+ * coordinates, and @ref mortonDecode3D and the batch functions reverse that.
+ * @testvalues
+ * | Argument 1         | Argument 2         | Argument 3         |
+ * | ------------------ | ------------------ | ------------------ |
+ * | rand() & 0x1FFFFF  | rand() & 0x1FFFFF  | rand() & 0x1FFFFF  |
+ */
+TEST
+morton3D_randomCoordinates_EncodedAndDecoded()
+{
+    uint32_t x[64], y[64], z[64], dx[64], dy[64], dz[64];
+    uint64_t codes[64];
+
+    for (uint8_t i = 0; i < 64; i++) {
+        x[i] = rand() & 0x1FFFFF;
+        y[i] = rand() & 0x1FFFFF;
+        z[i] = rand() & 0x1FFFFF;
+    }
+    x[0] = y[1] = z[2] = 0x1FFFFF;
+    mortonEncode3DBatch(codes, x, y, z, 64);
+    mortonDecode3DBatch(dx, dy, dz, codes, 64);
+
+    for (uint8_t i = 0; i < 64; i++) {
+        uint64_t exp = 0;
+        uint32_t gx, gy, gz;
+
+        for (uint8_t b = 0; b < 21; b++) {
+            exp |= (uint64_t)bitGet(x[i], b) << (3 * b);
+            exp |= (uint64_t)bitGet(y[i], b) << (3 * b + 1);
+            exp |= (uint64_t)bitGet(z[i], b) << (3 * b + 2);
+        }
+        GREATEST_ASSERT_EQ(exp, mortonEncode3D(x[i], y[i], z[i]));
+        GREATEST_ASSERT_EQ(exp, codes[i]);
+        mortonDecode3D(exp, &gx, &gy, &gz);
+        GREATEST_ASSERT_EQ(x[i], gx);
+        GREATEST_ASSERT_EQ(y[i], gy);
+        GREATEST_ASSERT_EQ(z[i], gz);
+        GREATEST_ASSERT_EQ(x[i], dx[i]);
+        GREATEST_ASSERT_EQ(y[i], dy[i]);
+        GREATEST_ASSERT_EQ(z[i], dz[i]);
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    mortonAdd_randomCoordinates_Added
+ * @testcase    @ref mortonAdd2D and @ref mortonAdd3D add the coordinates of
+ * random points, including negative steps to neighbours.
+ * @testvalues
+ * | Argument 1      | Argument 2         |
+ * | --------------- | ------------------ |
+ * | random point    | random point       |
+ * | random point    | (-1, 0) / (0,0,-1) |
+ */
+TEST
+mortonAdd_randomCoordinates_Added()
+{
+    for (uint16_t t = 0; t < 1000; t++) {
+        uint32_t const ax = (uint32_t)rand64(), ay = (uint32_t)rand64();
+        uint32_t const bx = (uint32_t)rand64(), by = (uint32_t)rand64();
+        uint32_t const az = (uint32_t)rand64(), bz = (uint32_t)rand64();
+
+        GREATEST_ASSERT_EQ(mortonEncode2D(ax + bx, ay + by),
+                mortonAdd2D(mortonEncode2D(ax, ay), mortonEncode2D(bx, by)));
+        GREATEST_ASSERT_EQ(mortonEncode2D(ax - 1, ay),
+                mortonAdd2D(mortonEncode2D(ax, ay),
+                            mortonEncode2D(0xFFFFFFFF, 0)));
+        GREATEST_ASSERT_EQ(
+                mortonEncode3D(ax + bx, ay + by, (az + bz) & 0x1FFFFF),
+                mortonAdd3D(mortonEncode3D(ax, ay, az),
+                            mortonEncode3D(bx, by, bz)));
+        GREATEST_ASSERT_EQ(mortonEncode3D(ax, ay, (az - 1) & 0x1FFFFF),
+                mortonAdd3D(mortonEncode3D(ax, ay, az),
+                            mortonEncode3D(0, 0, 0x1FFFFF)));
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    mortonBigMinLitMax_randomBoxes_Found
+ * @testcase    @ref mortonBigMin2D, @ref mortonLitMax2D, @ref mortonBigMin3D
+ * and @ref mortonLitMax3D find the same codes as a scan over all codes of
+ * random boxes in a 16 x 16 and a 8 x 8 x 8 grid.
+ * @testvalues
+ * | Argument 1                 | Argument 2 | Argument 3 |
+ * | -------------------------- | ---------- | ---------- |
+ * | codes outside the box      | box min    | box max    |
+ */
+TEST
+mortonBigMinLitMax_randomBoxes_Found()
+{
+    uint32_t x, y, z;
+
+    for (uint8_t t = 0; t < 100; t++) {
+        uint32_t const x0 = rand() % 16, x1 = x0 + rand() % (16 - x0);
+        uint32_t const y0 = rand() % 16, y1 = y0 + rand() % (16 - y0);
+        uint64_t const min = mortonEncode2D(x0, y0);
+        uint64_t const max = mortonEncode2D(x1, y1);
+
+        for (uint64_t c = min; c <= max; c++) {
+            uint64_t bigMin = max, litMax = min;
+
+            mortonDecode2D(c, &x, &y);
+            if (x >= x0 && x <= x1 && y >= y0 && y <= y1) {
+                continue;
+            }
+            for (uint64_t d = min; d <= max; d++) {
+                mortonDecode2D(d, &x, &y);
+                if (x >= x0 && x <= x1 && y >= y0 && y <= y1) {
+                    if (d < c) {
+                        litMax = d;
+                    } else if (d < bigMin) {
+                        bigMin = d;
+                    }
+                }
+            }
+            GREATEST_ASSERT_EQ(bigMin, mortonBigMin2D(c, min, max));
+            GREATEST_ASSERT_EQ(litMax, mortonLitMax2D(c, min, max));
+        }
+    }
+
+    for (uint8_t t = 0; t < 100; t++) {
+        uint32_t const x0 = rand() % 8, x1 = x0 + rand() % (8 - x0);
+        uint32_t const y0 = rand() % 8, y1 = y0 + rand() % (8 - y0);
+        uint32_t const z0 = rand() % 8, z1 = z0 + rand() % (8 - z0);
+        uint64_t const min = mortonEncode3D(x0, y0, z0);
+        uint64_t const max = mortonEncode3D(x1, y1, z1);
+
+        for (uint64_t c = min; c <= max; c++) {
+            uint64_t bigMin = max, litMax = min;
+
+            mortonDecode3D(c, &x, &y, &z);
+            if (x >= x0 && x <= x1 && y >= y0 && y <= y1
+                    && z >= z0 && z <= z1) {
+                continue;
+            }
+            for (uint64_t d = min; d <= max; d++) {
+                mortonDecode3D(d, &x, &y, &z);
+                if (x >= x0 && x <= x1 && y >= y0 && y <= y1
+                        && z >= z0 && z <= z1) {
+                    if (d < c) {
+                        litMax = d;
+                    } else if (d < bigMin) {
+                        bigMin = d;
+                    }
+                }
+            }
+            GREATEST_ASSERT_EQ(bigMin, mortonBigMin3D(c, min, max));
+            GREATEST_ASSERT_EQ(litMax, mortonLitMax3D(c, min, max));
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    hilbert_knownPoints_Encoded
+ * @testcase    @ref hilbertEncode2D and @ref hilbertEncode3D give the indices
+ * of John Skilling's algorithm, and the decode functions reverse those.
+ * @testvalues
+ * | Argument 1 | Argument 2 | Argument 3 |
+ * | ---------- | ---------- | ---------- |
+ * | 0xF4BEA973 | 0xDCF4BB99 |            |
+ * | 0x0E7A269F | 0x177219D3 |            |
+ * | 0xFFFFFFFF | 0x00000000 |            |
+ * | 0x00000000 | 0x00000001 |            |
+ * | 281782     | 1193707    | 1777197    |
+ * | 534918     | 247293     | 1039002    |
+ * | 0x1FFFFF   | 0          | 0          |
+ * | 0          | 1          | 0          |
+ */
+TEST
+hilbert_knownPoints_Encoded()
+{
+    uint32_t x, y, z;
+
+    GREATEST_ASSERT_EQ(0xACE0B04C898C7CCC,
+                       hilbertEncode2D(0xF4BEA973, 0xDCF4BB99));
+    GREATEST_ASSERT_EQ(0x03432AE2A7D7B8F0,
+                       hilbertEncode2D(0x0E7A269F, 0x177219D3));
+    GREATEST_ASSERT_EQ(0xFFFFFFFFFFFFFFFF,
+                       hilbertEncode2D(0xFFFFFFFF, 0x00000000));
+    GREATEST_ASSERT_EQ(0x0000000000000003,
+                       hilbertEncode2D(0x00000000, 0x00000001));
+    GREATEST_ASSERT_EQ(0x22C7D484F41EB194,
+                       hilbertEncode3D(281782, 1193707, 1777197));
+    GREATEST_ASSERT_EQ(0x08524BBCCC36A5A7,
+                       hilbertEncode3D(534918, 247293, 1039002));
+    GREATEST_ASSERT_EQ(0x7FFFFFFFFFFFFFFF, hilbertEncode3D(0x1FFFFF, 0, 0));
+    GREATEST_ASSERT_EQ(0x0000000000000007, hilbertEncode3D(0, 1, 0));
+
+    hilbertDecode2D(0xACE0B04C898C7CCC, &x, &y);
+    GREATEST_ASSERT_EQ(0xF4BEA973, x);
+    GREATEST_ASSERT_EQ(0xDCF4BB99, y);
+    hilbertDecode3D(0x22C7D484F41EB194, &x, &y, &z);
+    GREATEST_ASSERT_EQ(281782, x);
+    GREATEST_ASSERT_EQ(1193707, y);
+    GREATEST_ASSERT_EQ(1777197, z);
+
+    PASS();
+}
+
+/**
+ * @testname    hilbert_randomIndices_NeighboursAreAdjacent
+ * @testcase    Consecutive indices decode to points that differ by one in
+ * exactly one coordinate, and the batch functions reverse each other and
+ * match the single point functions for a count that is not a multiple of the
+ * batch width.
+ * @testvalues
+ * | Argument          |
+ * | ----------------- |
+ * | rand64() >> 1     |
+ * | rand64() >> 2     |
+ */
+TEST
+hilbert_randomIndices_NeighboursAreAdjacent()
+{
+    uint64_t idx[64], got[64];
+    uint32_t x[64], y[64], z[64];
+
+    for (uint8_t i = 0; i < 64; i++) {
+        idx[i] = (i % 2) ? idx[i - 1] + 1 : rand64() >> 1;
+    }
+    hilbertDecode2DBatch(x, y, idx, 64);
+    hilbertEncode2DBatch(got, x, y, 64);
+    for (uint8_t i = 0; i < 64; i++) {
+        GREATEST_ASSERT_EQ(idx[i], got[i]);
+        if (i % 2) {
+            uint32_t const dx = (x[i] > x[i - 1]) ? x[i] - x[i - 1]
+                    : x[i - 1] - x[i];
+            uint32_t const dy = (y[i] > y[i - 1]) ? y[i] - y[i - 1]
+                    : y[i - 1] - y[i];
+
+            GREATEST_ASSERT_EQ(1, dx + dy);
+        }
+    }
+    hilbertEncode2DBatch(got, x, y, 63);
+    for (uint8_t i = 0; i < 63; i++) {
+        GREATEST_ASSERT_EQ(hilbertEncode2D(x[i], y[i]), got[i]);
+    }
+
+    for (uint8_t i = 0; i < 64; i++) {
+        idx[i] = (i % 2) ? idx[i - 1] + 1 : rand64() >> 2;
+    }
+    hilbertDecode3DBatch(x, y, z, idx, 64);
+    hilbertEncode3DBatch(got, x, y, z, 64);
+    for (uint8_t i = 0; i < 64; i++) {
+        GREATEST_ASSERT_EQ(idx[i], got[i]);
+        if (i % 2) {
+            uint32_t const dx = (x[i] > x[i - 1]) ? x[i] - x[i - 1]
+                    : x[i - 1] - x[i];
+            uint32_t const dy = (y[i] > y[i - 1]) ? y[i] - y[i - 1]
+                    : y[i - 1] - y[i];
+            uint32_t const dz = (z[i] > z[i - 1]) ? z[i] - z[i - 1]
+                    : z[i - 1] - z[i];
+
+            GREATEST_ASSERT_EQ(1, dx + dy + dz);
+        }
+    }
+    hilbertEncode3DBatch(got, x, y, z, 63);
+    for (uint8_t i = 0; i < 63; i++) {
+        GREATEST_ASSERT_EQ(hilbertEncode3D(x[i], y[i], z[i]), got[i]);
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    transposeBits8x8_randomMatrices_Transposed
+ * @testcase    @ref transposeBits8x8 and @ref transposeBits8x8Batch move bit
+ * j of byte i to bit i of byte j of random matrices.
+ * @testvalues
+ * | Argument           |
+ * | ------------------ |
+ * | 0x8040201008040201 |
+ * | 0x00000000000000FF |
+ * | rand64()           |
+ */
+TEST
+transposeBits8x8_randomMatrices_Transposed()
+{
+    uint64_t src[33], dst[33];
+
+    GREATEST_ASSERT_EQ(0x8040201008040201,
+                       transposeBits8x8(0x8040201008040201));
+    GREATEST_ASSERT_EQ(0x0101010101010101,
+                       transposeBits8x8(0x00000000000000FF));
+
+    for (uint8_t i = 0; i < 33; i++) {
+        src[i] = rand64() ^ (rand64() << 1);
+    }
+    transposeBits8x8Batch(dst, src, 33);
+    for (uint8_t i = 0; i < 33; i++) {
+        uint64_t exp = 0;
+
+        for (uint8_t r = 0; r < 8; r++) {
+            for (uint8_t c = 0; c < 8; c++) {
+                if (bitGet(src[i], 8 * r + c)) {
+                    BIT_SET(exp, 8 * c + r);
+                }
+            }
+        }
+        GREATEST_ASSERT_EQ(exp, transposeBits8x8(src[i]));
+        GREATEST_ASSERT_EQ(exp, dst[i]);
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    transposeBits32x32_randomMatrices_Transposed
+ * @testcase    @ref transposeBits32x32 and @ref transposeBits32x32Batch move
+ * bit j of row i to bit i of row j of random matrices, in and out of place.
+ * @testvalues
+ * | Argument         |
+ * | ---------------- |
+ * | 3 x 32 rand64()  |
+ */
+TEST
+transposeBits32x32_randomMatrices_Transposed()
+{
+    uint32_t src[3 * 32], dst[3 * 32], tmp[32];
+
+    for (uint8_t i = 0; i < 3 * 32; i++) {
+        src[i] = (uint32_t)(rand64() ^ (rand64() >> 31));
+    }
+    transposeBits32x32Batch(dst, src, 3);
+    for (uint8_t m = 0; m < 3; m++) {
+        for (uint8_t r = 0; r < 32; r++) {
+            for (uint8_t c = 0; c < 32; c++) {
+                GREATEST_ASSERT_EQ(bitGet(src[32 * m + r], c),
+                                   bitGet(dst[32 * m + c], r));
+            }
+        }
+    }
+
+    memcpy(tmp, src, sizeof(tmp));
+    transposeBits32x32(tmp, tmp);
+    for (uint8_t i = 0; i < 32; i++) {
+        GREATEST_ASSERT_EQ(dst[i], tmp[i]);
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    transposeBits64x64_randomMatrices_Transposed
+ * @testcase    @ref transposeBits64x64 and @ref transposeBits64x64Batch move
+ * bit j of row i to bit i of row j of random matrices, in and out of place.
+ * @testvalues
+ * | Argument         |
+ * | ---------------- |
+ * | 3 x 64 rand64()  |
+ */
+TEST
+transposeBits64x64_randomMatrices_Transposed()
+{
+    uint64_t src[3 * 64], dst[3 * 64], tmp[64];
+
+    for (uint8_t i = 0; i < 3 * 64; i++) {
+        src[i] = rand64() ^ (rand64() << 1);
+    }
+    transposeBits64x64Batch(dst, src, 3);
+    for (uint8_t m = 0; m < 3; m++) {
+        for (uint8_t r = 0; r < 64; r++) {
+            for (uint8_t c = 0; c < 64; c++) {
+                GREATEST_ASSERT_EQ(bitGet(src[64 * m + r], c),
+                                   bitGet(dst[64 * m + c], r));
+            }
+        }
+    }
+
+    memcpy(tmp, src, sizeof(tmp));
+    transposeBits64x64(tmp, tmp);
+    for (uint8_t i = 0; i < 64; i++) {
+        GREATEST_ASSERT_EQ(dst[i], tmp[i]);
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    positionalPopcount_randomArrays_CountsPerBit
+ * @testcase    @ref positionalPopcount8, @ref positionalPopcount16 and
+ * @ref positionalPopcount32 add the number of variables with bit i set to
+ * counter i, for lengths around the block size of the kernel.
+ * @testvalues
+ * | Argument                     |
+ * | ---------------------------- |
+ * | 0 ... 300 x rand64()         |
+ */
+TEST
+positionalPopcount_randomArrays_CountsPerBit()
+{
+    uint8_t d8[300];
+    uint16_t d16[300];
+    uint32_t d32[300];
+    uint64_t c8[8], c16[16], c32[32], e8[8], e16[16], e32[32];
+
+    for (uint16_t i = 0; i < 300; i++) {
+        d32[i] = (uint32_t)rand64();
+        d16[i] = (uint16_t)d32[i];
+        d8[i] = (uint8_t)(d32[i] >> 7);
+    }
+    for (uint16_t n = 0; n <= 300; n += (n < 70) ? 1 : 23) {
+        memset(e8, 0, sizeof(e8));
+        memset(e16, 0, sizeof(e16));
+        memset(e32, 0, sizeof(e32));
+        for (uint16_t i = 0; i < n; i++) {
+            for (uint8_t b = 0; b < 32; b++) {
+                if (b < 8) {
+                    e8[b] += bitGet(d8[i], b);
+                }
+                if (b < 16) {
+                    e16[b] += bitGet(d16[i], b);
+                }
+                e32[b] += bitGet(d32[i], b);
+            }
+        }
+        /* The counts are added to the counters */
+        memset(c8, 0, sizeof(c8));
+        c16[0] = 5;
+        memset(&c16[1], 0, sizeof(c16) - sizeof(c16[0]));
+        memset(c32, 0, sizeof(c32));
+        positionalPopcount8(c8, d8, n);
+        positionalPopcount16(c16, d16, n);
+        positionalPopcount32(c32, d32, n);
+        GREATEST_ASSERT_EQ(e16[0] + 5, c16[0]);
+        for (uint8_t b = 0; b < 32; b++) {
+            if (b < 8) {
+                GREATEST_ASSERT_EQ(e8[b], c8[b]);
+            }
+            if (b > 0 && b < 16) {
+                GREATEST_ASSERT_EQ(e16[b], c16[b]);
+            }
+            GREATEST_ASSERT_EQ(e32[b], c32[b]);
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    positionalPopcount_allOnes_CountsLength
+ * @testcase    @ref positionalPopcount16 counts every bit of an array of all
+ * ones, which saturates every carry-save adder.
+ * @testvalues
+ * | Argument       |
+ * | -------------- |
+ * | 1000 x 0xFFFF  |
+ */
+TEST
+positionalPopcount_allOnes_CountsLength()
+{
+    uint16_t data[1000];
+    uint64_t counts[16] = {0};
+
+    memset(data, 0xFF, sizeof(data));
+    positionalPopcount16(counts, data, 1000);
+    for (uint8_t b = 0; b < 16; b++) {
+        GREATEST_ASSERT_EQ(1000, counts[b]);
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    hammingDistance_randomCodes_Counted
+ * @testcase    @ref hammingDistance counts the bits that differ between random
+ * codes of 0 to 20 words.
+ * @testvalues
+ * | Argument 1 | Argument 2 | Argument 3 |
+ * | ---------- | ---------- | ---------- |
+ * | rand64()   | rand64()   | 0 - 20     |
+ */
+TEST
+hammingDistance_randomCodes_Counted()
+{
+    uint64_t a[20], b[20];
+
+    for (uint8_t i = 0; i < 20; i++) {
+        a[i] = rand64() ^ (rand64() << 1);
+        b[i] = rand64() ^ (rand64() << 1);
+    }
+    for (uint8_t n = 0; n <= 20; n++) {
+        uint32_t d = 0;
+
+        for (uint16_t i = 0; i < 64 * n; i++) {
+            d += bitGet(a[i / 64], i % 64) != bitGet(b[i / 64], i % 64);
+        }
+        GREATEST_ASSERT_EQ(d, hammingDistance(a, b, n));
+        GREATEST_ASSERT_EQ(0, hammingDistance(a, a, n));
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    hammingTopK_randomCodes_NearestFound
+ * @testcase    @ref hammingTopKScan, @ref hammingTopKScanBatch and
+ * @ref hammingTopKMerge find the k codes nearest to random queries, ranked by
+ * distance and index by @ref hammingTopKSort.
+ * @testvalues
+ * | Argument 1       | Argument 2 | Argument 3 |
+ * | ---------------- | ---------- | ---------- |
+ * | 11200 x rand64() | 4 or 16    | 0 or 10    |
+ */
+TEST
+hammingTopK_randomCodes_NearestFound()
+{
+    static uint64_t codes[700 * 16];
+    uint64_t queries[3 * 16];
+    static uint32_t all[700 * 4];
+    uint32_t dist[5][10];
+    size_t index[5][10];
+    HammingTopK t[5];
+
+    for (uint16_t i = 0; i < 700 * 16; i++) {
+        codes[i] = rand64() ^ (rand64() << 1);
+    }
+    for (uint8_t nWords = 4; nWords <= 16; nWords += 12) {
+        uint16_t const nCodes = 700 * 16 / nWords;
+
+        for (uint8_t i = 0; i < 3 * nWords; i++) {
+            queries[i] = rand64() ^ (rand64() << 1);
+        }
+        /* Make some codes duplicates of the first query */
+        memcpy(&codes[5 * nWords], queries, nWords * sizeof(uint64_t));
+        memcpy(&codes[9 * nWords], queries, nWords * sizeof(uint64_t));
+        for (uint8_t k = 0; k <= 10; k += 10) {
+            for (uint8_t q = 0; q < 5; q++) {
+                hammingTopKInit(&t[q], index[q], dist[q], k);
+            }
+            hammingTopKScanBatch(t, queries, 3, codes, nCodes, nWords, 0);
+            /* Scan the first query in two parts and merge */
+            hammingTopKScan(&t[3], queries, codes, 300, nWords, 0);
+            hammingTopKScan(&t[4], queries, &codes[300 * nWords],
+                            nCodes - 300, nWords, 300);
+            hammingTopKMerge(&t[3], &t[4]);
+
+            for (uint8_t q = 0; q < 4; q++) {
+                uint64_t const *const query = &queries[(q % 3) * nWords];
+
+                GREATEST_ASSERT_EQ(k, hammingTopKSort(&t[q]));
+                for (uint16_t i = 0; i < nCodes; i++) {
+                    all[i] = hammingDistance(query, &codes[i * nWords],
+                                             nWords);
+                }
+                for (uint8_t r = 0; r < k; r++) {
+                    uint16_t nBefore = 0;
+
+                    GREATEST_ASSERT_EQ(all[index[q][r]], dist[q][r]);
+                    for (uint16_t i = 0; i < nCodes; i++) {
+                        nBefore += all[i] < dist[q][r]
+                                || (all[i] == dist[q][r] && i < index[q][r]);
+                    }
+                    GREATEST_ASSERT_EQ(r, nBefore);
+                }
+            }
+            if (k > 0) {
+                GREATEST_ASSERT_EQ(5, index[0][0]);
+                GREATEST_ASSERT_EQ(9, index[0][1]);
+                GREATEST_ASSERT_EQ(0, dist[0][1]);
+            }
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    tanimotoSimilarity_randomCodes_Computed
+ * @testcase    @ref tanimotoSimilarity and @ref nBitsSetBatch count the bits
+ * set in both, either and each of random codes of 0 to 32 words.
+ * @testvalues
+ * | Argument 1 | Argument 2 | Argument 3 |
+ * | ---------- | ---------- | ---------- |
+ * | rand64()   | rand64()   | 0 - 32     |
+ */
+TEST
+tanimotoSimilarity_randomCodes_Computed()
+{
+    uint64_t a[32], b[32];
+    uint32_t counts[2];
+
+    for (uint8_t i = 0; i < 32; i++) {
+        a[i] = rand64() ^ (rand64() << 1);
+        b[i] = a[i] & (rand64() ^ (rand64() << 1));
+    }
+    for (uint8_t n = 0; n <= 32; n++) {
+        uint32_t nA = 0, nAnd = 0, nOr = 0;
+
+        for (uint16_t i = 0; i < 64 * n; i++) {
+            bool const x = bitGet(a[i / 64], i % 64);
+            bool const y = bitGet(b[i / 64], i % 64);
+
+            nA += x;
+            nAnd += x && y;
+            nOr += x || y;
+        }
+        GREATEST_ASSERT_EQ((nOr > 0) ? (double)nAnd / nOr : 0.0,
+                           tanimotoSimilarity(a, b, n));
+        nBitsSetBatch(counts, a, 1, n);
+        GREATEST_ASSERT_EQ(nA, counts[0]);
+    }
+    GREATEST_ASSERT_EQ(1.0, tanimotoSimilarity(a, a, 32));
+    nBitsSetBatch(counts, a, 2, 16);
+    GREATEST_ASSERT_EQ(nBitsSet64(a[0]), counts[0] - hammingDistance(&a[1],
+                       (uint64_t[15]){0}, 15));
+    GREATEST_ASSERT_EQ(nBitsSet64(a[16]), counts[1] - hammingDistance(&a[17],
+                       (uint64_t[15]){0}, 15));
+
+    PASS();
+}
+
+/**
+ * @testname    tanimotoTopK_randomCodes_MostSimilarFound
+ * @testcase    @ref tanimotoTopKScan and @ref tanimotoTopKMerge find the k
+ * codes most similar to a query with at least a threshold similarity, ranked
+ * by similarity and index by @ref tanimotoTopKSort.
+ * @testvalues
+ * | Argument 1      | Argument 2 | Argument 3    |
+ * | --------------- | ---------- | ------------- |
+ * | 500 x rand64()  | 0 - 20     | 0, 0.18 - 0.5 |
+ */
+TEST
+tanimotoTopK_randomCodes_MostSimilarFound()
+{
+    static uint64_t codes[500 * 8];
+    uint64_t query[8];
+    uint32_t counts[500];
+    double all[500], similarity[2][20];
+    size_t index[2][20];
+    TanimotoTopK t[2];
+
+    /* Codes with 1/2, 1/4 and 1/8 of the bits set, and some empty codes */
+    for (uint16_t i = 0; i < 500 * 8; i++) {
+        codes[i] = rand64() ^ (rand64() << 1);
+        for (uint8_t s = (i / 8) % 4; s > 0; s--) {
+            codes[i] &= rand64() ^ (rand64() << 1);
+        }
+        codes[i] = ((i / 8) % 37 == 0) ? 0 : codes[i];
+    }
+    nBitsSetBatch(counts, codes, 500, 8);
+    for (uint8_t i = 0; i < 8; i++) {
+        query[i] = codes[8 * 42 + i] | (rand64() & rand64() & rand64());
+    }
+    for (uint16_t i = 0; i < 500; i++) {
+        all[i] = tanimotoSimilarity(query, &codes[8 * i], 8);
+    }
+
+    for (uint8_t k = 0; k <= 20; k += 5) {
+        for (uint8_t h = 0; h <= 5; h++) {
+            double const threshold = (h > 0) ? 0.1 + 0.08 * h : 0.0;
+            uint16_t nAbove = 0;
+
+            tanimotoTopKInit(&t[0], index[0], similarity[0], k, threshold);
+            tanimotoTopKInit(&t[1], index[1], similarity[1], k, threshold);
+            tanimotoTopKScan(&t[0], query, codes, counts, 200, 8, 0);
+            tanimotoTopKScan(&t[1], query, &codes[8 * 200], &counts[200],
+                             300, 8, 200);
+            tanimotoTopKMerge(&t[0], &t[1]);
+
+            for (uint16_t i = 0; i < 500; i++) {
+                nAbove += all[i] >= threshold;
+            }
+            GREATEST_ASSERT_EQ((nAbove < k) ? nAbove : k,
+                               tanimotoTopKSort(&t[0]));
+            for (uint8_t r = 0; r < t[0].n; r++) {
+                uint16_t nBefore = 0;
+
+                GREATEST_ASSERT_EQ(all[index[0][r]], similarity[0][r]);
+                for (uint16_t i = 0; i < 500; i++) {
+                    nBefore += all[i] > similarity[0][r]
+                            || (all[i] == similarity[0][r]
+                                && i < index[0][r]);
+                }
+                GREATEST_ASSERT_EQ(r, nBefore);
+            }
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    bloomFilter_randomKeys_NoFalseNegatives
+ * @testcase    @ref bloomFilterInsert, @ref bloomFilterInsertBatch and
+ * @ref bloomFilterQueryBatch find every inserted key, and find few of the keys
+ * that were not inserted with 16 bits per key. Bits of the result beyond the
+ * queried keys are left unchanged.
+ * @testvalues
+ * | Argument          |
+ * | ----------------- |
+ * | 20000 x rand64()  |
+ */
+TEST
+bloomFilter_randomKeys_NoFalseNegatives()
+{
+    static uint64_t words[2500], keys[20000], result[BITBUF_NWORDS(10000)];
+    BloomFilter f;
+    size_t nFalse;
+
+    for (uint16_t i = 0; i < 20000; i++) {
+        keys[i] = rand64() ^ (rand64() << 1);
+    }
+    bloomFilterInit(&f, words, 2500);
+    for (uint16_t i = 0; i < 5000; i++) {
+        bloomFilterInsert(&f, keys[i]);
+    }
+    bloomFilterInsertBatch(&f, &keys[5000], 5000);
+
+    memset(result, 0, sizeof(result));
+    GREATEST_ASSERT_EQ(10000, bloomFilterQueryBatch(&f, result, keys, 10000));
+    for (uint16_t i = 0; i < 10000; i++) {
+        GREATEST_ASSERT(bitGet(result[i / 64], i % 64));
+    }
+
+    memset(result, 0xFF, sizeof(result));
+    nFalse = bloomFilterQueryBatch(&f, result, &keys[10000], 9993);
+    for (uint16_t i = 0; i < 9993; i++) {
+        GREATEST_ASSERT_EQ(bloomFilterQuery(&f, keys[10000 + i]),
+                           bitGet(result[i / 64], i % 64));
+    }
+    for (uint16_t i = 9993; i < 64 * BITBUF_NWORDS(10000); i++) {
+        GREATEST_ASSERT(bitGet(result[i / 64], i % 64));
+    }
+    GREATEST_ASSERT(nFalse < 100);
+
+    PASS();
+}
+
+/**
+ * @testname    binaryFuseFilter_randomKeys_NoFalseNegatives
+ * @testcase    @ref binaryFuseFilterBuild builds 8 and 16-bit filters of
+ * random sets of keys with some duplicates, in which
+ * @ref binaryFuseFilterContains and @ref binaryFuseFilterContainsBatch find
+ * every key and few of the keys that are not in the set.
+ * @testvalues
+ * | Argument 1         | Argument 2 |
+ * | ------------------ | ---------- |
+ * | 0 - 10000 rand64() | 8 or 16    |
+ */
+TEST
+binaryFuseFilter_randomKeys_NoFalseNegatives()
+{
+    static uint64_t keys[20000], scratch[40000];
+    static uint16_t fingerprints[15000];
+    uint64_t result[BITBUF_NWORDS(10000)];
+    uint16_t const sizes[] = {0, 1, 2, 3, 10, 100, 1000, 10000};
+    BinaryFuseFilter f;
+
+    for (uint16_t i = 0; i < 20000; i++) {
+        keys[i] = rand64() ^ (rand64() << 1);
+    }
+    keys[7] = keys[3];
+    keys[999] = keys[500];
+    for (uint8_t bits = 8; bits <= 16; bits += 8) {
+        for (uint8_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            uint16_t const n = sizes[s];
+            size_t nFalse;
+
+            GREATEST_ASSERT(binaryFuseFilterInit(&f, n, bits)
+                            <= sizeof(fingerprints) / sizeof(fingerprints[0]));
+            GREATEST_ASSERT(binaryFuseFilterScratchSize(&f, n)
+                            <= sizeof(scratch));
+            GREATEST_ASSERT(binaryFuseFilterBuild(&f, fingerprints, scratch,
+                                                  keys, n));
+            for (uint16_t i = 0; i < n; i++) {
+                GREATEST_ASSERT(binaryFuseFilterContains(&f, keys[i]));
+            }
+            GREATEST_ASSERT_EQ(n, binaryFuseFilterContainsBatch(&f, result,
+                                                                keys, n));
+
+            nFalse = binaryFuseFilterContainsBatch(&f, result, &keys[10000],
+                                                   10000);
+            for (uint16_t i = 0; i < 10000; i++) {
+                GREATEST_ASSERT_EQ(binaryFuseFilterContains(&f,
+                                                            keys[10000 + i]),
+                                   bitGet(result[i / 64], i % 64));
+            }
+            GREATEST_ASSERT(nFalse < ((bits == 8) ? 80 : 5));
+        }
+        /* About 1.25 fingerprints per key for 10000 keys */
+        GREATEST_ASSERT(f.arrayLength < 1.3 * 10000);
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    atomicBit_singleBits_SetAndCleared
+ * @testcase    @ref atomicBitSet, @ref atomicBitClear,
+ * @ref atomicBitTestAndSet and @ref atomicBitTestAndClear change single bits
+ * of a buffer of bits and report their old values.
+ * @testvalues
+ * | Argument 1 | Argument 2 |
+ * | ---------- | ---------- |
+ * | 0          | 0 - 199    |
+ */
+TEST
+atomicBit_singleBits_SetAndCleared()
+{
+    uint64_t bits[BITBUF_NWORDS(200)] = {0};
+
+    for (uint8_t n = 0; n < 200; n++) {
+        GREATEST_ASSERT_FALSE(atomicBitTestAndSet(bits, n));
+        GREATEST_ASSERT(atomicBitTestAndSet(bits, n));
+        GREATEST_ASSERT(atomicBitTestAndClear(bits, n));
+        GREATEST_ASSERT_FALSE(atomicBitTestAndClear(bits, n));
+        atomicBitSet(bits, n);
+        GREATEST_ASSERT(bitGet(bits[n / 64], n % 64));
+        GREATEST_ASSERT_EQ(n % 64 + 1, nBitsSet64(bits[n / 64]));
+    }
+    for (uint8_t n = 0; n < 200; n++) {
+        atomicBitClear(bits, n);
+        GREATEST_ASSERT_FALSE(bitGet(bits[n / 64], n % 64));
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    atomicBitAcquireFirstZero_fillAndRelease_AllBitsAcquired
+ * @testcase    @ref atomicBitAcquireFirstZero claims every bit of a buffer of
+ * bits once, starting at the hint and wrapping around, and claims released
+ * bits again.
+ * @testvalues
+ * | Argument 1 | Argument 2 | Argument 3 |
+ * | ---------- | ---------- | ---------- |
+ * | 0          | 200        | 0 - 300    |
+ */
+TEST
+atomicBitAcquireFirstZero_fillAndRelease_AllBitsAcquired()
+{
+    uint64_t bits[BITBUF_NWORDS(200)];
+
+    for (uint16_t hint = 0; hint <= 300; hint += 50) {
+        memset(bits, 0, sizeof(bits));
+        for (uint16_t i = 0; i < 200; i++) {
+            size_t const n = atomicBitAcquireFirstZero(bits, 200, hint);
+            /* The words from the word of the hint onwards fill first */
+            size_t const start = (hint < 200) ? hint / 64 * 64 : 0;
+            size_t const expected = (start + i < 200) ? start + i
+                                                      : start + i - 200;
+
+            GREATEST_ASSERT_EQ(expected, n);
+        }
+        GREATEST_ASSERT_EQ(200, atomicBitAcquireFirstZero(bits, 200, hint));
+        GREATEST_ASSERT_EQ(0xFF, bits[3]);
+
+        atomicBitClear(bits, 77);
+        atomicBitClear(bits, 5);
+        GREATEST_ASSERT_EQ(77, atomicBitAcquireFirstZero(bits, 200, 70));
+        GREATEST_ASSERT_EQ(5, atomicBitAcquireFirstZero(bits, 200, 70));
+        GREATEST_ASSERT_EQ(200, atomicBitAcquireFirstZero(bits, 200, 70));
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    hierarchicalBitmap_randomBits_Found
+ * @testcase    @ref hierarchicalBitmapNextSet, @ref hierarchicalBitmapPrevSet,
+ * @ref hierarchicalBitmapNextZero and @ref hierarchicalBitmapIsRangeEmpty
+ * agree with a scan of the bitmap after random sets and clears, for bitmaps
+ * of one, two and three levels.
+ * @testvalues
+ * | Argument 1      | Argument 2        |
+ * | --------------- | ----------------- |
+ * | 0 - 300000 bits | rand64() % nBits  |
+ */
+TEST
+hierarchicalBitmap_randomBits_Found()
+{
+    static uint64_t words[5000];
+    size_t const sizes[] = {0, 1, 64, 100, 4096, 5000, 300000};
+    HierarchicalBitmap b;
+
+    for (uint8_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t const nBits = sizes[s];
+
+        GREATEST_ASSERT(hierarchicalBitmapNWords(nBits) <= 5000);
+        hierarchicalBitmapInit(&b, words, nBits);
+        GREATEST_ASSERT_EQ(nBits, hierarchicalBitmapNextSet(&b, 0));
+        GREATEST_ASSERT_EQ(nBits, hierarchicalBitmapPrevSet(&b, nBits));
+        GREATEST_ASSERT_EQ(0, hierarchicalBitmapNextZero(&b, 0));
+
+        for (uint16_t round = 0; nBits > 0 && round < 400; round++) {
+            /* Set dense runs early on and thin them out later */
+            for (uint16_t i = 0; i < 50; i++) {
+                size_t const n = (rand64() % 4 == 0)
+                        ? rand64() % nBits
+                        : (rand64() % 64 + 64 * round) % nBits;
+
+                if (round < 200) {
+                    hierarchicalBitmapSet(&b, n);
+                } else {
+                    hierarchicalBitmapClear(&b, n);
+                }
+            }
+            for (uint8_t i = 0; i < 10; i++) {
+                size_t const n = rand64() % nBits;
+                size_t const m = rand64() % 200;
+                size_t next = n, prev = n, zero = n;
+
+                while (next < nBits && !bitGet(words[next / 64], next % 64)) {
+                    next++;
+                }
+                while (prev < nBits && !bitGet(words[prev / 64], prev % 64)) {
+                    prev = (prev > 0) ? prev - 1 : nBits;
+                }
+                while (zero < nBits && bitGet(words[zero / 64], zero % 64)) {
+                    zero++;
+                }
+                GREATEST_ASSERT_EQ(next, hierarchicalBitmapNextSet(&b, n));
+                GREATEST_ASSERT_EQ(prev, hierarchicalBitmapPrevSet(&b, n));
+                GREATEST_ASSERT_EQ(zero, hierarchicalBitmapNextZero(&b, n));
+                GREATEST_ASSERT_EQ(next >= n + m,
+                                   hierarchicalBitmapIsRangeEmpty(&b, n, m));
+                GREATEST_ASSERT_EQ(bitGet(words[n / 64], n % 64),
+                                   hierarchicalBitmapGet(&b, n));
+            }
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    hierarchicalBitmapNextZero_fullBitmap_NoneFound
+ * @testcase    @ref hierarchicalBitmapNextZero finds the cleared bits of a
+ * bitmap that is filled from the start, and none once it is full.
+ * @testvalues
+ * | Argument 1 | Argument 2  |
+ * | ---------- | ----------- |
+ * | 5000 bits  | 0 - 4999    |
+ */
+TEST
+hierarchicalBitmapNextZero_fullBitmap_NoneFound()
+{
+    static uint64_t words[100];
+    HierarchicalBitmap b;
+
+    hierarchicalBitmapInit(&b, words, 5000);
+    for (uint16_t i = 0; i < 5000; i++) {
+        GREATEST_ASSERT_EQ(i, hierarchicalBitmapNextZero(&b, 0));
+        hierarchicalBitmapSet(&b, i);
+    }
+    GREATEST_ASSERT_EQ(5000, hierarchicalBitmapNextZero(&b, 0));
+    hierarchicalBitmapClear(&b, 4999);
+    hierarchicalBitmapClear(&b, 700);
+    GREATEST_ASSERT_EQ(700, hierarchicalBitmapNextZero(&b, 0));
+    GREATEST_ASSERT_EQ(4999, hierarchicalBitmapNextZero(&b, 701));
+    GREATEST_ASSERT_EQ(4998, hierarchicalBitmapPrevSet(&b, 4999));
+
+    PASS();
+}
+
+/**
+ * @testname    priorityBitmap_randomPriorities_HighestFound
+ * @testcase    @ref priorityBitmapHighest and
+ * @ref atomicPriorityBitmapHighest find the highest of a random set of
+ * priorities as they are set and cleared.
+ * @testvalues
+ * | Argument               |
+ * | ---------------------- |
+ * | rand64() % 256         |
+ */
+TEST
+priorityBitmap_randomPriorities_HighestFound()
+{
+    PriorityBitmap b, a;
+    bool set[PRIORITY_BITMAP_LEVELS] = {false};
+
+    priorityBitmapInit(&b);
+    priorityBitmapInit(&a);
+    GREATEST_ASSERT_EQ(-1, priorityBitmapHighest(&b));
+    GREATEST_ASSERT_EQ(-1, atomicPriorityBitmapHighest(&a));
+    for (uint16_t i = 0; i < 2000; i++) {
+        uint16_t const p = rand64() % PRIORITY_BITMAP_LEVELS;
+        int16_t highest = -1;
+
+        /* Set more than clear at first, and the other way around later */
+        if ((rand64() % 2000) > i) {
+            priorityBitmapSet(&b, p);
+            atomicPriorityBitmapSet(&a, p);
+            set[p] = true;
+        } else {
+            priorityBitmapClear(&b, p);
+            atomicPriorityBitmapClear(&a, p);
+            set[p] = false;
+        }
+        for (int16_t q = 0; q < PRIORITY_BITMAP_LEVELS; q++) {
+            highest = set[q] ? q : highest;
+        }
+        GREATEST_ASSERT_EQ(highest, priorityBitmapHighest(&b));
+        GREATEST_ASSERT_EQ(highest, atomicPriorityBitmapHighest(&a));
+    }
+
+    PASS();
+}
+
+/** A thread of the priority bitmap stress test and its result. */
+typedef struct {
+    PriorityBitmap *b;      /**< Priority bitmap shared by the threads. */
+    uint16_t priority;      /**< Priority the thread sets and clears. */
+    uint32_t misses;        /**< Number of times the priority was missed. */
+} PriorityBitmapThread;
+
+/**
+ * Set the priority of a thread, check that the highest priority is at least
+ * that while it is set, and clear it again.
+ */
+static void *
+priorityBitmapThread(void *_arg)
+{
+    PriorityBitmapThread *const t = _arg;
+
+    for (uint32_t i = 0; i < 200000; i++) {
+        atomicPriorityBitmapSet(t->b, t->priority);
+        if (atomicPriorityBitmapHighest(t->b) < t->priority) {
+            t->misses++;
+        }
+        atomicPriorityBitmapClear(t->b, t->priority);
+    }
+
+    return (NULL);
+}
+
+/**
+ * @testname    atomicPriorityBitmap_concurrentSetAndClear_NeverMissed
+ * @testcase    @ref atomicPriorityBitmapHighest never reports a priority below
+ * one that is set, while other threads set and clear priorities in the same
+ * and in other words.
+ * @testvalues
+ * | Argument          |
+ * | ----------------- |
+ * | 4 threads         |
+ * | 130, 131, 70, 5   |
+ */
+TEST
+atomicPriorityBitmap_concurrentSetAndClear_NeverMissed()
+{
+    static uint16_t const priorities[4] = {130, 131, 70, 5};
+    PriorityBitmap b;
+    PriorityBitmapThread t[4];
+    pthread_t threads[4];
+
+    priorityBitmapInit(&b);
+    for (uint8_t i = 0; i < 4; i++) {
+        t[i].b = &b;
+        t[i].priority = priorities[i];
+        t[i].misses = 0;
+        GREATEST_ASSERT_EQ(0, pthread_create(&threads[i], NULL,
+                priorityBitmapThread, &t[i]));
+    }
+    for (uint8_t i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+        GREATEST_ASSERT_EQ(0, t[i].misses);
+    }
+    GREATEST_ASSERT_EQ(-1, atomicPriorityBitmapHighest(&b));
+
+    PASS();
+}
+
+/**
+ * @testname    timingWheel_randomTimers_ExpireOnTime
+ * @testcase    @ref timingWheelAdvance expires every started timer in the
+ * advance that passes its expiry, and no cancelled timer, for expiries on all
+ * levels and beyond.
+ * @testvalues
+ * | Argument 1            | Argument 2          |
+ * | --------------------- | ------------------- |
+ * | 1000 timers           | now + 0 - 2^40      |
+ */
+TEST
+timingWheel_randomTimers_ExpireOnTime()
+{
+    static TimingWheel w;
+    static TimingWheelTimer timers[1000];
+    static bool started[1000];
+    uint64_t const start = rand64() >> 30;
+    uint64_t now = start;
+    TimingWheelTimer expired;
+    size_t nStarted = 0;
+
+    timingWheelInit(&w, start);
+    GREATEST_ASSERT_EQ(UINT64_MAX, timingWheelNextTick(&w));
+    for (uint16_t i = 0; i < 1000; i++) {
+        /* Expiries in the past, on every level and beyond the top level */
+        uint64_t const e = start - 5 + (rand64() >> (rand64() % 64));
+
+        timingWheelTimerInit(&timers[i]);
+        timingWheelInsert(&w, &timers[i], e);
+        started[i] = true;
+        nStarted++;
+    }
+    for (uint16_t i = 0; i < 1000; i += 7) {
+        timingWheelCancel(&w, &timers[i]);
+        started[i] = false;
+        nStarted--;
+    }
+
+    while (nStarted > 0) {
+        uint64_t const next = timingWheelNextTick(&w);
+        uint64_t const step = rand64() >> (rand64() % 64);
+        uint64_t const to = (step < UINT64_MAX - 1 - now) ? now + step
+                : UINT64_MAX - 1;
+        size_t n;
+
+        /* No timer expires before the next tick with work */
+        for (uint16_t i = 0; i < 1000; i++) {
+            GREATEST_ASSERT(!started[i] || timers[i].expiry >= next
+                            || timers[i].expiry < start);
+        }
+        timingWheelTimerInit(&expired);
+        n = timingWheelAdvance(&w, to, &expired);
+        for (TimingWheelTimer *x = expired.next; x != &expired; x = x->next) {
+            uint16_t const i = x - timers;
+
+            GREATEST_ASSERT(started[i]);
+            GREATEST_ASSERT(x->expiry <= to);
+            GREATEST_ASSERT(x->expiry >= now || x->expiry < start);
+            started[i] = false;
+            nStarted--;
+            n--;
+        }
+        GREATEST_ASSERT_EQ(0, n);
+        for (uint16_t i = 0; i < 1000; i++) {
+            GREATEST_ASSERT(!started[i] || timers[i].expiry > to);
+        }
+        now = to + 1;
+    }
+    GREATEST_ASSERT_EQ(UINT64_MAX, timingWheelNextTick(&w));
+
+    PASS();
+}
+
+/**
+ * @testname    slabAllocator_fillAndFree_ObjectsReused
+ * @testcase    @ref slabAllocatorAlloc hands out every object once until all
+ * slabs are full, reuses the objects freed by the owner and by
+ * @ref atomicSlabAllocatorFree, and refills from the fullest slab.
+ * @testvalues
+ * | Argument 1            | Argument 2          |
+ * | --------------------- | ------------------- |
+ * | 4 slabs               | 128 objects of 24 B |
+ */
+TEST
+slabAllocator_fillAndFree_ObjectsReused()
+{
+    static uint8_t objects[4 * 128 * 24];
+    static uint64_t words[4 * 2 * 2];
+    static bool allocated[4 * 128];
+    SlabAllocator a;
+
+    GREATEST_ASSERT_EQ(16, slabAllocatorNWords(4, 128));
+    slabAllocatorInit(&a, objects, 24, words, 4, 128);
+    for (size_t i = 0; i < 4 * 128; i++) {
+        uint8_t *const o = slabAllocatorAlloc(&a);
+        size_t const n = (o - objects) / 24;
+
+        GREATEST_ASSERT(o != NULL);
+        GREATEST_ASSERT_EQ(0, (o - objects) % 24);
+        GREATEST_ASSERT(n < 4 * 128 && !allocated[n]);
+        allocated[n] = true;
+    }
+    GREATEST_ASSERT(slabAllocatorAlloc(&a) == NULL);
+    GREATEST_ASSERT_EQ(128, slabAllocatorOccupancy(&a, 2));
+
+    /* Free 10 objects of slab 1 and 3 of slab 2, partly from "other threads" */
+    for (size_t i = 0; i < 10; i++) {
+        slabAllocatorFree(&a, &objects[(128 + 12 * i) * 24]);
+    }
+    for (size_t i = 0; i < 3; i++) {
+        atomicSlabAllocatorFree(&a, &objects[(2 * 128 + 40 * i + 1) * 24]);
+    }
+    GREATEST_ASSERT_EQ(118, slabAllocatorOccupancy(&a, 1));
+    GREATEST_ASSERT_EQ(1, slabAllocatorReclaimCandidate(&a));
+    for (size_t i = 0; i < 13; i++) {
+        uint8_t *const o = slabAllocatorAlloc(&a);
+
+        GREATEST_ASSERT(o != NULL);
+        GREATEST_ASSERT_EQ((i < 3) ? 2 : 1, (o - objects) / 24 / 128);
+    }
+    GREATEST_ASSERT(slabAllocatorAlloc(&a) == NULL);
+
+    /* Empty slab 3 so that it can be reclaimed */
+    for (size_t i = 3 * 128; i < 4 * 128; i++) {
+        atomicSlabAllocatorFree(&a, &objects[i * 24]);
+    }
+    GREATEST_ASSERT_EQ(3, slabAllocatorReclaimCandidate(&a));
+    GREATEST_ASSERT_EQ(0, slabAllocatorOccupancy(&a, 3));
+
+    PASS();
+}
+
+/**
+ * @testname    findZeroRun_randomRuns_FirstAndBestFitFound
+ * @testcase    @ref findZeroRun, @ref findZeroRunBestFit,
+ * @ref zeroRunIndexFirstFit and @ref zeroRunIndexBestFit find the same runs
+ * of zeros as a bit by bit search, while ranges are set and cleared.
+ * @testvalues
+ * | Argument 1            | Argument 2          | Argument 3          |
+ * | --------------------- | ------------------- | ------------------- |
+ * | 3000 bits             | 1 - 1000 zeros      | rand64() % 3000     |
+ */
+TEST
+findZeroRun_randomRuns_FirstAndBestFitFound()
+{
+    static uint64_t bits[BITBUF_NWORDS(3000)];
+    static uint16_t summary[3 * 6];
+    size_t const nBits = 3000;
+    ZeroRunIndex x;
+
+    GREATEST_ASSERT_EQ(6, zeroRunIndexNChunks(nBits));
+    /* Runs of ones and zeros of random lengths */
+    for (size_t i = 0; i < nBits;) {
+        size_t const n = 1 + rand64() % ((rand64() % 2) ? 8 : 300);
+        bool const f = rand64() % 2;
+
+        fillBits(bits, i, (i + n < nBits) ? n : nBits - i, f);
+        i += n;
+    }
+    zeroRunIndexInit(&x, bits, nBits, summary);
+
+    for (uint16_t i = 0; i < 500; i++) {
+        size_t const length = 1 + rand64() % ((i % 2) ? 70 : 1000);
+        size_t const hint = rand64() % nBits;
+        size_t first = nBits;
+        size_t best = nBits;
+        size_t bestLength = SIZE_MAX;
+        size_t run = 0;
+
+        /* Bit by bit, from the hint and then wrapping around */
+        for (size_t n = 0; n < nBits && first == nBits; n++) {
+            size_t const p = (hint + n) % nBits;
+            size_t z = 0;
+
+            while (p + z < nBits && z < length
+                    && ((bits[(p + z) / 64] >> ((p + z) % 64)) & 1) == 0) {
+                z++;
+            }
+            first = (z == length) ? p : first;
+        }
+        for (size_t n = 0; n <= nBits; n++) {
+            if (n < nBits && ((bits[n / 64] >> (n % 64)) & 1) == 0) {
+                run++;
+            } else {
+                if (run >= length && run < bestLength) {
+                    best = n - run;
+                    bestLength = run;
+                }
+                run = 0;
+            }
+        }
+        GREATEST_ASSERT_EQ(first, findZeroRun(bits, nBits, length, hint));
+        GREATEST_ASSERT_EQ(first, zeroRunIndexFirstFit(&x, length, hint));
+        GREATEST_ASSERT_EQ(best, findZeroRunBestFit(bits, nBits, length));
+        GREATEST_ASSERT_EQ(best, zeroRunIndexBestFit(&x, length));
+
+        /* Allocate the run found, or free a random range */
+        if (first < nBits && i % 3 != 0) {
+            zeroRunIndexFill(&x, first, length, 1);
+        } else {
+            size_t const offset = rand64() % nBits;
+
+            zeroRunIndexFill(&x, offset, rand64() % (nBits - offset + 1),
+                             rand64() % 2);
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    workDeque_pushPopSteal_TasksTakenOnce
+ * @testcase    @ref atomicWorkDequePop takes the newest task,
+ * @ref atomicWorkDequeSteal the oldest, and every task is taken once.
+ * @testvalues
+ * | Argument 1            | Argument 2          |
+ * | --------------------- | ------------------- |
+ * | Capacity 16           | 1000 random actions |
+ */
+TEST
+workDeque_pushPopSteal_TasksTakenOnce()
+{
+    uint64_t tasks[16];
+    uint64_t model[1000];
+    size_t top = 0;
+    size_t bottom = 0;
+    WorkDeque d;
+    uint64_t task;
+
+    workDequeInit(&d, tasks, 16);
+    GREATEST_ASSERT(!atomicWorkDequePop(&d, &task));
+    GREATEST_ASSERT(!atomicWorkDequeSteal(&d, &task));
+    for (uint64_t i = 0; i < 1000; i++) {
+        switch (rand64() % 3) {
+        case 0:
+            GREATEST_ASSERT_EQ(bottom - top < 16,
+                               atomicWorkDequePush(&d, i));
+            if (bottom - top < 16) {
+                model[bottom++] = i;
+            }
+            break;
+        case 1:
+            GREATEST_ASSERT_EQ(bottom > top, atomicWorkDequePop(&d, &task));
+            if (bottom > top) {
+                GREATEST_ASSERT_EQ(model[--bottom], task);
+            }
+            break;
+        default:
+            GREATEST_ASSERT_EQ(bottom > top, atomicWorkDequeSteal(&d, &task));
+            if (bottom > top) {
+                GREATEST_ASSERT_EQ(model[top++], task);
+            }
+            break;
+        }
+    }
+
+    PASS();
+}
+
+/** A worker of the work-stealing stress test. */
+typedef struct {
+    WorkDeque *deques;      /**< Deques of all workers. */
+    uint64_t *nonEmpty;     /**< Bitmap of the workers with tasks. */
+    uint8_t *taken;         /**< Number of times each task was taken. */
+    size_t self;            /**< Number of the worker. */
+} WorkStealingThread;
+
+/** Count that a task was taken. */
+static void
+workStealingTake(void *_context, uint64_t _task)
+{
+    uint8_t *const taken = _context;
+
+    __atomic_fetch_add(&taken[_task], 1, __ATOMIC_RELAXED);
+
+    return;
+}
+
+/**
+ * Push the tasks of a worker and pop some of them while the other workers
+ * steal, and then run the tasks that are left with @ref atomicWorkerRun.
+ */
+static void *
+workStealingThread(void *_arg)
+{
+    WorkStealingThread *const t = _arg;
+    WorkDeque *const d = &t->deques[t->self];
+    uint64_t task;
+
+    for (uint64_t i = 0; i < 20000; i++) {
+        /* Pop when the deque is full, and one of every three pushes */
+        while (!atomicWorkDequePush(d, t->self * 20000 + i)) {
+            if (atomicWorkDequePop(d, &task)) {
+                workStealingTake(t->taken, task);
+            }
+        }
+        atomicBitSet(t->nonEmpty, t->self);
+        if (i % 3 == 2 && atomicWorkDequePop(d, &task)) {
+            workStealingTake(t->taken, task);
+        }
+    }
+    atomicWorkerRun(t->deques, t->nonEmpty, 4, t->self, workStealingTake,
+                    t->taken);
+
+    return (NULL);
+}
+
+/**
+ * @testname    atomicWorkerRun_concurrentPushPopSteal_TasksTakenOnce
+ * @testcase    Every task is taken exactly once while the owners of the
+ * deques push and pop tasks and the other workers steal them with
+ * @ref atomicWorkerRun, and no worker is left marked as non-empty.
+ * @testvalues
+ * | Argument 1            | Argument 2          |
+ * | --------------------- | ------------------- |
+ * | 4 threads             | 20000 tasks each    |
+ */
+TEST
+atomicWorkerRun_concurrentPushPopSteal_TasksTakenOnce()
+{
+    static uint8_t taken[4 * 20000];
+    static uint64_t tasks[4][256];
+    WorkDeque deques[4];
+    uint64_t nonEmpty = 0;
+    WorkStealingThread t[4];
+    pthread_t threads[4];
+
+    memset(taken, 0, sizeof(taken));
+    for (uint8_t i = 0; i < 4; i++) {
+        workDequeInit(&deques[i], tasks[i], 256);
+    }
+    for (uint8_t i = 0; i < 4; i++) {
+        t[i].deques = deques;
+        t[i].nonEmpty = &nonEmpty;
+        t[i].taken = taken;
+        t[i].self = i;
+        GREATEST_ASSERT_EQ(0, pthread_create(&threads[i], NULL,
+                workStealingThread, &t[i]));
+    }
+    for (uint8_t i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    for (size_t i = 0; i < 4 * 20000; i++) {
+        GREATEST_ASSERT_EQ(1, taken[i]);
+    }
+    GREATEST_ASSERT_EQ(0, nonEmpty);
+
+    PASS();
+}
+
+/**
+ * @testname    atomicStealVictim_randomWorkers_NextNonEmptyPicked
+ * @testcase    @ref atomicStealVictim picks the first worker with a non-empty
+ * deque after the thief, wrapping around, and never the thief.
+ * @testvalues
+ * | Argument 1            | Argument 2          |
+ * | --------------------- | ------------------- |
+ * | 1 - 200 workers       | rand64() % workers  |
+ */
+TEST
+atomicStealVictim_randomWorkers_NextNonEmptyPicked()
+{
+    for (uint16_t i = 0; i < 1000; i++) {
+        size_t const nWorkers = 1 + rand64() % 200;
+        size_t const thief = rand64() % nWorkers;
+        uint64_t nonEmpty[BITBUF_NWORDS(200)] = {0};
+        size_t victim = nWorkers;
+
+        for (size_t n = rand64() % 4; n > 0; n--) {
+            atomicBitSet(nonEmpty, rand64() % nWorkers);
+        }
+        for (size_t n = 1; n < nWorkers && victim == nWorkers; n++) {
+            size_t const v = (thief + n) % nWorkers;
+
+            victim = ((nonEmpty[v / 64] >> (v % 64)) & 1) ? v : victim;
+        }
+        GREATEST_ASSERT_EQ(victim,
+                           atomicStealVictim(nonEmpty, nWorkers, thief));
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    bufferPartition_randomBuffers_ChunksCombined
+ * @testcase    @ref bufferPartition splits a buffer in contiguous chunks of
+ * whole cache lines, and the results of @ref countBits, @ref parityBits,
+ * @ref xorBits and @ref reverseBits on the chunks combine to the results on
+ * the whole buffer.
+ * @testvalues
+ * | Argument 1            | Argument 2          | Argument 3          |
+ * | --------------------- | ------------------- | ------------------- |
+ * | 0 - 1999 words        | 1 - 300 words       | 1 - 8 threads       |
+ */
+TEST
+bufferPartition_randomBuffers_ChunksCombined()
+{
+    static uint64_t a[2000], b[2000], x[2000], r[2000], rc[2000];
+
+    for (uint16_t i = 0; i < 200; i++) {
+        size_t const nWords = rand64() % 2000;
+        size_t const minWords = 1 + rand64() % 300;
+        size_t const nThreads = 1 + rand64() % 8;
+        size_t next = 0;
+        uint64_t count = 0;
+        uint64_t n = 0;
+        bool parity = false;
+        bool p = false;
+
+        for (size_t w = 0; w < nWords; w++) {
+            a[w] = rand64();
+            b[w] = rand64();
+            count += nBitsSet64(a[w]);
+            p ^= isOddParity(a[w]);
+            for (uint8_t j = 0; j < 64; j++) {
+                BIT_CLEAR(r[nWords - 1 - w], 63 - j);
+                r[nWords - 1 - w] |= ((a[w] >> j) & 1) << (63 - j);
+            }
+        }
+        for (size_t t = 0; t < nThreads; t++) {
+            size_t first;
+            size_t const words = bufferPartition(&first, nWords, minWords,
+                                                 nThreads, t);
+
+            if (words > 0) {
+                GREATEST_ASSERT_EQ(next, first);
+                GREATEST_ASSERT(first + words == nWords || words % 8 == 0);
+                GREATEST_ASSERT(t == 0 || words >= minWords
+                                || first + words == nWords);
+                n += countBits(&a[first], words);
+                parity ^= parityBits(&a[first], words);
+                xorBits(&x[first], &a[first], &b[first], words);
+                reverseBits(&rc[nWords - first - words], &a[first], words);
+                next = first + words;
+            }
+        }
+        GREATEST_ASSERT_EQ(nWords, next);
+        GREATEST_ASSERT_EQ(count, n);
+        GREATEST_ASSERT_EQ(p, parity);
+        GREATEST_ASSERT_EQ(count, countBits(a, nWords));
+        GREATEST_ASSERT_EQ(p, parityBits(a, nWords));
+        for (size_t w = 0; w < nWords; w++) {
+            GREATEST_ASSERT_EQ(a[w] ^ b[w], x[w]);
+            GREATEST_ASSERT_EQ(r[w], rc[w]);
+        }
+        andBits(x, a, b, nWords);
+        orBits(rc, a, b, nWords);
+        for (size_t w = 0; w < nWords; w++) {
+            GREATEST_ASSERT_EQ(a[w] & b[w], x[w]);
+            GREATEST_ASSERT_EQ(a[w] | b[w], rc[w]);
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    parallelBits_randomBuffers_SameAsSingleThreaded
+ * @testcase    The parallel large-buffer functions give the results of
+ * @ref countBits, @ref parityBits, @ref andBits, @ref orBits, @ref xorBits
+ * and @ref reverseBits, with and without pinned threads, and for buffers of
+ * a single chunk.
+ * @testvalues
+ * | Argument 1            | Argument 2          | Argument 3          |
+ * | --------------------- | ------------------- | ------------------- |
+ * | 0 - 19999 words       | 1 - 3000 words      | 1 - 8 threads       |
+ */
+TEST
+parallelBits_randomBuffers_SameAsSingleThreaded()
+{
+    static uint64_t a[20000], b[20000], x[20000], y[20000];
+
+    for (uint8_t i = 0; i < 50; i++) {
+        size_t const nWords = rand64() % 20000;
+        BufferThreads t;
+
+        bufferThreadsInit(&t, 1 + rand64() % 8, i % 2);
+        t.minWords = 1 + rand64() % 3000;
+        memset(x, 0xFF, sizeof(x));
+        parallelClearBits(&t, x, nWords);
+        for (size_t w = 0; w < nWords; w++) {
+            GREATEST_ASSERT_EQ(0, x[w]);
+            a[w] = rand64();
+            b[w] = rand64();
+        }
+        GREATEST_ASSERT_EQ(countBits(a, nWords),
+                           parallelCountBits(&t, a, nWords));
+        GREATEST_ASSERT_EQ(parityBits(a, nWords),
+                           parallelParityBits(&t, a, nWords));
+        andBits(x, a, b, nWords);
+        parallelAndBits(&t, y, a, b, nWords);
+        GREATEST_ASSERT_EQ(0, memcmp(x, y, nWords * sizeof(*x)));
+        orBits(x, a, b, nWords);
+        parallelOrBits(&t, y, a, b, nWords);
+        GREATEST_ASSERT_EQ(0, memcmp(x, y, nWords * sizeof(*x)));
+        xorBits(x, a, b, nWords);
+        parallelXorBits(&t, y, a, b, nWords);
+        GREATEST_ASSERT_EQ(0, memcmp(x, y, nWords * sizeof(*x)));
+        reverseBits(x, a, nWords);
+        parallelReverseBits(&t, y, a, nWords);
+        GREATEST_ASSERT_EQ(0, memcmp(x, y, nWords * sizeof(*x)));
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    orBitsN_randomBuffers_AggregatedAndCounted
+ * @testcase    @ref orBitsN and @ref andBitsN give the OR and AND of all
+ * buffers, with and without a result buffer, and on the chunks of
+ * @ref bufferPartition.
+ * @testvalues
+ * | Argument 1            | Argument 2          |
+ * | --------------------- | ------------------- |
+ * | 1 - 20 buffers        | 0 - 1999 words      |
+ */
+TEST
+orBitsN_randomBuffers_AggregatedAndCounted()
+{
+    static uint64_t bufs[20][2000];
+    static uint64_t orResult[2000], andResult[2000], dst[2000];
+    uint64_t const *srcs[20];
+
+    for (uint16_t i = 0; i < 50; i++) {
+        size_t const nSrcs = 1 + rand64() % 20;
+        size_t const nWords = rand64() % 2000;
+        uint64_t nOr = 0;
+        uint64_t nAnd = 0;
+        uint64_t n = 0;
+
+        for (size_t s = 0; s < nSrcs; s++) {
+            srcs[s] = bufs[s];
+            for (size_t w = 0; w < nWords; w++) {
+                /* Mostly set bits, and zero blocks for the AND */
+                bufs[s][w] = (rand64() % 8 == 0) ? 0 : rand64() | rand64();
+            }
+        }
+        for (size_t w = 0; w < nWords; w++) {
+            orResult[w] = 0;
+            andResult[w] = ~0ULL;
+            for (size_t s = 0; s < nSrcs; s++) {
+                orResult[w] |= bufs[s][w];
+                andResult[w] &= bufs[s][w];
+            }
+            nOr += nBitsSet64(orResult[w]);
+            nAnd += nBitsSet64(andResult[w]);
+        }
+
+        GREATEST_ASSERT_EQ(nOr, orBitsN(NULL, srcs, nSrcs, 0, nWords));
+        GREATEST_ASSERT_EQ(nAnd, andBitsN(NULL, srcs, nSrcs, 0, nWords));
+        GREATEST_ASSERT_EQ(nOr, orBitsN(dst, srcs, nSrcs, 0, nWords));
+        for (size_t w = 0; w < nWords; w++) {
+            GREATEST_ASSERT_EQ(orResult[w], dst[w]);
+        }
+        for (size_t t = 0; t < 3; t++) {
+            size_t first;
+            size_t const words = bufferPartition(&first, nWords, 100, 3, t);
+
+            n += andBitsN(dst, srcs, nSrcs, first, words);
+        }
+        GREATEST_ASSERT_EQ(nAnd, n);
+        for (size_t w = 0; w < nWords; w++) {
+            GREATEST_ASSERT_EQ(andResult[w], dst[w]);
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    intersectSorted_randomSets_SameAsBitmaps
+ * @testcase    @ref intersectSorted, @ref uniteSorted and
+ * @ref subtractSorted give the same sets and counts as the AND, OR and AND
+ * NOT of the bitmaps of @ref sortedToBits, read back with
+ * @ref bitsToSorted, for similar and very different set sizes.
+ * @testvalues
+ * | Argument 1            | Argument 2            |
+ * | --------------------- | --------------------- |
+ * | 0 - 4000 of 0 - 8191  | 0 - 4000 of 0 - 8191  |
+ */
+TEST
+intersectSorted_randomSets_SameAsBitmaps()
+{
+    static uint32_t a[4000], b[4000], expected[8000], result[8000];
+    static uint64_t bitsA[BITBUF_NWORDS(8192)], bitsB[BITBUF_NWORDS(8192)];
+    static uint64_t bits[BITBUF_NWORDS(8192)];
+    size_t const nWords = BITBUF_NWORDS(8192);
+
+    for (uint16_t i = 0; i < 300; i++) {
+        /* Sets of random densities, from a few values to half of them */
+        uint16_t const pA = rand64() % ((i % 2) ? 500 : 5);
+        uint16_t const pB = rand64() % ((i % 3) ? 500 : 5);
+        size_t nA = 0;
+        size_t nB = 0;
+        size_t n;
+
+        for (uint32_t v = 0; v < 8192; v++) {
+            if (rand64() % 1000 < pA && nA < 4000) {
+                a[nA++] = v;
+            }
+            if (rand64() % 1000 < pB && nB < 4000) {
+                b[nB++] = v;
+            }
+        }
+        memset(bitsA, 0, sizeof(bitsA));
+        memset(bitsB, 0, sizeof(bitsB));
+        sortedToBits(bitsA, a, nA);
+        sortedToBits(bitsB, b, nB);
+        GREATEST_ASSERT_EQ(nA, bitsToSorted(result, bitsA, nWords));
+        GREATEST_ASSERT_EQ(0, memcmp(a, result, nA * sizeof(*a)));
+
+        andBits(bits, bitsA, bitsB, nWords);
+        n = bitsToSorted(expected, bits, nWords);
+        GREATEST_ASSERT_EQ(n, intersectSorted(NULL, a, nA, b, nB));
+        GREATEST_ASSERT_EQ(n, intersectSorted(result, a, nA, b, nB));
+        GREATEST_ASSERT_EQ(0, memcmp(expected, result, n * sizeof(*a)));
+        GREATEST_ASSERT_EQ(n, intersectSorted(result, b, nB, a, nA));
+        GREATEST_ASSERT_EQ(0, memcmp(expected, result, n * sizeof(*a)));
+
+        orBits(bits, bitsA, bitsB, nWords);
+        n = bitsToSorted(expected, bits, nWords);
+        GREATEST_ASSERT_EQ(n, uniteSorted(NULL, a, nA, b, nB));
+        GREATEST_ASSERT_EQ(n, uniteSorted(result, a, nA, b, nB));
+        GREATEST_ASSERT_EQ(0, memcmp(expected, result, n * sizeof(*a)));
+
+        for (size_t w = 0; w < nWords; w++) {
+            bits[w] = bitsA[w] & ~bitsB[w];
+        }
+        n = bitsToSorted(expected, bits, nWords);
+        GREATEST_ASSERT_EQ(n, subtractSorted(NULL, a, nA, b, nB));
+        GREATEST_ASSERT_EQ(n, subtractSorted(result, a, nA, b, nB));
+        GREATEST_ASSERT_EQ(0, memcmp(expected, result, n * sizeof(*a)));
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    bitSlicedIndex_randomColumns_PredicatesEvaluated
+ * @testcase    @ref bitSlicedIndexBetween and the comparisons built on it
+ * select the same rows as comparing the values, @ref bitSlicedIndexSum sums
+ * them, and @ref bitSlicedIndexTopK selects the rows with the largest values.
+ * @testvalues
+ * | Argument 1            | Argument 2          | Argument 3          |
+ * | --------------------- | ------------------- | ------------------- |
+ * | 0 - 2999 rows         | 1 - 32 bits         | Random bounds       |
+ */
+TEST
+bitSlicedIndex_randomColumns_PredicatesEvaluated()
+{
+    static uint32_t values[3000];
+    static uint64_t slices[32 * BITBUF_NWORDS(3000)];
+    static uint64_t dst[BITBUF_NWORDS(3000)], scratch[BITBUF_NWORDS(3000)];
+    BitSlicedIndex x;
+
+    for (uint16_t i = 0; i < 100; i++) {
+        size_t const nRows = rand64() % 3000;
+        uint8_t const nSlices = 1 + rand64() % 32;
+        uint64_t const max = (1ULL << nSlices) - 1;
+        uint32_t const lo = rand64() & max;
+        uint32_t const hi = (rand64() % 4 == 0) ? UINT32_MAX : rand64() & max;
+        size_t const k = rand64() % (nRows + 10);
+        uint64_t sum = 0;
+        uint64_t filteredSum = 0;
+        size_t n = 0;
+        uint32_t smallest = UINT32_MAX;
+        bool skipped = false;
+        uint32_t c;
+
+        GREATEST_ASSERT_EQ(nSlices * BITBUF_NWORDS(nRows),
+                           bitSlicedIndexNWords(nRows, nSlices));
+        bitSlicedIndexInit(&x, slices, nRows, nSlices);
+        for (size_t r = 0; r < nRows; r++) {
+            /* Few distinct values at times, for equal values and ties */
+            values[r] = (i % 2) ? rand64() & max : values[rand64() % 5] & max;
+            sum += values[r];
+        }
+        if (i % 3 == 0) {
+            for (size_t r = 0; r < nRows; r++) {
+                bitSlicedIndexSet(&x, r, values[r]);
+            }
+        } else {
+            bitSlicedIndexLoad(&x, values, nRows);
+        }
+        for (size_t r = 0; r < nRows; r++) {
+            GREATEST_ASSERT_EQ(values[r], bitSlicedIndexGet(&x, r));
+        }
+        c = (nRows > 0) ? values[rand64() % nRows] : 0;
+
+        n = bitSlicedIndexBetween(&x, dst, lo, hi);
+        for (size_t r = 0; r < nRows; r++) {
+            bool const selected = (dst[r / 64] >> (r % 64)) & 1;
+
+            GREATEST_ASSERT_EQ(values[r] >= lo && values[r] <= hi, selected);
+            filteredSum += selected ? values[r] : 0;
+            n -= selected;
+        }
+        GREATEST_ASSERT_EQ(0, n);
+        GREATEST_ASSERT_EQ(sum, bitSlicedIndexSum(&x, NULL));
+        GREATEST_ASSERT_EQ(filteredSum, bitSlicedIndexSum(&x, dst));
+
+        bitSlicedIndexLess(&x, dst, lo);
+        for (size_t r = 0; r < nRows; r++) {
+            GREATEST_ASSERT_EQ(values[r] < lo, (dst[r / 64] >> (r % 64)) & 1);
+        }
+        bitSlicedIndexLessEqual(&x, dst, lo);
+        for (size_t r = 0; r < nRows; r++) {
+            GREATEST_ASSERT_EQ(values[r] <= lo, (dst[r / 64] >> (r % 64)) & 1);
+        }
+        bitSlicedIndexEqual(&x, dst, c);
+        for (size_t r = 0; r < nRows; r++) {
+            GREATEST_ASSERT_EQ(values[r] == c, (dst[r / 64] >> (r % 64)) & 1);
+        }
+
+        /* The selected rows have the largest values, the first ones of ties */
+        GREATEST_ASSERT_EQ((k < nRows) ? k : nRows,
+                           bitSlicedIndexTopK(&x, dst, scratch, k));
+        for (size_t r = 0; r < nRows; r++) {
+            if ((dst[r / 64] >> (r % 64)) & 1) {
+                smallest = (values[r] < smallest) ? values[r] : smallest;
+            }
+        }
+        for (size_t r = 0; r < nRows; r++) {
+            bool const selected = (dst[r / 64] >> (r % 64)) & 1;
+
+            GREATEST_ASSERT(selected || values[r] <= smallest);
+            GREATEST_ASSERT(!selected || values[r] != smallest || !skipped);
+            skipped |= !selected && values[r] == smallest;
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    selectCompare_randomColumns_SameAsComparingRows
+ * @testcase    @ref selectCompareInt8 to @ref selectInDouble select the same
+ * rows as comparing the rows one by one, for every comparison and way of
+ * combining the selection, without null rows and keeping the bits beyond
+ * the rows.
+ * @testvalues
+ * | Argument 1            | Argument 2          | Argument 3          |
+ * | --------------------- | ------------------- | ------------------- |
+ * | 0 - 299 rows          | -100 - 100, NaN     | -100 - 100          |
+ */
+TEST
+selectCompare_randomColumns_SameAsComparingRows()
+{
+    int8_t i8[300];
+    int16_t i16[300];
+    int32_t i32[300];
+    int64_t i64[300];
+    float f32[300];
+    double f64[300];
+    uint64_t valid[BITBUF_NWORDS(300)];
+    uint64_t before[BITBUF_NWORDS(300)];
+    uint64_t expected[2][BITBUF_NWORDS(300)];
+    uint64_t dst[6][BITBUF_NWORDS(300)];
+
+    for (uint16_t i = 0; i < 1000; i++) {
+        size_t const n = rand64() % 300;
+        uint8_t const kind = rand64() % 3;
+        CompareOp const op = rand64() % 6;
+        SelectMode const mode = rand64() % 3;
+        int8_t const c[3] = {rand64() % 201 - 100, rand64() % 201 - 100,
+                             rand64() % 201 - 100};
+        uint64_t const *const v = (rand64() % 2) ? valid : NULL;
+        size_t count[2] = {0, 0};
+        size_t counts[6];
+
+        for (size_t r = 0; r < n; r++) {
+            i8[r] = rand64() % 201 - 100;
+            i16[r] = i8[r];
+            i32[r] = i8[r];
+            i64[r] = i8[r];
+            f32[r] = (rand64() % 50 == 0) ? NAN : i8[r];
+            f64[r] = f32[r];
+        }
+        for (size_t w = 0; w < BITBUF_NWORDS(300); w++) {
+            valid[w] = rand64();
+            before[w] = rand64();
+            expected[0][w] = before[w];
+            expected[1][w] = before[w];
+        }
+
+        /* Integer rows, and floating point rows with NaN */
+        for (uint8_t t = 0; t < 2; t++) {
+            for (size_t r = 0; r < n; r++) {
+                double const x = (t == 0) ? i8[r] : f64[r];
+                bool const old = (before[r / 64] >> (r % 64)) & 1;
+                bool s;
+
+                if (kind == 0) {
+                    s = (op == COMPARE_LESS) ? x < c[0]
+                            : (op == COMPARE_LESS_EQUAL) ? x <= c[0]
+                            : (op == COMPARE_EQUAL) ? x == c[0]
+                            : (op == COMPARE_NOT_EQUAL) ? x != c[0]
+                            : (op == COMPARE_GREATER_EQUAL) ? x >= c[0]
+                            : x > c[0];
+                } else if (kind == 1) {
+                    s = x >= c[0] && x <= c[1];
+                } else {
+                    s = x == c[0] || x == c[1] || x == c[2];
+                }
+                s = s && (v == NULL || ((v[r / 64] >> (r % 64)) & 1));
+                s = (mode == SELECT_AND) ? s && old
+                        : (mode == SELECT_OR) ? s || old : s;
+                BIT_CLEAR(expected[t][r / 64], r % 64);
+                expected[t][r / 64] |= (uint64_t)s << (r % 64);
+                count[t] += s;
+            }
+        }
+
+        for (uint8_t k = 0; k < 6; k++) {
+            memcpy(dst[k], before, sizeof(before));
+        }
+        if (kind == 0) {
+            counts[0] = selectCompareInt8(dst[0], i8, v, n, op, c[0], mode);
+            counts[1] = selectCompareInt16(dst[1], i16, v, n, op, c[0], mode);
+            counts[2] = selectCompareInt32(dst[2], i32, v, n, op, c[0], mode);
+            counts[3] = selectCompareInt64(dst[3], i64, v, n, op, c[0], mode);
+            counts[4] = selectCompareFloat(dst[4], f32, v, n, op, c[0], mode);
+            counts[5] = selectCompareDouble(dst[5], f64, v, n, op, c[0],
+                                            mode);
+        } else if (kind == 1) {
+            counts[0] = selectBetweenInt8(dst[0], i8, v, n, c[0], c[1], mode);
+            counts[1] = selectBetweenInt16(dst[1], i16, v, n, c[0], c[1],
+                                           mode);
+            counts[2] = selectBetweenInt32(dst[2], i32, v, n, c[0], c[1],
+                                           mode);
+            counts[3] = selectBetweenInt64(dst[3], i64, v, n, c[0], c[1],
+                                           mode);
+            counts[4] = selectBetweenFloat(dst[4], f32, v, n, c[0], c[1],
+                                           mode);
+            counts[5] = selectBetweenDouble(dst[5], f64, v, n, c[0], c[1],
+                                            mode);
+        } else {
+            int16_t const s16[3] = {c[0], c[1], c[2]};
+            int32_t const s32[3] = {c[0], c[1], c[2]};
+            int64_t const s64[3] = {c[0], c[1], c[2]};
+            float const sf[3] = {c[0], c[1], c[2]};
+            double const sd[3] = {c[0], c[1], c[2]};
+
+            counts[0] = selectInInt8(dst[0], i8, v, n, c, 3, mode);
+            counts[1] = selectInInt16(dst[1], i16, v, n, s16, 3, mode);
+            counts[2] = selectInInt32(dst[2], i32, v, n, s32, 3, mode);
+            counts[3] = selectInInt64(dst[3], i64, v, n, s64, 3, mode);
+            counts[4] = selectInFloat(dst[4], f32, v, n, sf, 3, mode);
+            counts[5] = selectInDouble(dst[5], f64, v, n, sd, 3, mode);
+        }
+        for (uint8_t k = 0; k < 6; k++) {
+            GREATEST_ASSERT_EQ(count[k >= 4], counts[k]);
+            GREATEST_ASSERT_EQ(0, memcmp(expected[k >= 4], dst[k],
+                                         sizeof(before)));
+        }
+    }
+
+    PASS();
+}
+
+/**
+ * @testname    eytzingerLowerBound_randomKeys_FirstNotLessFound
+ * @testcase    @ref eytzingerLowerBound finds the node of the first sorted key
+ * that is not less than the value, also for duplicate keys and values beyond
+ * all keys.
+ * @testvalues
+ * | Argument 1            | Argument 2          |
+ * | --------------------- | ------------------- |
+ * | 0 - 1999 keys         | Random values       |
+ */
+TEST
+eytzingerLowerBound_randomKeys_FirstNotLessFound()
+{
+    static uint32_t sorted[2000], keys[2001];
+    static size_t order[2001];
+
+    for (uint16_t i = 0; i < 100; i++) {
+        size_t const n = rand64() % 2000;
+        uint32_t const range = (i % 2) ? UINT32_MAX : 3 * n + 1;
+
+        for (size_t j = 0; j < n; j++) {
+            /* Increasing keys, with duplicates */
+            sorted[j] = ((j > 0) ? sorted[j - 1] : 0) + rand64() % 4;
+        }
+        eytzingerBuild(keys, order, sorted, n);
+        for (size_t k = 1; k <= n; k++) {
+            GREATEST_ASSERT_EQ(sorted[order[k]], keys[k]);
+        }
+        for (uint16_t q = 0; q < 100; q++) {
+            uint32_t const x = rand64() % range;
+            size_t const k = eytzingerLowerBound(keys, n, x);
+            size_t first = 0;
+
+            while (first < n && sorted[first] < x) {
+                first++;
+            }
+            if (first == n) {
+                GREATEST_ASSERT_EQ(0, k);
+            } else {
+                GREATEST_ASSERT(k >= 1 && k <= n);
+                GREATEST_ASSERT_EQ(first, order[k]);
+            }
+        }
+    }
+
+    PASS();
+}
+
 /*******************************************************************************
  * Unit test suite
  ******************************************************************************/
@@ -1900,6 +4551,8 @@ SUITE(BitOperations)
     RUN_TEST(modifyBits_setBitsUpTo32Bit_MultipleBitsSet);
     RUN_TEST(mergeBits_magic32BitNumbers_Merged);
     RUN_TEST(nBitsSet_magic32BitNumbers_Generated);
+    RUN_TEST(nBitsSet64_randomNumbers_Counted);
+    RUN_TEST(nTrailingZeros64_randomNumbers_Counted);
     RUN_TEST(isOddParity_powersOfTwoUpTo64Bit_ParityGenerated);
     RUN_TEST(isOddParity_magig64BitNumbers_ParityGenerated);
     RUN_TEST(isOddParity_magig64BitNumbersMinusOne_ParityGenerated);
@@ -1912,6 +4565,79 @@ SUITE(BitOperations)
     RUN_TEST(roundUpToPowerOf2_powersOfTwoUpTo32BitMinusOne_GeneratePower);
     RUN_TEST(roundUpToPowerOf2_powersOfTwoUpTo32BitPlusOne_GeneratePower);
     RUN_TEST(roundUpToPowerOf2_zero_GeneratePower);
+    RUN_TEST(reverseBitOrderN_codesOfDifferentLengths_Reversed);
+    /********** Bit stream tests **********************************************/
+    RUN_TEST(bitWriter_msbFirstFields_Packed);
+    RUN_TEST(bitWriter_lsbFirstFields_Packed);
+    RUN_TEST(bitWriter_fullBuffer_ShouldFail);
+    RUN_TEST(bitReader_randomFieldsBothOrders_ReadBack);
+    RUN_TEST(bitReader_peekSkipAndOverrun_Generated);
+    /********** Bit buffer tests **********************************************/
+    RUN_TEST(copyBits_randomRanges_Copied);
+    RUN_TEST(moveBits_randomOverlappingRanges_Moved);
+    RUN_TEST(fillBits_randomRanges_SetAndCleared);
+    RUN_TEST(shiftBits_randomBuffersInAndOutOfPlace_Shifted);
+    RUN_TEST(rotateBits_randomBuffersInAndOutOfPlace_Rotated);
+    RUN_TEST(orShiftedBits_randomBuffersInAndOutOfPlace_Merged);
+    /********** Bit extract and deposit tests *********************************/
+    RUN_TEST(extractAndDepositBits_magicNumbers_Generated);
+    RUN_TEST(extractAndDepositBits_randomNumbersAndMasks_Generated);
+    /********** Morton code tests *********************************************/
+    RUN_TEST(morton2D_randomCoordinates_EncodedAndDecoded);
+    RUN_TEST(morton3D_randomCoordinates_EncodedAndDecoded);
+    RUN_TEST(mortonAdd_randomCoordinates_Added);
+    RUN_TEST(mortonBigMinLitMax_randomBoxes_Found);
+    /********** Hilbert curve tests *******************************************/
+    RUN_TEST(hilbert_knownPoints_Encoded);
+    RUN_TEST(hilbert_randomIndices_NeighboursAreAdjacent);
+    /********** Bit matrix transpose tests ************************************/
+    RUN_TEST(transposeBits8x8_randomMatrices_Transposed);
+    RUN_TEST(transposeBits32x32_randomMatrices_Transposed);
+    RUN_TEST(transposeBits64x64_randomMatrices_Transposed);
+    /********** Positional population count tests *****************************/
+    RUN_TEST(positionalPopcount_randomArrays_CountsPerBit);
+    RUN_TEST(positionalPopcount_allOnes_CountsLength);
+    /********** Hamming distance search tests *********************************/
+    RUN_TEST(hammingDistance_randomCodes_Counted);
+    RUN_TEST(hammingTopK_randomCodes_NearestFound);
+    /********** Tanimoto similarity search tests ******************************/
+    RUN_TEST(tanimotoSimilarity_randomCodes_Computed);
+    RUN_TEST(tanimotoTopK_randomCodes_MostSimilarFound);
+    /********** Blocked Bloom filter tests ************************************/
+    RUN_TEST(bloomFilter_randomKeys_NoFalseNegatives);
+    /********** Binary fuse filter tests **************************************/
+    RUN_TEST(binaryFuseFilter_randomKeys_NoFalseNegatives);
+    /********** Atomic bitmap tests *******************************************/
+    RUN_TEST(atomicBit_singleBits_SetAndCleared);
+    RUN_TEST(atomicBitAcquireFirstZero_fillAndRelease_AllBitsAcquired);
+    /********** Hierarchical bitmap tests *************************************/
+    RUN_TEST(hierarchicalBitmap_randomBits_Found);
+    RUN_TEST(hierarchicalBitmapNextZero_fullBitmap_NoneFound);
+    /********** Priority bitmap tests *****************************************/
+    RUN_TEST(priorityBitmap_randomPriorities_HighestFound);
+    RUN_TEST(atomicPriorityBitmap_concurrentSetAndClear_NeverMissed);
+    /********** Timing wheel tests ********************************************/
+    RUN_TEST(timingWheel_randomTimers_ExpireOnTime);
+    /********** Slab allocator tests ******************************************/
+    RUN_TEST(slabAllocator_fillAndFree_ObjectsReused);
+    /********** Runs of zeros tests *******************************************/
+    RUN_TEST(findZeroRun_randomRuns_FirstAndBestFitFound);
+    /********** Work stealing tests *******************************************/
+    RUN_TEST(workDeque_pushPopSteal_TasksTakenOnce);
+    RUN_TEST(atomicWorkerRun_concurrentPushPopSteal_TasksTakenOnce);
+    RUN_TEST(atomicStealVictim_randomWorkers_NextNonEmptyPicked);
+    /********** Large buffer tests ********************************************/
+    RUN_TEST(bufferPartition_randomBuffers_ChunksCombined);
+    RUN_TEST(parallelBits_randomBuffers_SameAsSingleThreaded);
+    RUN_TEST(orBitsN_randomBuffers_AggregatedAndCounted);
+    /********** Sorted set tests **********************************************/
+    RUN_TEST(intersectSorted_randomSets_SameAsBitmaps);
+    /********** Bit-sliced index tests ****************************************/
+    RUN_TEST(bitSlicedIndex_randomColumns_PredicatesEvaluated);
+    /********** Predicate tests ***********************************************/
+    RUN_TEST(selectCompare_randomColumns_SameAsComparingRows);
+    /********** Eytzinger search tests ****************************************/
+    RUN_TEST(eytzingerLowerBound_randomKeys_FirstNotLessFound);
 }
 
 /*******************************************************************************
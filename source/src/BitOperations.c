@@ -29,7 +29,169 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+/* For the CPU affinity of the threads of the parallel buffer functions. */
+#define _GNU_SOURCE
+#endif
+#include <string.h>
 #include "BitOperations.h"
+#ifdef BITOPERATIONS_THREADS
+#include <pthread.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#endif
+
+/*******************************************************************************
+ * Defines
+ ******************************************************************************/
+#if defined(__BMI2__) && defined(__x86_64__) && !defined(BITOPERATIONS_NO_BMI2)
+/** Use the BMI2 PEXT and PDEP instructions. */
+#define BITOPERATIONS_USE_BMI2
+#endif
+
+#if defined(__GFNI__) && defined(__SSSE3__)
+/** Use the GFNI affine transformation instruction. */
+#define BITOPERATIONS_USE_GFNI
+#endif
+
+#if defined(__POPCNT__) && defined(__x86_64__)
+/** Use the POPCNT instruction. */
+#define BITOPERATIONS_USE_POPCNT
+#endif
+
+#if defined(__AVX512VPOPCNTDQ__) && defined(__AVX512F__)
+/** Use the AVX-512 VPOPCNTQ instruction. */
+#define BITOPERATIONS_USE_AVX512_POPCNT
+#endif
+
+#if defined(__SSE2__)
+/** Use the SSE2 instructions to compare four 32-bit values at a time. */
+#define BITOPERATIONS_USE_SSE2
+#endif
+
+#if defined(__AVX512F__)
+/** Use the AVX-512 compare instructions of 32 and 64-bit values. */
+#define BITOPERATIONS_USE_AVX512F
+#endif
+
+#if defined(__AVX512BW__) && defined(__AVX512F__)
+/** Use the AVX-512 compare instructions of 8 and 16-bit values. */
+#define BITOPERATIONS_USE_AVX512BW
+#endif
+
+#if defined(BITOPERATIONS_USE_BMI2) || defined(BITOPERATIONS_USE_GFNI) \
+        || defined(BITOPERATIONS_USE_POPCNT) \
+        || defined(BITOPERATIONS_USE_AVX512_POPCNT) \
+        || defined(BITOPERATIONS_USE_SSE2) \
+        || defined(BITOPERATIONS_USE_AVX512F)
+#include <immintrin.h>
+#endif
+
+#define MORTON2D_X  0x5555555555555555ULL   /**< Bits of X in a 2D code. */
+#define MORTON2D_Y  0xAAAAAAAAAAAAAAAAULL   /**< Bits of Y in a 2D code. */
+#define MORTON3D_X  0x1249249249249249ULL   /**< Bits of X in a 3D code. */
+#define MORTON3D_Y  0x2492492492492492ULL   /**< Bits of Y in a 3D code. */
+#define MORTON3D_Z  0x4924924924924924ULL   /**< Bits of Z in a 3D code. */
+
+/** Points of which the 3D Hilbert state tables are walked side by side. */
+#define HILBERT_3D_BATCH    4
+
+/** Bytes of codes that are scanned for all queries of a batch at a time. */
+#define HAMMING_BLOCK_BYTES 16384
+
+/**
+ * Number of keys of a batch of which the memory is prefetched at a time, a
+ * divisor of 64.
+ */
+#define PREFETCH_BATCH      16
+
+/** Slot of a timing wheel for timers beyond the range of the top level. */
+#define TIMING_WHEEL_OVERFLOW       (64 * TIMING_WHEEL_LEVELS)
+/** Slot of a timer that is not in a timing wheel. */
+#define TIMING_WHEEL_NONE           UINT16_MAX
+
+/** Number of blocks of a Bloom filter that a 32-bit hash can select. */
+#define BLOOM_FILTER_MAX_BLOCKS     (1ULL << 32)
+
+/** Number of seeds to try to build a binary fuse filter with. */
+#define BINARY_FUSE_MAX_ITERATIONS  100
+
+/** Bits of a chunk of which a zero run index keeps the runs of zeros. */
+#define ZERO_RUN_CHUNK_BITS         512
+
+/** Words of the output of which all inputs are aggregated at a time, 4 KiB. */
+#define AGGREGATE_BLOCK_WORDS       512
+
+/** Tasks that the chunk of a thread of a parallel buffer function is split
+ * into, a power of 2. */
+#define BUFFER_THREAD_TASKS         16
+
+/**
+ * Size ratio of two sorted sets from which the values of the smaller set are
+ * searched in the larger set, instead of merging the sets.
+ */
+#define SORTED_SET_GALLOP_RATIO     32
+
+#ifdef __GNUC__
+/** Prefetch the cache line at address p for reading. */
+#define PREFETCH(p)         __builtin_prefetch(p)
+#else
+#define PREFETCH(p)
+#endif
+
+/*******************************************************************************
+ * Type definitions
+ ******************************************************************************/
+/**
+ * The result arrays of a @ref HammingTopK or @ref TanimotoTopK as one bounded
+ * heap. The score of a result is its similarity, or its distance negated, so
+ * a higher score always ranks first and the result that ranks last is at the
+ * root.
+ */
+typedef struct {
+    size_t *index;          /**< Indices of the results. */
+    uint32_t *distance;     /**< Distances of the results, or NULL. */
+    double *similarity;     /**< Similarities of the results, or NULL. */
+    size_t k;               /**< Maximum number of results. */
+    size_t *n;              /**< Number of results found. */
+} TopKHeap;
+
+#ifdef BITOPERATIONS_THREADS
+/** Operation of a parallel large-buffer function. */
+typedef enum {
+    BUFFER_CLEAR,
+    BUFFER_COUNT,
+    BUFFER_PARITY,
+    BUFFER_AND,
+    BUFFER_OR,
+    BUFFER_XOR,
+    BUFFER_REVERSE
+} BufferOperation;
+
+/** The buffers and the deques of a parallel large-buffer function. */
+typedef struct {
+    BufferOperation operation;  /**< Operation to run on the tasks. */
+    uint64_t *dst;          /**< Buffer to store the result in, or NULL. */
+    uint64_t const *a;      /**< First buffer. */
+    uint64_t const *b;      /**< Second buffer, or NULL. */
+    size_t nWords;          /**< Number of words in the buffers. */
+    size_t minWords;        /**< Minimum number of words of a chunk. */
+    size_t nThreads;        /**< Number of threads with a chunk. */
+    size_t taskWords;       /**< Maximum number of words of a task. */
+    uint64_t nonEmpty;      /**< Bitmap of the threads with tasks. */
+    WorkDeque deques[BUFFER_THREADS_MAX];   /**< Tasks of the threads. */
+    /** Memory of the deques. */
+    uint64_t tasks[BUFFER_THREADS_MAX][BUFFER_THREAD_TASKS];
+} BufferJob;
+
+/** A thread of a parallel large-buffer function and its partial result. */
+typedef struct {
+    BufferJob *job;         /**< Job of the thread. */
+    size_t self;            /**< Number of the thread. */
+    uint64_t result;        /**< Count or parity of the tasks of the thread. */
+} BufferWorker;
+#endif	/* BITOPERATIONS_THREADS */
 
 /*******************************************************************************
  * Functions
@@ -118,6 +280,64 @@ nBitsSet(uint32_t const _var)
     return (result);
 }
 
+uint8_t
+nBitsSet64(uint64_t const _var)
+{
+#ifdef BITOPERATIONS_USE_POPCNT
+    return ((uint8_t)_mm_popcnt_u64(_var));
+#else
+    uint64_t v = _var;
+
+    v = v - ((v >> 1) & 0x5555555555555555ULL);
+    v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return ((uint8_t)((v * 0x0101010101010101ULL) >> 56));
+#endif
+}
+
+uint8_t
+nTrailingZeros64(uint64_t const _var)
+{
+    if (_var == 0) {
+        return (64);
+    }
+#ifdef __GNUC__
+    return ((uint8_t)__builtin_ctzll(_var));
+#else
+    static uint8_t const position[64] = {
+         0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+    };
+
+    /* Isolate the lowest set bit and multiply by a De Bruijn sequence */
+    return (position[((_var & -_var) * 0x03F79D71B4CB0A89ULL) >> 58]);
+#endif
+}
+
+uint8_t
+nLeadingZeros64(uint64_t const _var)
+{
+    if (_var == 0) {
+        return (64);
+    }
+#ifdef __GNUC__
+    return ((uint8_t)__builtin_clzll(_var));
+#else
+    uint64_t v = _var;
+
+    /* Smear the highest set bit to the right */
+    v |= v >> 1;
+    v |= v >> 2;
+    v |= v >> 4;
+    v |= v >> 8;
+    v |= v >> 16;
+    v |= v >> 32;
+    return (nBitsSet64(~v));
+#endif
+}
+
 bool
 isOddParity(uint64_t const _var)
 {
@@ -159,6 +379,40 @@ reverseBitOrder(uint32_t const _var)
     return (v);
 }
 
+/**
+ * Reverse the bits of a 64-bit word, as @ref reverseBitOrder does for 32 bits.
+ */
+static uint64_t
+reverseBitOrder64(uint64_t const _var)
+{
+    uint64_t v = _var;
+    // swap odd and even bits
+    v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+    // swap consecutive pairs
+    v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+    // swap nibbles ...
+    v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    // swap bytes
+    v = ((v >> 8) & 0x00FF00FF00FF00FFULL) | ((v & 0x00FF00FF00FF00FFULL) << 8);
+    // swap 2-byte long pairs
+    v = ((v >> 16) & 0x0000FFFF0000FFFFULL)
+            | ((v & 0x0000FFFF0000FFFFULL) << 16);
+    // swap 4-byte long pairs
+    v = ( v >> 32             ) | ( v               << 32);
+
+    return (v);
+}
+
+uint32_t
+reverseBitOrderN(uint32_t const _var, uint8_t const _nBits)
+{
+    if (_nBits == 0) {
+        return (0);
+    }
+
+    return (reverseBitOrder(_var) >> (32 - _nBits));
+}
+
 uint32_t
 roundUpToPowerOf2(uint32_t const _var)
 {
@@ -170,4 +424,5604 @@ roundUpToPowerOf2(uint32_t const _var)
         return (1);
     }
 }
+/********** Bit stream ********************************************************/
+/**
+ * Store the _nBytes first bytes of the accumulator _acc of a bit stream.
+ */
+static void
+bitStreamStore(uint8_t *const _dst, uint64_t const _acc, uint8_t const _nBytes,
+        BitOrder const _order)
+{
+    for (uint8_t i = 0; i < _nBytes; i++) {
+        if (_order == BIT_ORDER_MSB_FIRST) {
+            _dst[i] = (uint8_t)(_acc >> (56 - 8 * i));
+        } else {
+            _dst[i] = (uint8_t)(_acc >> (8 * i));
+        }
+    }
+
+    return;
+}
+
+/**
+ * Load eight bytes of a bit stream, the first byte being the most significant
+ * byte for MSB-first streams and the least significant byte else.
+ */
+static uint64_t
+bitStreamLoad(uint8_t const *const _src, BitOrder const _order)
+{
+    uint64_t word = 0;
+
+    for (uint8_t i = 0; i < 8; i++) {
+        if (_order == BIT_ORDER_MSB_FIRST) {
+            word |= (uint64_t)_src[i] << (56 - 8 * i);
+        } else {
+            word |= (uint64_t)_src[i] << (8 * i);
+        }
+    }
+
+    return (word);
+}
+
+void
+bitWriterInit(BitWriter *const _w, uint8_t *const _buf, size_t const _size,
+        BitOrder const _order)
+{
+    _w->buf = _buf;
+    _w->size = _size;
+    _w->pos = 0;
+    _w->acc = 0;
+    _w->nBits = 0;
+    _w->order = _order;
+
+    return;
+}
+
+/**
+ * Append up to 56 bits to the accumulator, which then holds at most 63 bits,
+ * and store all complete bytes. When at least eight bytes of the buffer are
+ * left, the whole accumulator is stored at once and the incomplete bytes are
+ * simply overwritten by the next write.
+ */
+static void
+bitWriterPutBits(BitWriter *const _w, uint64_t const _value,
+        uint8_t const _nBits)
+{
+    uint64_t const v = _value & (~0ULL >> (64 - _nBits));
+    uint8_t nBytes;
+
+    if (_w->order == BIT_ORDER_MSB_FIRST) {
+        _w->acc |= v << (64 - _w->nBits - _nBits);
+    } else {
+        _w->acc |= v << _w->nBits;
+    }
+    _w->nBits += _nBits;
+    nBytes = _w->nBits >> 3;
+
+    if (_w->pos + 8 <= _w->size) {
+        bitStreamStore(&_w->buf[_w->pos], _w->acc, 8, _w->order);
+    } else {
+        bitStreamStore(&_w->buf[_w->pos], _w->acc, nBytes, _w->order);
+    }
+    _w->pos += nBytes;
+
+    if (_w->order == BIT_ORDER_MSB_FIRST) {
+        _w->acc <<= _w->nBits & 56;
+    } else {
+        _w->acc >>= _w->nBits & 56;
+    }
+    _w->nBits &= 7;
+
+    return;
+}
+
+bool
+bitWriterPut(BitWriter *const _w, uint64_t const _value, uint8_t const _nBits)
+{
+    if (bitWriterBitsWritten(_w) + _nBits
+            > _w->size * BITOPERATIONS_NCHAR_BITS) {
+        return (false);
+    }
+
+    if (_nBits > 56) {
+        if (_w->order == BIT_ORDER_MSB_FIRST) {
+            bitWriterPutBits(_w, _value >> 32, _nBits - 32);
+            bitWriterPutBits(_w, _value, 32);
+        } else {
+            bitWriterPutBits(_w, _value, 32);
+            bitWriterPutBits(_w, _value >> 32, _nBits - 32);
+        }
+    } else if (_nBits > 0) {
+        bitWriterPutBits(_w, _value, _nBits);
+    }
+
+    return (true);
+}
+
+size_t
+bitWriterFlush(BitWriter *const _w)
+{
+    if (_w->nBits > 0) {
+        bitStreamStore(&_w->buf[_w->pos], _w->acc, 1, _w->order);
+        _w->pos++;
+    }
+    _w->acc = 0;
+    _w->nBits = 0;
+
+    return (_w->pos);
+}
+
+size_t
+bitWriterBitsWritten(BitWriter const *const _w)
+{
+    return (_w->pos * BITOPERATIONS_NCHAR_BITS + _w->nBits);
+}
+
+void
+bitReaderInit(BitReader *const _r, uint8_t const *const _buf,
+        size_t const _size, BitOrder const _order)
+{
+    _r->buf = _buf;
+    _r->size = _size;
+    _r->pos = 0;
+    _r->acc = 0;
+    _r->nBits = 0;
+    _r->order = _order;
+
+    return;
+}
+
+/**
+ * Refill the accumulator to at least 56 valid bits.
+ *
+ * While at least eight bytes of the buffer are left, this loads a whole word
+ * without any data dependent branch. The bits behind the last whole byte that
+ * fits in the accumulator are loaded as well, but those are loaded again at
+ * the same position by the next refill. Near the end of the buffer the bytes
+ * are loaded one by one, padding the stream with zero bytes.
+ */
+static void
+bitReaderRefill(BitReader *const _r)
+{
+    if (_r->pos + 8 <= _r->size) {
+        uint64_t const word = bitStreamLoad(&_r->buf[_r->pos], _r->order);
+
+        if (_r->order == BIT_ORDER_MSB_FIRST) {
+            _r->acc |= word >> _r->nBits;
+        } else {
+            _r->acc |= word << _r->nBits;
+        }
+        _r->pos += (63 - _r->nBits) >> 3;
+        _r->nBits |= 56;
+    } else {
+        while (_r->nBits <= 56) {
+            uint64_t const byte = (_r->pos < _r->size) ? _r->buf[_r->pos] : 0;
+
+            if (_r->order == BIT_ORDER_MSB_FIRST) {
+                _r->acc |= byte << (56 - _r->nBits);
+            } else {
+                _r->acc |= byte << _r->nBits;
+            }
+            _r->pos++;
+            _r->nBits += 8;
+        }
+    }
+
+    return;
+}
+
+uint64_t
+bitReaderPeek(BitReader *const _r, uint8_t const _nBits)
+{
+    bitReaderRefill(_r);
+
+    if (_r->order == BIT_ORDER_MSB_FIRST) {
+        /* Shift in two steps, so that peeking zero bits is no 64-bit shift. */
+        return ((_r->acc >> 1) >> (63 - _nBits));
+    } else {
+        return (_r->acc & ((1ULL << _nBits) - 1));
+    }
+}
+
+void
+bitReaderSkip(BitReader *const _r, uint8_t const _nBits)
+{
+    if (_r->order == BIT_ORDER_MSB_FIRST) {
+        _r->acc <<= _nBits;
+    } else {
+        _r->acc >>= _nBits;
+    }
+    _r->nBits -= _nBits;
+
+    return;
+}
+
+uint64_t
+bitReaderGet(BitReader *const _r, uint8_t const _nBits)
+{
+    uint64_t v;
+
+    if (_nBits > 56) {
+        if (_r->order == BIT_ORDER_MSB_FIRST) {
+            v = bitReaderGet(_r, _nBits - 32) << 32;
+            v |= bitReaderGet(_r, 32);
+        } else {
+            v = bitReaderGet(_r, 32);
+            v |= bitReaderGet(_r, _nBits - 32) << 32;
+        }
+    } else {
+        v = bitReaderPeek(_r, _nBits);
+        bitReaderSkip(_r, _nBits);
+    }
+
+    return (v);
+}
+
+int64_t
+bitReaderBitsLeft(BitReader const *const _r)
+{
+    return ((int64_t)_r->size * BITOPERATIONS_NCHAR_BITS
+            - ((int64_t)_r->pos * BITOPERATIONS_NCHAR_BITS - _r->nBits));
+}
+
+/********** Bit buffer ********************************************************/
+/**
+ * Create a mask of the _nBits (0-64) lowest bits.
+ */
+static uint64_t
+bitBufLowMask(size_t const _nBits)
+{
+    return ((_nBits >= 64) ? ~0ULL : (1ULL << _nBits) - 1);
+}
+
+/**
+ * Get _nBits (1-64) bits of a buffer of bits, starting at bit _offset. Only
+ * the words that hold those bits are read.
+ */
+static uint64_t
+bitBufFetch(uint64_t const *const _src, size_t const _offset,
+        size_t const _nBits)
+{
+    size_t const w = _offset / 64;
+    uint8_t const s = _offset % 64;
+    uint64_t v = _src[w] >> s;
+
+    if (s + _nBits > 64) {
+        v |= _src[w + 1] << (64 - s);
+    }
+
+    return (v & bitBufLowMask(_nBits));
+}
+
+/**
+ * Put the _nBits (1-64) lowest bits of _bits in a buffer of bits, starting at
+ * bit _offset which lies in the same word as the last bit.
+ */
+static void
+bitBufStore(uint64_t *const _dst, size_t const _offset, uint64_t const _bits,
+        size_t const _nBits)
+{
+    uint8_t const s = _offset % 64;
+    uint64_t const mask = bitBufLowMask(_nBits) << s;
+    uint64_t const x = _dst[_offset / 64];
+
+    /* Merge bits as mergeBits, but for a 64-bit variable. */
+    _dst[_offset / 64] = x ^ ((x ^ (_bits << s)) & mask);
+
+    return;
+}
+
+/**
+ * Copy from the first to the last bit. The head and tail are merged in their
+ * destination word, the whole words in between are stored with a funnel shift
+ * of two source words, or moved with memmove when both ranges have the same
+ * alignment. A destination word is always written after the source words it
+ * is built from are read, so this is safe for overlapping ranges where the
+ * destination starts before the source.
+ */
+static void
+copyBitsForward(uint64_t *const _dst, size_t _dstOffset,
+        uint64_t const *const _src, size_t _srcOffset, size_t _nBits)
+{
+    if (_nBits == 0) {
+        return;
+    }
+
+    if (_dstOffset % 64 != 0 || _nBits < 64) {
+        size_t const n = (_nBits < 64 - _dstOffset % 64) ?
+                _nBits : 64 - _dstOffset % 64;
+
+        bitBufStore(_dst, _dstOffset, bitBufFetch(_src, _srcOffset, n), n);
+        _dstOffset += n;
+        _srcOffset += n;
+        _nBits -= n;
+    }
+
+    if (_nBits >= 64) {
+        uint64_t *const d = &_dst[_dstOffset / 64];
+        uint64_t const *const s = &_src[_srcOffset / 64];
+        uint8_t const shift = _srcOffset % 64;
+        size_t const nWords = _nBits / 64;
+
+        if (shift == 0) {
+            memmove(d, s, nWords * sizeof(uint64_t));
+        } else {
+            for (size_t i = 0; i < nWords; i++) {
+                d[i] = (s[i] >> shift) | (s[i + 1] << (64 - shift));
+            }
+        }
+        _dstOffset += nWords * 64;
+        _srcOffset += nWords * 64;
+        _nBits -= nWords * 64;
+    }
+
+    if (_nBits > 0) {
+        bitBufStore(_dst, _dstOffset, bitBufFetch(_src, _srcOffset, _nBits),
+                _nBits);
+    }
+
+    return;
+}
+
+/**
+ * Copy from the last to the first bit, the mirror image of copyBitsForward,
+ * which is safe for overlapping ranges where the destination starts behind the
+ * source.
+ */
+static void
+copyBitsBackward(uint64_t *const _dst, size_t const _dstOffset,
+        uint64_t const *const _src, size_t const _srcOffset, size_t _nBits)
+{
+    size_t dstEnd = _dstOffset + _nBits;
+    size_t srcEnd = _srcOffset + _nBits;
+
+    if (dstEnd % 64 != 0 && _nBits > 0) {
+        size_t const n = (_nBits < dstEnd % 64) ? _nBits : dstEnd % 64;
+
+        dstEnd -= n;
+        srcEnd -= n;
+        _nBits -= n;
+        bitBufStore(_dst, dstEnd, bitBufFetch(_src, srcEnd, n), n);
+    }
+
+    if (_nBits >= 64) {
+        size_t const nWords = _nBits / 64;
+        uint8_t const shift = (srcEnd - nWords * 64) % 64;
+
+        dstEnd -= nWords * 64;
+        srcEnd -= nWords * 64;
+        _nBits -= nWords * 64;
+
+        if (shift == 0) {
+            memmove(&_dst[dstEnd / 64], &_src[srcEnd / 64],
+                    nWords * sizeof(uint64_t));
+        } else {
+            uint64_t *const d = &_dst[dstEnd / 64];
+            uint64_t const *const s = &_src[srcEnd / 64];
+
+            for (size_t i = nWords; i > 0; i--) {
+                d[i - 1] = (s[i - 1] >> shift) | (s[i] << (64 - shift));
+            }
+        }
+    }
+
+    if (_nBits > 0) {
+        bitBufStore(_dst, dstEnd - _nBits,
+                bitBufFetch(_src, srcEnd - _nBits, _nBits), _nBits);
+    }
+
+    return;
+}
+
+void
+copyBits(uint64_t *const _dst, size_t const _dstOffset,
+        uint64_t const *const _src, size_t const _srcOffset,
+        size_t const _nBits)
+{
+    copyBitsForward(_dst, _dstOffset, _src, _srcOffset, _nBits);
+
+    return;
+}
+
+void
+moveBits(uint64_t *const _dst, size_t const _dstOffset,
+        uint64_t const *const _src, size_t const _srcOffset,
+        size_t const _nBits)
+{
+    uintptr_t const d = (uintptr_t)&_dst[_dstOffset / 64];
+    uintptr_t const s = (uintptr_t)&_src[_srcOffset / 64];
+
+    if (d < s || (d == s && _dstOffset % 64 <= _srcOffset % 64)) {
+        copyBitsForward(_dst, _dstOffset, _src, _srcOffset, _nBits);
+    } else {
+        copyBitsBackward(_dst, _dstOffset, _src, _srcOffset, _nBits);
+    }
+
+    return;
+}
+
+/**
+ * Put the _nBits (1-64) lowest bits of _bits in a buffer of bits, starting at
+ * any bit _offset.
+ */
+static void
+bitBufPut(uint64_t *const _dst, size_t const _offset, uint64_t const _bits,
+        size_t const _nBits)
+{
+    size_t const n = 64 - _offset % 64;
+
+    if (_nBits <= n) {
+        bitBufStore(_dst, _offset, _bits, _nBits);
+    } else {
+        bitBufStore(_dst, _offset, _bits, n);
+        bitBufStore(_dst, _offset + n, _bits >> n, _nBits - n);
+    }
+
+    return;
+}
+
+void
+fillBits(uint64_t *const _dst, size_t _offset, size_t _nBits, bool const _f)
+{
+    uint64_t const v = -(uint64_t)_f;
+
+    if (_offset % 64 != 0 && _nBits > 0) {
+        size_t const n = (_nBits < 64 - _offset % 64) ?
+                _nBits : 64 - _offset % 64;
+
+        bitBufStore(_dst, _offset, v, n);
+        _offset += n;
+        _nBits -= n;
+    }
+    for (; _nBits >= 64; _nBits -= 64, _offset += 64) {
+        _dst[_offset / 64] = v;
+    }
+    if (_nBits > 0) {
+        bitBufStore(_dst, _offset, v, _nBits);
+    }
+
+    return;
+}
+
+void
+shiftBitsLeft(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _nBits, size_t const _n)
+{
+    if (_n >= _nBits) {
+        fillBits(_dst, 0, _nBits, 0);
+    } else {
+        moveBits(_dst, _n, _src, 0, _nBits - _n);
+        fillBits(_dst, 0, _n, 0);
+    }
+
+    return;
+}
+
+void
+shiftBitsRight(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _nBits, size_t const _n)
+{
+    if (_n >= _nBits) {
+        fillBits(_dst, 0, _nBits, 0);
+    } else {
+        moveBits(_dst, 0, _src, _n, _nBits - _n);
+        fillBits(_dst, _nBits - _n, _n, 0);
+    }
+
+    return;
+}
+
+/**
+ * Swap two non-overlapping ranges of _nBits bits, 64 bits at a time.
+ */
+static void
+swapBits(uint64_t *const _buf, size_t const _a, size_t const _b,
+        size_t const _nBits)
+{
+    for (size_t i = 0; i < _nBits; i += 64) {
+        size_t const n = (_nBits - i < 64) ? _nBits - i : 64;
+        uint64_t const x = bitBufFetch(_buf, _a + i, n);
+        uint64_t const y = bitBufFetch(_buf, _b + i, n);
+
+        bitBufPut(_buf, _a + i, y, n);
+        bitBufPut(_buf, _b + i, x, n);
+    }
+
+    return;
+}
+
+/**
+ * Rotate in place with the block swap algorithm of Gries and Mills. Rotating
+ * left by _n makes bit (_nBits - _n) the first bit. Each swap puts one block
+ * in its final place, so in total fewer than _nBits bits are swapped.
+ */
+void
+rotateBitsLeft(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _nBits, size_t const _n)
+{
+    size_t const n = (_nBits == 0) ? 0 : _n % _nBits;
+
+    if (n == 0) {
+        if (_dst != _src) {
+            copyBits(_dst, 0, _src, 0, _nBits);
+        }
+    } else if (_dst != _src) {
+        copyBits(_dst, n, _src, 0, _nBits - n);
+        copyBits(_dst, 0, _src, _nBits - n, n);
+    } else {
+        size_t const middle = _nBits - n;
+        size_t i = middle;
+        size_t j = n;
+
+        while (i != j) {
+            if (i > j) {
+                swapBits(_dst, middle - i, middle, j);
+                i -= j;
+            } else {
+                swapBits(_dst, middle - i, middle + j - i, i);
+                j -= i;
+            }
+        }
+        swapBits(_dst, middle - i, middle, i);
+    }
+
+    return;
+}
+
+void
+rotateBitsRight(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _nBits, size_t const _n)
+{
+    size_t const n = (_nBits == 0) ? 0 : _n % _nBits;
+
+    rotateBitsLeft(_dst, _src, _nBits, _nBits - n);
+
+    return;
+}
+
+/**
+ * Every destination word is built from two source words with a funnel shift.
+ * The words are processed from high to low, so that when _dst is _src each
+ * source word is read before it is overwritten.
+ */
+void
+orShiftedBitsLeft(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _nBits, size_t const _n)
+{
+    size_t const nWords = BITBUF_NWORDS(_nBits);
+    size_t const q = _n / 64;
+    uint8_t const r = _n % 64;
+    uint64_t last;
+
+    if (_n >= _nBits) {
+        return;
+    }
+
+    /* The last word only gets the bits up to _nBits. */
+    last = _src[nWords - 1 - q] << r;
+    if (r != 0 && nWords - 1 > q) {
+        last |= _src[nWords - 2 - q] >> (64 - r);
+    }
+    _dst[nWords - 1] |= last & bitBufLowMask(_nBits - (nWords - 1) * 64);
+
+    if (r == 0) {
+        for (size_t i = nWords - 1; i > q; i--) {
+            _dst[i - 1] |= _src[i - 1 - q];
+        }
+    } else {
+        for (size_t i = nWords - 1; i > q + 1; i--) {
+            _dst[i - 1] |= (_src[i - 1 - q] << r)
+                    | (_src[i - 2 - q] >> (64 - r));
+        }
+        if (nWords - 1 > q) {
+            _dst[q] |= _src[0] << r;
+        }
+    }
+
+    return;
+}
+
+/**
+ * The mirror image of orShiftedBitsLeft, processing the words from low to
+ * high. The source bits beyond _nBits are masked off in the last word.
+ */
+void
+orShiftedBitsRight(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _nBits, size_t const _n)
+{
+    size_t const nWords = BITBUF_NWORDS(_nBits);
+    size_t const q = _n / 64;
+    uint8_t const r = _n % 64;
+    uint64_t const lastMask = bitBufLowMask(_nBits - (nWords - 1) * 64);
+
+    if (_n >= _nBits) {
+        return;
+    }
+
+    for (size_t i = 0; i + q + 1 < nWords; i++) {
+        uint64_t hi = _src[i + q + 1];
+
+        if (i + q + 2 == nWords) {
+            hi &= lastMask;
+        }
+        if (r == 0) {
+            _dst[i] |= _src[i + q];
+        } else {
+            _dst[i] |= (_src[i + q] >> r) | (hi << (64 - r));
+        }
+    }
+    _dst[nWords - 1 - q] |= (_src[nWords - 1] & lastMask) >> r;
+
+    return;
+}
+
+/********** Bit extract and deposit *******************************************/
+uint32_t
+extractBits32(uint32_t const _var, uint32_t const _mask)
+{
+#if defined(BITOPERATIONS_USE_BMI2)
+    return (_pext_u32(_var, _mask));
+#else
+    return ((uint32_t)extractBits64(_var, _mask));
+#endif
+}
+
+/**
+ * Without BMI2 the bits of the mask are visited from low to high, which takes
+ * a few operations per set bit of the mask.
+ */
+uint64_t
+extractBits64(uint64_t const _var, uint64_t const _mask)
+{
+#if defined(BITOPERATIONS_USE_BMI2)
+    return (_pext_u64(_var, _mask));
+#else
+    uint64_t result = 0;
+    uint64_t m = _mask;
+
+    for (uint64_t bit = 1; m != 0; bit <<= 1) {
+        if (_var & m & -m) {
+            result |= bit;
+        }
+        m &= m - 1;
+    }
+
+    return (result);
+#endif
+}
+
+uint32_t
+depositBits32(uint32_t const _var, uint32_t const _mask)
+{
+#if defined(BITOPERATIONS_USE_BMI2)
+    return (_pdep_u32(_var, _mask));
+#else
+    return ((uint32_t)depositBits64(_var, _mask));
+#endif
+}
+
+uint64_t
+depositBits64(uint64_t const _var, uint64_t const _mask)
+{
+#if defined(BITOPERATIONS_USE_BMI2)
+    return (_pdep_u64(_var, _mask));
+#else
+    uint64_t result = 0;
+    uint64_t m = _mask;
+
+    for (uint64_t bit = 1; m != 0; bit <<= 1) {
+        if (_var & bit) {
+            result |= m & -m;
+        }
+        m &= m - 1;
+    }
+
+    return (result);
+#endif
+}
+
+/**
+ * In step i every bit of the mask moves right by 2^i times the lowest bit of
+ * the number of cleared mask bits on its right. That number is found with a
+ * parallel prefix XOR of the cleared bits.
+ */
+void
+bitExtractPlanInit(BitExtractPlan *const _plan, uint64_t const _mask)
+{
+    uint64_t m = _mask;
+    uint64_t mk = ~_mask << 1;
+
+    _plan->mask = _mask;
+    for (uint8_t i = 0; i < 6; i++) {
+        uint64_t mp = mk ^ (mk << 1);
+        uint64_t mv;
+
+        mp ^= mp << 2;
+        mp ^= mp << 4;
+        mp ^= mp << 8;
+        mp ^= mp << 16;
+        mp ^= mp << 32;
+        mv = mp & m;
+        _plan->move[i] = mv;
+        m = (m ^ mv) | (mv >> (1 << i));
+        mk &= ~mp;
+    }
+
+    return;
+}
+
+uint64_t
+extractBitsPlanned(BitExtractPlan const *const _plan, uint64_t const _var)
+{
+    uint64_t x = _var & _plan->mask;
+
+    for (uint8_t i = 0; i < 6; i++) {
+        uint64_t const t = x & _plan->move[i];
+
+        x = (x ^ t) | (t >> (1 << i));
+    }
+
+    return (x);
+}
+
+uint64_t
+depositBitsPlanned(BitExtractPlan const *const _plan, uint64_t const _var)
+{
+    uint64_t x = _var;
+
+    for (uint8_t i = 6; i > 0; i--) {
+        uint64_t const mv = _plan->move[i - 1];
+
+        x = (x & ~mv) | ((x << (1 << (i - 1))) & mv);
+    }
+
+    return (x & _plan->mask);
+}
+
+void
+extractBitsBatch(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _n, BitExtractPlan const *const _plan)
+{
+    for (size_t i = 0; i < _n; i++) {
+#if defined(BITOPERATIONS_USE_BMI2)
+        _dst[i] = _pext_u64(_src[i], _plan->mask);
+#else
+        _dst[i] = extractBitsPlanned(_plan, _src[i]);
+#endif
+    }
+
+    return;
+}
+
+void
+depositBitsBatch(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _n, BitExtractPlan const *const _plan)
+{
+    for (size_t i = 0; i < _n; i++) {
+#if defined(BITOPERATIONS_USE_BMI2)
+        _dst[i] = _pdep_u64(_src[i], _plan->mask);
+#else
+        _dst[i] = depositBitsPlanned(_plan, _src[i]);
+#endif
+    }
+
+    return;
+}
+
+/********** Morton code *******************************************************/
+/**
+ * Spread the bits of a 32-bit variable to the even bits, with binary magic
+ * numbers.
+ */
+static uint64_t
+mortonSpread2D(uint64_t _v)
+{
+    _v = (_v | (_v << 16)) & 0x0000FFFF0000FFFFULL;
+    _v = (_v | (_v << 8))  & 0x00FF00FF00FF00FFULL;
+    _v = (_v | (_v << 4))  & 0x0F0F0F0F0F0F0F0FULL;
+    _v = (_v | (_v << 2))  & 0x3333333333333333ULL;
+    _v = (_v | (_v << 1))  & 0x5555555555555555ULL;
+
+    return (_v);
+}
+
+/**
+ * Compact the even bits of a 64-bit variable, the inverse of mortonSpread2D.
+ */
+static uint32_t
+mortonCompact2D(uint64_t _v)
+{
+    _v &= 0x5555555555555555ULL;
+    _v = (_v | (_v >> 1))  & 0x3333333333333333ULL;
+    _v = (_v | (_v >> 2))  & 0x0F0F0F0F0F0F0F0FULL;
+    _v = (_v | (_v >> 4))  & 0x00FF00FF00FF00FFULL;
+    _v = (_v | (_v >> 8))  & 0x0000FFFF0000FFFFULL;
+    _v = (_v | (_v >> 16)) & 0x00000000FFFFFFFFULL;
+
+    return ((uint32_t)_v);
+}
+
+/**
+ * Spread the 21 lowest bits of a variable to every third bit, with binary
+ * magic numbers.
+ */
+static uint64_t
+mortonSpread3D(uint64_t _v)
+{
+    _v &= 0x1FFFFF;
+    _v = (_v | (_v << 32)) & 0x001F00000000FFFFULL;
+    _v = (_v | (_v << 16)) & 0x001F0000FF0000FFULL;
+    _v = (_v | (_v << 8))  & 0x100F00F00F00F00FULL;
+    _v = (_v | (_v << 4))  & 0x10C30C30C30C30C3ULL;
+    _v = (_v | (_v << 2))  & 0x1249249249249249ULL;
+
+    return (_v);
+}
+
+/**
+ * Compact every third bit of a 64-bit variable, the inverse of mortonSpread3D.
+ */
+static uint32_t
+mortonCompact3D(uint64_t _v)
+{
+    _v &= 0x1249249249249249ULL;
+    _v = (_v | (_v >> 2))  & 0x10C30C30C30C30C3ULL;
+    _v = (_v | (_v >> 4))  & 0x100F00F00F00F00FULL;
+    _v = (_v | (_v >> 8))  & 0x001F0000FF0000FFULL;
+    _v = (_v | (_v >> 16)) & 0x001F00000000FFFFULL;
+    _v = (_v | (_v >> 32)) & 0x00000000001FFFFFULL;
+
+    return ((uint32_t)_v);
+}
+
+uint64_t
+mortonEncode2D(uint32_t const _x, uint32_t const _y)
+{
+#if defined(BITOPERATIONS_USE_BMI2)
+    return (depositBits64(_x, MORTON2D_X) | depositBits64(_y, MORTON2D_Y));
+#else
+    return (mortonSpread2D(_x) | (mortonSpread2D(_y) << 1));
+#endif
+}
+
+void
+mortonDecode2D(uint64_t const _code, uint32_t *const _x, uint32_t *const _y)
+{
+#if defined(BITOPERATIONS_USE_BMI2)
+    *_x = (uint32_t)extractBits64(_code, MORTON2D_X);
+    *_y = (uint32_t)extractBits64(_code, MORTON2D_Y);
+#else
+    *_x = mortonCompact2D(_code);
+    *_y = mortonCompact2D(_code >> 1);
+#endif
+
+    return;
+}
+
+uint64_t
+mortonEncode3D(uint32_t const _x, uint32_t const _y, uint32_t const _z)
+{
+#if defined(BITOPERATIONS_USE_BMI2)
+    return (depositBits64(_x, MORTON3D_X) | depositBits64(_y, MORTON3D_Y)
+            | depositBits64(_z, MORTON3D_Z));
+#else
+    return (mortonSpread3D(_x) | (mortonSpread3D(_y) << 1)
+            | (mortonSpread3D(_z) << 2));
+#endif
+}
+
+void
+mortonDecode3D(uint64_t const _code, uint32_t *const _x, uint32_t *const _y,
+        uint32_t *const _z)
+{
+#if defined(BITOPERATIONS_USE_BMI2)
+    *_x = (uint32_t)extractBits64(_code, MORTON3D_X);
+    *_y = (uint32_t)extractBits64(_code, MORTON3D_Y);
+    *_z = (uint32_t)extractBits64(_code, MORTON3D_Z);
+#else
+    *_x = mortonCompact3D(_code);
+    *_y = mortonCompact3D(_code >> 1);
+    *_z = mortonCompact3D(_code >> 2);
+#endif
+
+    return;
+}
+
+/**
+ * The batch functions use the magic numbers even with BMI2, as the shifts and
+ * masks vectorise over the arrays while PDEP and PEXT do not.
+ */
+void
+mortonEncode2DBatch(uint64_t *const _codes, uint32_t const *const _x,
+        uint32_t const *const _y, size_t const _n)
+{
+    for (size_t i = 0; i < _n; i++) {
+        _codes[i] = mortonSpread2D(_x[i]) | (mortonSpread2D(_y[i]) << 1);
+    }
+
+    return;
+}
+
+void
+mortonDecode2DBatch(uint32_t *const _x, uint32_t *const _y,
+        uint64_t const *const _codes, size_t const _n)
+{
+    for (size_t i = 0; i < _n; i++) {
+        _x[i] = mortonCompact2D(_codes[i]);
+        _y[i] = mortonCompact2D(_codes[i] >> 1);
+    }
+
+    return;
+}
+
+void
+mortonEncode3DBatch(uint64_t *const _codes, uint32_t const *const _x,
+        uint32_t const *const _y, uint32_t const *const _z, size_t const _n)
+{
+    for (size_t i = 0; i < _n; i++) {
+        _codes[i] = mortonSpread3D(_x[i]) | (mortonSpread3D(_y[i]) << 1)
+                | (mortonSpread3D(_z[i]) << 2);
+    }
+
+    return;
+}
+
+void
+mortonDecode3DBatch(uint32_t *const _x, uint32_t *const _y, uint32_t *const _z,
+        uint64_t const *const _codes, size_t const _n)
+{
+    for (size_t i = 0; i < _n; i++) {
+        _x[i] = mortonCompact3D(_codes[i]);
+        _y[i] = mortonCompact3D(_codes[i] >> 1);
+        _z[i] = mortonCompact3D(_codes[i] >> 2);
+    }
+
+    return;
+}
+
+/**
+ * Add the bits of one coordinate of two codes. Setting the bits of the other
+ * coordinates in _a lets the carries ripple through them.
+ */
+static uint64_t
+mortonAddDim(uint64_t const _a, uint64_t const _b, uint64_t const _dim)
+{
+    return (((_a | ~_dim) + (_b & _dim)) & _dim);
+}
+
+uint64_t
+mortonAdd2D(uint64_t const _a, uint64_t const _b)
+{
+    return (mortonAddDim(_a, _b, MORTON2D_X)
+            | mortonAddDim(_a, _b, MORTON2D_Y));
+}
+
+uint64_t
+mortonAdd3D(uint64_t const _a, uint64_t const _b)
+{
+    return (mortonAddDim(_a, _b, MORTON3D_X)
+            | mortonAddDim(_a, _b, MORTON3D_Y)
+            | mortonAddDim(_a, _b, MORTON3D_Z));
+}
+
+/**
+ * Walk the bits of the codes from high to low, comparing the bit of _code
+ * with those of _min and _max. Where _min and _max differ the box is split in
+ * the dimension of the bit: "load 1000" moves _min to the lower corner of the
+ * upper half, "load 0111" moves _max to the upper corner of the lower half.
+ * _dims holds the bits of the first dimension of an _nDims-dimensional code.
+ */
+static uint64_t
+mortonBigMinLitMax(uint64_t const _code, uint64_t _min, uint64_t _max,
+        uint64_t const _dims, uint8_t const _nDims, bool const _bigMin)
+{
+    uint8_t const top = (64 / _nDims) * _nDims;
+    uint64_t result = 0;
+
+    for (uint8_t i = top; i > 0; i--) {
+        uint64_t const bit = 1ULL << (i - 1);
+        uint64_t const lower = (_dims << ((i - 1) % _nDims)) & (bit - 1);
+        uint64_t const load1000 = (_min & ~lower) | bit;
+        uint64_t const load0111 = (_max | lower) & ~bit;
+        uint8_t const bits = ((_code & bit) ? 4 : 0) | ((_min & bit) ? 2 : 0)
+                | ((_max & bit) ? 1 : 0);
+
+        switch (bits) {
+        case 1:     /* 0, 0, 1 */
+            if (_bigMin) {
+                result = load1000;
+            }
+            _max = load0111;
+            break;
+        case 3:     /* 0, 1, 1 */
+            return (_bigMin ? _min : result);
+        case 4:     /* 1, 0, 0 */
+            return (_bigMin ? result : _max);
+        case 5:     /* 1, 0, 1 */
+            if (!_bigMin) {
+                result = load0111;
+            }
+            _min = load1000;
+            break;
+        default:    /* 0, 0, 0 or 1, 1, 1; 0, 1, 0 and 1, 1, 0 can not occur */
+            break;
+        }
+    }
+
+    return (result);
+}
+
+uint64_t
+mortonBigMin2D(uint64_t const _code, uint64_t const _min, uint64_t const _max)
+{
+    return (mortonBigMinLitMax(_code, _min, _max, MORTON2D_X, 2, true));
+}
+
+uint64_t
+mortonLitMax2D(uint64_t const _code, uint64_t const _min, uint64_t const _max)
+{
+    return (mortonBigMinLitMax(_code, _min, _max, MORTON2D_X, 2, false));
+}
+
+uint64_t
+mortonBigMin3D(uint64_t const _code, uint64_t const _min, uint64_t const _max)
+{
+    return (mortonBigMinLitMax(_code, _min, _max, MORTON3D_X, 3, true));
+}
+
+uint64_t
+mortonLitMax3D(uint64_t const _code, uint64_t const _min, uint64_t const _max)
+{
+    return (mortonBigMinLitMax(_code, _min, _max, MORTON3D_X, 3, false));
+}
+
+/********** Hilbert curve *****************************************************/
+/**
+ * Get the two bits of each level of the 2D Hilbert index of a point, in the
+ * parallel-prefix form of the state machine of the curve. The orientation of
+ * each level is kept as the four bit planes A, B, C and D, and the maps of all
+ * levels are composed from the highest level down with a log-step prefix scan
+ * instead of one level at a time, so there is no chain of dependent table
+ * loads.
+ */
+static void
+hilbertTransform2D(uint32_t const _x, uint32_t const _y, uint32_t *const _i0,
+        uint32_t *const _i1)
+{
+    uint32_t a = _x ^ _y;
+    uint32_t b = ~a;
+    uint32_t c = ~(_x | _y);
+    uint32_t d = _x & ~_y;
+    uint32_t A = a | (b >> 1);
+    uint32_t B = (a >> 1) ^ a;
+    uint32_t C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+    uint32_t D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+    for (uint8_t shift = 2; shift < 32; shift <<= 1) {
+        a = A;
+        b = B;
+        c = C;
+        d = D;
+        A = (a & (a >> shift)) ^ (b & (b >> shift));
+        B = (a & (b >> shift)) ^ (b & ((a ^ b) >> shift));
+        C = c ^ (a & (c >> shift)) ^ (b & (d >> shift));
+        D = d ^ (b & (c >> shift)) ^ ((a ^ b) & (d >> shift));
+    }
+    *_i0 = _x ^ _y;
+    *_i1 = (D ^ (D >> 1)) | ~(*_i0 | (C ^ (C >> 1)));
+
+    return;
+}
+
+#ifdef BITOPERATIONS_USE_SSE2
+/**
+ * Interleave the bits of the low and high halves of the two 64-bit lanes of
+ * _v, a perfect shuffle, so each lane is the 2D Morton code of its halves.
+ */
+static __m128i
+mortonShuffle2DSse2(__m128i _v)
+{
+    __m128i t;
+
+    t = _mm_and_si128(_mm_xor_si128(_v, _mm_srli_epi64(_v, 16)),
+            _mm_set1_epi64x(0x00000000FFFF0000LL));
+    _v = _mm_xor_si128(_v, _mm_xor_si128(t, _mm_slli_epi64(t, 16)));
+    t = _mm_and_si128(_mm_xor_si128(_v, _mm_srli_epi64(_v, 8)),
+            _mm_set1_epi64x(0x0000FF000000FF00LL));
+    _v = _mm_xor_si128(_v, _mm_xor_si128(t, _mm_slli_epi64(t, 8)));
+    t = _mm_and_si128(_mm_xor_si128(_v, _mm_srli_epi64(_v, 4)),
+            _mm_set1_epi64x(0x00F000F000F000F0LL));
+    _v = _mm_xor_si128(_v, _mm_xor_si128(t, _mm_slli_epi64(t, 4)));
+    t = _mm_and_si128(_mm_xor_si128(_v, _mm_srli_epi64(_v, 2)),
+            _mm_set1_epi64x(0x0C0C0C0C0C0C0C0CLL));
+    _v = _mm_xor_si128(_v, _mm_xor_si128(t, _mm_slli_epi64(t, 2)));
+    t = _mm_and_si128(_mm_xor_si128(_v, _mm_srli_epi64(_v, 1)),
+            _mm_set1_epi64x(0x2222222222222222LL));
+    _v = _mm_xor_si128(_v, _mm_xor_si128(t, _mm_slli_epi64(t, 1)));
+
+    return (_v);
+}
+
+/**
+ * Get the 2D Hilbert indices of four points, hilbertTransform2D on the four
+ * 32-bit lanes of a vector. The bits of the two halves of each index are
+ * then interleaved with a perfect shuffle of the 64-bit lanes.
+ */
+static void
+hilbertEncode2DSse2(uint64_t *const _indices, uint32_t const *const _x,
+        uint32_t const *const _y)
+{
+    __m128i const ones = _mm_set1_epi32(-1);
+    __m128i const x = _mm_loadu_si128((__m128i const *)_x);
+    __m128i const y = _mm_loadu_si128((__m128i const *)_y);
+    __m128i a = _mm_xor_si128(x, y);
+    __m128i b = _mm_xor_si128(a, ones);
+    __m128i c = _mm_xor_si128(_mm_or_si128(x, y), ones);
+    __m128i d = _mm_andnot_si128(y, x);
+    __m128i A = _mm_or_si128(a, _mm_srli_epi32(b, 1));
+    __m128i B = _mm_xor_si128(_mm_srli_epi32(a, 1), a);
+    __m128i C = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(c, 1),
+            _mm_and_si128(b, _mm_srli_epi32(d, 1))), c);
+    __m128i D = _mm_xor_si128(_mm_xor_si128(_mm_and_si128(a,
+            _mm_srli_epi32(c, 1)), _mm_srli_epi32(d, 1)), d);
+    __m128i ab;
+
+    /* The steps of the prefix scan, with the shifts as immediates */
+    ab = _mm_xor_si128(A, B);
+    c = _mm_xor_si128(C, _mm_xor_si128(
+            _mm_and_si128(A, _mm_srli_epi32(C, 2)),
+            _mm_and_si128(B, _mm_srli_epi32(D, 2))));
+    D = _mm_xor_si128(D, _mm_xor_si128(
+            _mm_and_si128(B, _mm_srli_epi32(C, 2)),
+            _mm_and_si128(ab, _mm_srli_epi32(D, 2))));
+    C = c;
+    a = _mm_xor_si128(_mm_and_si128(A, _mm_srli_epi32(A, 2)),
+            _mm_and_si128(B, _mm_srli_epi32(B, 2)));
+    B = _mm_xor_si128(_mm_and_si128(A, _mm_srli_epi32(B, 2)),
+            _mm_and_si128(B, _mm_srli_epi32(ab, 2)));
+    A = a;
+    ab = _mm_xor_si128(A, B);
+    c = _mm_xor_si128(C, _mm_xor_si128(
+            _mm_and_si128(A, _mm_srli_epi32(C, 4)),
+            _mm_and_si128(B, _mm_srli_epi32(D, 4))));
+    D = _mm_xor_si128(D, _mm_xor_si128(
+            _mm_and_si128(B, _mm_srli_epi32(C, 4)),
+            _mm_and_si128(ab, _mm_srli_epi32(D, 4))));
+    C = c;
+    a = _mm_xor_si128(_mm_and_si128(A, _mm_srli_epi32(A, 4)),
+            _mm_and_si128(B, _mm_srli_epi32(B, 4)));
+    B = _mm_xor_si128(_mm_and_si128(A, _mm_srli_epi32(B, 4)),
+            _mm_and_si128(B, _mm_srli_epi32(ab, 4)));
+    A = a;
+    ab = _mm_xor_si128(A, B);
+    c = _mm_xor_si128(C, _mm_xor_si128(
+            _mm_and_si128(A, _mm_srli_epi32(C, 8)),
+            _mm_and_si128(B, _mm_srli_epi32(D, 8))));
+    D = _mm_xor_si128(D, _mm_xor_si128(
+            _mm_and_si128(B, _mm_srli_epi32(C, 8)),
+            _mm_and_si128(ab, _mm_srli_epi32(D, 8))));
+    C = c;
+    a = _mm_xor_si128(_mm_and_si128(A, _mm_srli_epi32(A, 8)),
+            _mm_and_si128(B, _mm_srli_epi32(B, 8)));
+    B = _mm_xor_si128(_mm_and_si128(A, _mm_srli_epi32(B, 8)),
+            _mm_and_si128(B, _mm_srli_epi32(ab, 8)));
+    A = a;
+    ab = _mm_xor_si128(A, B);
+    c = _mm_xor_si128(C, _mm_xor_si128(
+            _mm_and_si128(A, _mm_srli_epi32(C, 16)),
+            _mm_and_si128(B, _mm_srli_epi32(D, 16))));
+    D = _mm_xor_si128(D, _mm_xor_si128(
+            _mm_and_si128(B, _mm_srli_epi32(C, 16)),
+            _mm_and_si128(ab, _mm_srli_epi32(D, 16))));
+    C = c;
+    a = _mm_xor_si128(_mm_and_si128(A, _mm_srli_epi32(A, 16)),
+            _mm_and_si128(B, _mm_srli_epi32(B, 16)));
+    B = _mm_xor_si128(_mm_and_si128(A, _mm_srli_epi32(B, 16)),
+            _mm_and_si128(B, _mm_srli_epi32(ab, 16)));
+    A = a;
+    a = _mm_xor_si128(C, _mm_srli_epi32(C, 1));
+    b = _mm_xor_si128(D, _mm_srli_epi32(D, 1));
+    c = _mm_xor_si128(x, y);
+    d = _mm_or_si128(b, _mm_andnot_si128(_mm_or_si128(c, a), ones));
+    _mm_storeu_si128((__m128i *)&_indices[0],
+            mortonShuffle2DSse2(_mm_unpacklo_epi32(c, d)));
+    _mm_storeu_si128((__m128i *)&_indices[2],
+            mortonShuffle2DSse2(_mm_unpackhi_epi32(c, d)));
+
+    return;
+}
+#endif
+
+/**
+ * Get the point of the two bits of each level of a 2D Hilbert index, the
+ * inverse of hilbertTransform2D. The orientation of a level is the parity of
+ * the number of levels above it that flip (both bits zero) or swap (both bits
+ * one) the sub-square, which is a suffix XOR scan.
+ */
+static void
+hilbertInverseTransform2D(uint32_t const _i0, uint32_t const _i1,
+        uint32_t *const _x, uint32_t *const _y)
+{
+    uint32_t flip = ~(_i0 | _i1);
+    uint32_t swap = _i0 & _i1;
+    uint32_t a;
+
+    for (uint8_t shift = 16; shift > 0; shift >>= 1) {
+        flip ^= flip >> shift;
+        swap ^= swap >> shift;
+    }
+    a = (~_i0 & swap) | (_i0 & flip);
+    *_x = a ^ _i1;
+    *_y = a ^ _i0 ^ _i1;
+
+    return;
+}
+
+/**
+ * Output digit and next state of the highest level of a 3D Hilbert index,
+ * indexed by the highest level (three bits) of the Morton code. Each entry
+ * holds the digit of the Hilbert index in the lowest three bits and the next
+ * state, times 64, in the highest bits.
+ */
+static uint16_t const hilbert3DEncodeTop[8] = {
+    0x040, 0x087, 0x0C3, 0x104, 0x141, 0x186, 0x002, 0x005
+};
+
+/**
+ * State table to get two levels of a 3D Hilbert index, indexed by the state
+ * times 64 plus two levels (six bits) of the Morton code. Each entry holds the
+ * two levels of the Hilbert index in the lowest six bits and the next state,
+ * times 64, in the highest bits, so it is the base of the next lookup.
+ */
+static uint16_t const hilbert3DEncodeTable[24 * 64] = {
+    0x1C0, 0x203, 0x241, 0x042, 0x287, 0x144, 0x2C6, 0x045,
+    0x33C, 0x37F, 0x0BD, 0x27E, 0x1BB, 0x3B8, 0x0BA, 0x2F9,
+    0x35E, 0x25F, 0x0DD, 0x3DC, 0x399, 0x2D8, 0x0DA, 0x01B,
+    0x260, 0x1E1, 0x3E3, 0x122, 0x2E7, 0x2A6, 0x024, 0x125,
+    0x108, 0x40B, 0x44F, 0x04C, 0x009, 0x14A, 0x48E, 0x14D,
+    0x4F4, 0x0F7, 0x0B3, 0x530, 0x1B5, 0x036, 0x1B2, 0x4B1,
+    0x050, 0x097, 0x0D3, 0x114, 0x151, 0x196, 0x012, 0x015,
+    0x068, 0x0AF, 0x0EB, 0x12C, 0x169, 0x1AE, 0x02A, 0x02D,
+    0x000, 0x101, 0x487, 0x446, 0x543, 0x1C2, 0x244, 0x1C5,
+    0x3DE, 0x21D, 0x599, 0x21A, 0x11F, 0x41C, 0x458, 0x05B,
+    0x148, 0x18F, 0x049, 0x08E, 0x34B, 0x1CC, 0x24A, 0x24D,
+    0x1D0, 0x213, 0x251, 0x052, 0x297, 0x154, 0x2D6, 0x055,
+    0x5FC, 0x2BD, 0x2FB, 0x2BA, 0x3FF, 0x13E, 0x5B8, 0x479,
+    0x120, 0x423, 0x467, 0x064, 0x021, 0x162, 0x4A6, 0x165,
+    0x3B4, 0x2B3, 0x2F5, 0x2F2, 0x237, 0x330, 0x076, 0x0B1,
+    0x1E8, 0x22B, 0x269, 0x06A, 0x2AF, 0x16C, 0x2EE, 0x06D,
+    0x322, 0x3E1, 0x325, 0x5A6, 0x4E3, 0x0E0, 0x0A4, 0x527,
+    0x0FE, 0x03F, 0x539, 0x4B8, 0x37D, 0x57C, 0x37A, 0x27B,
+    0x32C, 0x36F, 0x0AD, 0x26E, 0x1AB, 0x3A8, 0x0AA, 0x2E9,
+    0x170, 0x1B7, 0x071, 0x0B6, 0x373, 0x1F4, 0x272, 0x275,
+    0x4DC, 0x0DF, 0x09B, 0x518, 0x19D, 0x01E, 0x19A, 0x499,
+    0x382, 0x5C3, 0x385, 0x2C4, 0x0C1, 0x3C0, 0x506, 0x587,
+    0x314, 0x357, 0x095, 0x256, 0x193, 0x390, 0x092, 0x2D1,
+    0x38C, 0x28B, 0x2CD, 0x2CA, 0x20F, 0x308, 0x04E, 0x089,
+    0x0F6, 0x037, 0x531, 0x4B0, 0x375, 0x574, 0x372, 0x273,
+    0x178, 0x1BF, 0x079, 0x0BE, 0x37B, 0x1FC, 0x27A, 0x27D,
+    0x36E, 0x26F, 0x0ED, 0x3EC, 0x3A9, 0x2E8, 0x0EA, 0x02B,
+    0x226, 0x321, 0x3E5, 0x3E2, 0x067, 0x0A0, 0x0E4, 0x123,
+    0x38A, 0x5CB, 0x38D, 0x2CC, 0x0C9, 0x3C8, 0x50E, 0x58F,
+    0x384, 0x283, 0x2C5, 0x2C2, 0x207, 0x300, 0x046, 0x081,
+    0x356, 0x257, 0x0D5, 0x3D4, 0x391, 0x2D0, 0x0D2, 0x013,
+    0x058, 0x09F, 0x0DB, 0x11C, 0x159, 0x19E, 0x01A, 0x01D,
+    0x140, 0x187, 0x041, 0x086, 0x343, 0x1C4, 0x242, 0x245,
+    0x008, 0x109, 0x48F, 0x44E, 0x54B, 0x1CA, 0x24C, 0x1CD,
+    0x21E, 0x319, 0x3DD, 0x3DA, 0x05F, 0x098, 0x0DC, 0x11B,
+    0x250, 0x1D1, 0x3D3, 0x112, 0x2D7, 0x296, 0x014, 0x115,
+    0x3BC, 0x2BB, 0x2FD, 0x2FA, 0x23F, 0x338, 0x07E, 0x0B9,
+    0x5F4, 0x2B5, 0x2F3, 0x2B2, 0x3F7, 0x136, 0x5B0, 0x471,
+    0x060, 0x0A7, 0x0E3, 0x124, 0x161, 0x1A6, 0x022, 0x025,
+    0x268, 0x1E9, 0x3EB, 0x12A, 0x2EF, 0x2AE, 0x02C, 0x12D,
+    0x240, 0x1C1, 0x3C3, 0x102, 0x2C7, 0x286, 0x004, 0x105,
+    0x55E, 0x41D, 0x1DF, 0x21C, 0x5D9, 0x41A, 0x298, 0x15B,
+    0x5BC, 0x47D, 0x57F, 0x1FE, 0x4BB, 0x47A, 0x5F8, 0x2B9,
+    0x1E0, 0x223, 0x261, 0x062, 0x2A7, 0x164, 0x2E6, 0x065,
+    0x048, 0x08F, 0x0CB, 0x10C, 0x149, 0x18E, 0x00A, 0x00D,
+    0x110, 0x413, 0x457, 0x054, 0x011, 0x152, 0x496, 0x155,
+    0x534, 0x473, 0x437, 0x4F0, 0x4B5, 0x4B2, 0x176, 0x1B1,
+    0x128, 0x42B, 0x46F, 0x06C, 0x029, 0x16A, 0x4AE, 0x16D,
+    0x4E2, 0x561, 0x323, 0x360, 0x4E5, 0x5E6, 0x1A4, 0x3A7,
+    0x37E, 0x27F, 0x0FD, 0x3FC, 0x3B9, 0x2F8, 0x0FA, 0x03B,
+    0x31C, 0x35F, 0x09D, 0x25E, 0x19B, 0x398, 0x09A, 0x2D9,
+    0x502, 0x583, 0x341, 0x540, 0x505, 0x484, 0x386, 0x5C7,
+    0x4EC, 0x0EF, 0x0AB, 0x528, 0x1AD, 0x02E, 0x1AA, 0x4A9,
+    0x070, 0x0B7, 0x0F3, 0x134, 0x171, 0x1B6, 0x032, 0x035,
+    0x4D4, 0x0D7, 0x093, 0x510, 0x195, 0x016, 0x192, 0x491,
+    0x50C, 0x44B, 0x40F, 0x4C8, 0x48D, 0x48A, 0x14E, 0x189,
+    0x040, 0x087, 0x0C3, 0x104, 0x141, 0x186, 0x002, 0x005,
+    0x248, 0x1C9, 0x3CB, 0x10A, 0x2CF, 0x28E, 0x00C, 0x10D,
+    0x53C, 0x47B, 0x43F, 0x4F8, 0x4BD, 0x4BA, 0x17E, 0x1B9,
+    0x5B4, 0x475, 0x577, 0x1F6, 0x4B3, 0x472, 0x5F0, 0x2B1,
+    0x41E, 0x4D9, 0x15F, 0x198, 0x55D, 0x55A, 0x35C, 0x1DB,
+    0x010, 0x111, 0x497, 0x456, 0x553, 0x1D2, 0x254, 0x1D5,
+    0x160, 0x1A7, 0x061, 0x0A6, 0x363, 0x1E4, 0x262, 0x265,
+    0x028, 0x129, 0x4AF, 0x46E, 0x56B, 0x1EA, 0x26C, 0x1ED,
+    0x236, 0x331, 0x3F5, 0x3F2, 0x077, 0x0B0, 0x0F4, 0x133,
+    0x3EE, 0x22D, 0x5A9, 0x22A, 0x12F, 0x42C, 0x468, 0x06B,
+    0x58A, 0x58D, 0x209, 0x30E, 0x50B, 0x44C, 0x408, 0x4CF,
+    0x3D6, 0x215, 0x591, 0x212, 0x117, 0x414, 0x450, 0x053,
+    0x278, 0x1F9, 0x3FB, 0x13A, 0x2FF, 0x2BE, 0x03C, 0x13D,
+    0x566, 0x425, 0x1E7, 0x224, 0x5E1, 0x422, 0x2A0, 0x163,
+    0x584, 0x445, 0x547, 0x1C6, 0x483, 0x442, 0x5C0, 0x281,
+    0x1D8, 0x21B, 0x259, 0x05A, 0x29F, 0x15C, 0x2DE, 0x05D,
+    0x100, 0x403, 0x447, 0x044, 0x001, 0x142, 0x486, 0x145,
+    0x4FC, 0x0FF, 0x0BB, 0x538, 0x1BD, 0x03E, 0x1BA, 0x4B9,
+    0x1C8, 0x20B, 0x249, 0x04A, 0x28F, 0x14C, 0x2CE, 0x04D,
+    0x334, 0x377, 0x0B5, 0x276, 0x1B3, 0x3B0, 0x0B2, 0x2F1,
+    0x0DE, 0x01F, 0x519, 0x498, 0x35D, 0x55C, 0x35A, 0x25B,
+    0x020, 0x121, 0x4A7, 0x466, 0x563, 0x1E2, 0x264, 0x1E5,
+    0x150, 0x197, 0x051, 0x096, 0x353, 0x1D4, 0x252, 0x255,
+    0x168, 0x1AF, 0x069, 0x0AE, 0x36B, 0x1EC, 0x26A, 0x26D,
+    0x5E2, 0x5E5, 0x3A3, 0x2A4, 0x421, 0x4E6, 0x220, 0x327,
+    0x5EC, 0x2AD, 0x2EB, 0x2AA, 0x3EF, 0x12E, 0x5A8, 0x469,
+    0x39C, 0x29B, 0x2DD, 0x2DA, 0x21F, 0x318, 0x05E, 0x099,
+    0x5D4, 0x295, 0x2D3, 0x292, 0x3D7, 0x116, 0x590, 0x451,
+    0x23E, 0x339, 0x3FD, 0x3FA, 0x07F, 0x0B8, 0x0FC, 0x13B,
+    0x270, 0x1F1, 0x3F3, 0x132, 0x2F7, 0x2B6, 0x034, 0x135,
+    0x582, 0x585, 0x201, 0x306, 0x503, 0x444, 0x400, 0x4C7,
+    0x58C, 0x44D, 0x54F, 0x1CE, 0x48B, 0x44A, 0x5C8, 0x289,
+    0x3A2, 0x5E3, 0x3A5, 0x2E4, 0x0E1, 0x3E0, 0x526, 0x5A7,
+    0x5DC, 0x29D, 0x2DB, 0x29A, 0x3DF, 0x11E, 0x598, 0x459,
+    0x3AC, 0x2AB, 0x2ED, 0x2EA, 0x22F, 0x328, 0x06E, 0x0A9,
+    0x394, 0x293, 0x2D5, 0x2D2, 0x217, 0x310, 0x056, 0x091,
+    0x3FE, 0x23D, 0x5B9, 0x23A, 0x13F, 0x43C, 0x478, 0x07B,
+    0x302, 0x3C1, 0x305, 0x586, 0x4C3, 0x0C0, 0x084, 0x507,
+    0x1F0, 0x233, 0x271, 0x072, 0x2B7, 0x174, 0x2F6, 0x075,
+    0x30C, 0x34F, 0x08D, 0x24E, 0x18B, 0x388, 0x08A, 0x2C9,
+    0x312, 0x3D1, 0x315, 0x596, 0x4D3, 0x0D0, 0x094, 0x517,
+    0x20E, 0x309, 0x3CD, 0x3CA, 0x04F, 0x088, 0x0CC, 0x10B,
+    0x32A, 0x3E9, 0x32D, 0x5AE, 0x4EB, 0x0E8, 0x0AC, 0x52F,
+    0x5B2, 0x5B5, 0x231, 0x336, 0x533, 0x474, 0x430, 0x4F7,
+    0x4DA, 0x559, 0x31B, 0x358, 0x4DD, 0x5DE, 0x19C, 0x39F,
+    0x346, 0x247, 0x0C5, 0x3C4, 0x381, 0x2C0, 0x0C2, 0x003,
+    0x324, 0x367, 0x0A5, 0x266, 0x1A3, 0x3A0, 0x0A2, 0x2E1,
+    0x53A, 0x5BB, 0x379, 0x578, 0x53D, 0x4BC, 0x3BE, 0x5FF,
+    0x376, 0x277, 0x0F5, 0x3F4, 0x3B1, 0x2F0, 0x0F2, 0x033,
+    0x078, 0x0BF, 0x0FB, 0x13C, 0x179, 0x1BE, 0x03A, 0x03D,
+    0x50A, 0x58B, 0x349, 0x548, 0x50D, 0x48C, 0x38E, 0x5CF,
+    0x504, 0x443, 0x407, 0x4C0, 0x485, 0x482, 0x146, 0x181,
+    0x0EE, 0x02F, 0x529, 0x4A8, 0x36D, 0x56C, 0x36A, 0x26B,
+    0x426, 0x4E1, 0x167, 0x1A0, 0x565, 0x562, 0x364, 0x1E3,
+    0x0D6, 0x017, 0x511, 0x490, 0x355, 0x554, 0x352, 0x253,
+    0x158, 0x19F, 0x059, 0x09E, 0x35B, 0x1DC, 0x25A, 0x25D,
+    0x392, 0x5D3, 0x395, 0x2D4, 0x0D1, 0x3D0, 0x516, 0x597,
+    0x5DA, 0x5DD, 0x39B, 0x29C, 0x419, 0x4DE, 0x218, 0x31F,
+    0x3AA, 0x5EB, 0x3AD, 0x2EC, 0x0E9, 0x3E8, 0x52E, 0x5AF,
+    0x3A4, 0x2A3, 0x2E5, 0x2E2, 0x227, 0x320, 0x066, 0x0A1,
+    0x34E, 0x24F, 0x0CD, 0x3CC, 0x389, 0x2C8, 0x0CA, 0x00B,
+    0x206, 0x301, 0x3C5, 0x3C2, 0x047, 0x080, 0x0C4, 0x103,
+    0x532, 0x5B3, 0x371, 0x570, 0x535, 0x4B4, 0x3B6, 0x5F7,
+    0x5BA, 0x5BD, 0x239, 0x33E, 0x53B, 0x47C, 0x438, 0x4FF,
+    0x3F6, 0x235, 0x5B1, 0x232, 0x137, 0x434, 0x470, 0x073,
+    0x30A, 0x3C9, 0x30D, 0x58E, 0x4CB, 0x0C8, 0x08C, 0x50F,
+    0x22E, 0x329, 0x3ED, 0x3EA, 0x06F, 0x0A8, 0x0EC, 0x12B,
+    0x216, 0x311, 0x3D5, 0x3D2, 0x057, 0x090, 0x0D4, 0x113,
+    0x1F8, 0x23B, 0x279, 0x07A, 0x2BF, 0x17C, 0x2FE, 0x07D,
+    0x304, 0x347, 0x085, 0x246, 0x183, 0x380, 0x082, 0x2C1,
+    0x366, 0x267, 0x0E5, 0x3E4, 0x3A1, 0x2E0, 0x0E2, 0x023,
+    0x258, 0x1D9, 0x3DB, 0x11A, 0x2DF, 0x29E, 0x01C, 0x11D,
+    0x436, 0x4F1, 0x177, 0x1B0, 0x575, 0x572, 0x374, 0x1F3,
+    0x56E, 0x42D, 0x1EF, 0x22C, 0x5E9, 0x42A, 0x2A8, 0x16B,
+    0x038, 0x139, 0x4BF, 0x47E, 0x57B, 0x1FA, 0x27C, 0x1FD,
+    0x3E6, 0x225, 0x5A1, 0x222, 0x127, 0x424, 0x460, 0x063,
+    0x5CA, 0x5CD, 0x38B, 0x28C, 0x409, 0x4CE, 0x208, 0x30F,
+    0x556, 0x415, 0x1D7, 0x214, 0x5D1, 0x412, 0x290, 0x153,
+    0x5C4, 0x285, 0x2C3, 0x282, 0x3C7, 0x106, 0x580, 0x441,
+    0x118, 0x41B, 0x45F, 0x05C, 0x019, 0x15A, 0x49E, 0x15D,
+    0x5A2, 0x5A5, 0x221, 0x326, 0x523, 0x464, 0x420, 0x4E7,
+    0x5AC, 0x46D, 0x56F, 0x1EE, 0x4AB, 0x46A, 0x5E8, 0x2A9,
+    0x43E, 0x4F9, 0x17F, 0x1B8, 0x57D, 0x57A, 0x37C, 0x1FB,
+    0x030, 0x131, 0x4B7, 0x476, 0x573, 0x1F2, 0x274, 0x1F5,
+    0x51C, 0x45B, 0x41F, 0x4D8, 0x49D, 0x49A, 0x15E, 0x199,
+    0x594, 0x455, 0x557, 0x1D6, 0x493, 0x452, 0x5D0, 0x291,
+    0x5C2, 0x5C5, 0x383, 0x284, 0x401, 0x4C6, 0x200, 0x307,
+    0x5CC, 0x28D, 0x2CB, 0x28A, 0x3CF, 0x10E, 0x588, 0x449,
+    0x522, 0x5A3, 0x361, 0x560, 0x525, 0x4A4, 0x3A6, 0x5E7,
+    0x59C, 0x45D, 0x55F, 0x1DE, 0x49B, 0x45A, 0x5D8, 0x299,
+    0x57E, 0x43D, 0x1FF, 0x23C, 0x5F9, 0x43A, 0x2B8, 0x17B,
+    0x4C2, 0x541, 0x303, 0x340, 0x4C5, 0x5C6, 0x184, 0x387,
+    0x52C, 0x46B, 0x42F, 0x4E8, 0x4AD, 0x4AA, 0x16E, 0x1A9,
+    0x514, 0x453, 0x417, 0x4D0, 0x495, 0x492, 0x156, 0x191,
+    0x130, 0x433, 0x477, 0x074, 0x031, 0x172, 0x4B6, 0x175,
+    0x4CC, 0x0CF, 0x08B, 0x508, 0x18D, 0x00E, 0x18A, 0x489,
+    0x4D2, 0x551, 0x313, 0x350, 0x4D5, 0x5D6, 0x194, 0x397,
+    0x40E, 0x4C9, 0x14F, 0x188, 0x54D, 0x54A, 0x34C, 0x1CB,
+    0x31A, 0x3D9, 0x31D, 0x59E, 0x4DB, 0x0D8, 0x09C, 0x51F,
+    0x0C6, 0x007, 0x501, 0x480, 0x345, 0x544, 0x342, 0x243,
+    0x4EA, 0x569, 0x32B, 0x368, 0x4ED, 0x5EE, 0x1AC, 0x3AF,
+    0x5F2, 0x5F5, 0x3B3, 0x2B4, 0x431, 0x4F6, 0x230, 0x337,
+    0x4E4, 0x0E7, 0x0A3, 0x520, 0x1A5, 0x026, 0x1A2, 0x4A1,
+    0x3BA, 0x5FB, 0x3BD, 0x2FC, 0x0F9, 0x3F8, 0x53E, 0x5BF,
+    0x512, 0x593, 0x351, 0x550, 0x515, 0x494, 0x396, 0x5D7,
+    0x59A, 0x59D, 0x219, 0x31E, 0x51B, 0x45C, 0x418, 0x4DF,
+    0x0CE, 0x00F, 0x509, 0x488, 0x34D, 0x54C, 0x34A, 0x24B,
+    0x406, 0x4C1, 0x147, 0x180, 0x545, 0x542, 0x344, 0x1C3,
+    0x52A, 0x5AB, 0x369, 0x568, 0x52D, 0x4AC, 0x3AE, 0x5EF,
+    0x524, 0x463, 0x427, 0x4E0, 0x4A5, 0x4A2, 0x166, 0x1A1,
+    0x3B2, 0x5F3, 0x3B5, 0x2F4, 0x0F1, 0x3F0, 0x536, 0x5B7,
+    0x5FA, 0x5FD, 0x3BB, 0x2BC, 0x439, 0x4FE, 0x238, 0x33F,
+    0x576, 0x435, 0x1F7, 0x234, 0x5F1, 0x432, 0x2B0, 0x173,
+    0x4CA, 0x549, 0x30B, 0x348, 0x4CD, 0x5CE, 0x18C, 0x38F,
+    0x138, 0x43B, 0x47F, 0x07C, 0x039, 0x17A, 0x4BE, 0x17D,
+    0x4C4, 0x0C7, 0x083, 0x500, 0x185, 0x006, 0x182, 0x481,
+    0x42E, 0x4E9, 0x16F, 0x1A8, 0x56D, 0x56A, 0x36C, 0x1EB,
+    0x416, 0x4D1, 0x157, 0x190, 0x555, 0x552, 0x354, 0x1D3,
+    0x0E6, 0x027, 0x521, 0x4A0, 0x365, 0x564, 0x362, 0x263,
+    0x018, 0x119, 0x49F, 0x45E, 0x55B, 0x1DA, 0x25C, 0x1DD,
+    0x592, 0x595, 0x211, 0x316, 0x513, 0x454, 0x410, 0x4D7,
+    0x5AA, 0x5AD, 0x229, 0x32E, 0x52B, 0x46C, 0x428, 0x4EF,
+    0x3CE, 0x20D, 0x589, 0x20A, 0x10F, 0x40C, 0x448, 0x04B,
+    0x332, 0x3F1, 0x335, 0x5B6, 0x4F3, 0x0F0, 0x0B4, 0x537,
+    0x51A, 0x59B, 0x359, 0x558, 0x51D, 0x49C, 0x39E, 0x5DF,
+    0x5A4, 0x465, 0x567, 0x1E6, 0x4A3, 0x462, 0x5E0, 0x2A1,
+    0x546, 0x405, 0x1C7, 0x204, 0x5C1, 0x402, 0x280, 0x143,
+    0x4FA, 0x579, 0x33B, 0x378, 0x4FD, 0x5FE, 0x1BC, 0x3BF,
+    0x5D2, 0x5D5, 0x393, 0x294, 0x411, 0x4D6, 0x210, 0x317,
+    0x5EA, 0x5ED, 0x3AB, 0x2AC, 0x429, 0x4EE, 0x228, 0x32F,
+    0x39A, 0x5DB, 0x39D, 0x2DC, 0x0D9, 0x3D8, 0x51E, 0x59F,
+    0x5E4, 0x2A5, 0x2E3, 0x2A2, 0x3E7, 0x126, 0x5A0, 0x461,
+    0x54E, 0x40D, 0x1CF, 0x20C, 0x5C9, 0x40A, 0x288, 0x14B,
+    0x4F2, 0x571, 0x333, 0x370, 0x4F5, 0x5F6, 0x1B4, 0x3B7,
+    0x3C6, 0x205, 0x581, 0x202, 0x107, 0x404, 0x440, 0x043,
+    0x33A, 0x3F9, 0x33D, 0x5BE, 0x4FB, 0x0F8, 0x0BC, 0x53F
+};
+
+/**
+ * Output digit and next state of the highest level of a 3D Morton code from
+ * the Hilbert index, the inverse of hilbert3DEncodeTop.
+ */
+static uint16_t const hilbert3DDecodeTop[8] = {
+    0x040, 0x144, 0x006, 0x0C2, 0x103, 0x007, 0x185, 0x081
+};
+
+/**
+ * State table to get two levels of a 3D Morton code from the Hilbert index,
+ * the inverse of hilbert3DEncodeTable.
+ */
+static uint16_t const hilbert3DDecodeTable[24 * 64] = {
+    0x1C0, 0x242, 0x043, 0x201, 0x145, 0x047, 0x2C6, 0x284,
+    0x120, 0x024, 0x165, 0x421, 0x063, 0x167, 0x4A6, 0x462,
+    0x070, 0x174, 0x036, 0x0F2, 0x133, 0x037, 0x1B5, 0x0B1,
+    0x2D5, 0x394, 0x0D6, 0x017, 0x3D3, 0x0D2, 0x350, 0x251,
+    0x258, 0x1D9, 0x11B, 0x3DA, 0x01E, 0x11F, 0x29D, 0x2DC,
+    0x078, 0x17C, 0x03E, 0x0FA, 0x13B, 0x03F, 0x1BD, 0x0B9,
+    0x52B, 0x4AF, 0x1AE, 0x0AA, 0x4E8, 0x1AC, 0x02D, 0x0E9,
+    0x38D, 0x2CF, 0x08E, 0x18C, 0x308, 0x08A, 0x24B, 0x349,
+    0x000, 0x101, 0x1C5, 0x544, 0x246, 0x1C7, 0x443, 0x482,
+    0x150, 0x052, 0x256, 0x354, 0x1D5, 0x257, 0x093, 0x191,
+    0x1D8, 0x25A, 0x05B, 0x219, 0x15D, 0x05F, 0x2DE, 0x29C,
+    0x44E, 0x58A, 0x20B, 0x04F, 0x40D, 0x209, 0x3C8, 0x10C,
+    0x128, 0x02C, 0x16D, 0x429, 0x06B, 0x16F, 0x4AE, 0x46A,
+    0x1F8, 0x27A, 0x07B, 0x239, 0x17D, 0x07F, 0x2FE, 0x2BC,
+    0x335, 0x0B7, 0x2F3, 0x2B1, 0x3B0, 0x2F2, 0x076, 0x234,
+    0x5A6, 0x467, 0x2A3, 0x2E2, 0x5E0, 0x2A1, 0x125, 0x3E4,
+    0x3ED, 0x0EC, 0x3A8, 0x5E9, 0x2EB, 0x3AA, 0x52E, 0x5AF,
+    0x33D, 0x0BF, 0x2FB, 0x2B9, 0x3B8, 0x2FA, 0x07E, 0x23C,
+    0x3B5, 0x2F7, 0x0B6, 0x1B4, 0x330, 0x0B2, 0x273, 0x371,
+    0x523, 0x4A7, 0x1A6, 0x0A2, 0x4E0, 0x1A4, 0x025, 0x0E1,
+    0x0C5, 0x3C1, 0x300, 0x4C4, 0x086, 0x302, 0x583, 0x507,
+    0x395, 0x2D7, 0x096, 0x194, 0x310, 0x092, 0x253, 0x351,
+    0x158, 0x05A, 0x25E, 0x35C, 0x1DD, 0x25F, 0x09B, 0x199,
+    0x48B, 0x50A, 0x34E, 0x24F, 0x54D, 0x34C, 0x0C8, 0x009,
+    0x32D, 0x0AF, 0x2EB, 0x2A9, 0x3A8, 0x2EA, 0x06E, 0x22C,
+    0x3E5, 0x0E4, 0x3A0, 0x5E1, 0x2E3, 0x3A2, 0x526, 0x5A7,
+    0x2F5, 0x3B4, 0x0F6, 0x037, 0x3F3, 0x0F2, 0x370, 0x271,
+    0x078, 0x17C, 0x03E, 0x0FA, 0x13B, 0x03F, 0x1BD, 0x0B9,
+    0x09D, 0x319, 0x3DB, 0x11F, 0x0DE, 0x3DA, 0x218, 0x05C,
+    0x2D5, 0x394, 0x0D6, 0x017, 0x3D3, 0x0D2, 0x350, 0x251,
+    0x483, 0x502, 0x346, 0x247, 0x545, 0x344, 0x0C0, 0x001,
+    0x148, 0x04A, 0x24E, 0x34C, 0x1CD, 0x24F, 0x08B, 0x189,
+    0x140, 0x042, 0x246, 0x344, 0x1C5, 0x247, 0x083, 0x181,
+    0x008, 0x109, 0x1CD, 0x54C, 0x24E, 0x1CF, 0x44B, 0x48A,
+    0x258, 0x1D9, 0x11B, 0x3DA, 0x01E, 0x11F, 0x29D, 0x2DC,
+    0x095, 0x311, 0x3D3, 0x117, 0x0D6, 0x3D2, 0x210, 0x054,
+    0x070, 0x174, 0x036, 0x0F2, 0x133, 0x037, 0x1B5, 0x0B1,
+    0x278, 0x1F9, 0x13B, 0x3FA, 0x03E, 0x13F, 0x2BD, 0x2FC,
+    0x5AE, 0x46F, 0x2AB, 0x2EA, 0x5E8, 0x2A9, 0x12D, 0x3EC,
+    0x325, 0x0A7, 0x2E3, 0x2A1, 0x3A0, 0x2E2, 0x066, 0x224,
+    0x240, 0x1C1, 0x103, 0x3C2, 0x006, 0x107, 0x285, 0x2C4,
+    0x060, 0x164, 0x026, 0x0E2, 0x123, 0x027, 0x1A5, 0x0A1,
+    0x128, 0x02C, 0x16D, 0x429, 0x06B, 0x16F, 0x4AE, 0x46A,
+    0x28E, 0x5CC, 0x40D, 0x14F, 0x20B, 0x409, 0x548, 0x1CA,
+    0x1D8, 0x25A, 0x05B, 0x219, 0x15D, 0x05F, 0x2DE, 0x29C,
+    0x138, 0x03C, 0x17D, 0x439, 0x07B, 0x17F, 0x4BE, 0x47A,
+    0x4F3, 0x1B7, 0x4B5, 0x471, 0x530, 0x4B4, 0x176, 0x432,
+    0x5D6, 0x297, 0x455, 0x494, 0x590, 0x451, 0x1D3, 0x552,
+    0x55B, 0x35A, 0x518, 0x599, 0x49D, 0x51C, 0x39E, 0x5DF,
+    0x4FB, 0x1BF, 0x4BD, 0x479, 0x538, 0x4BC, 0x17E, 0x43A,
+    0x533, 0x4B7, 0x1B6, 0x0B2, 0x4F0, 0x1B4, 0x035, 0x0F1,
+    0x395, 0x2D7, 0x096, 0x194, 0x310, 0x092, 0x253, 0x351,
+    0x343, 0x541, 0x4C0, 0x302, 0x186, 0x4C4, 0x5C5, 0x387,
+    0x523, 0x4A7, 0x1A6, 0x0A2, 0x4E0, 0x1A4, 0x025, 0x0E1,
+    0x068, 0x16C, 0x02E, 0x0EA, 0x12B, 0x02F, 0x1AD, 0x0A9,
+    0x2CD, 0x38C, 0x0CE, 0x00F, 0x3CB, 0x0CA, 0x348, 0x249,
+    0x040, 0x144, 0x006, 0x0C2, 0x103, 0x007, 0x185, 0x081,
+    0x248, 0x1C9, 0x10B, 0x3CA, 0x00E, 0x10F, 0x28D, 0x2CC,
+    0x028, 0x129, 0x1ED, 0x56C, 0x26E, 0x1EF, 0x46B, 0x4AA,
+    0x1A3, 0x4E1, 0x565, 0x1E7, 0x366, 0x564, 0x420, 0x162,
+    0x170, 0x072, 0x276, 0x374, 0x1F5, 0x277, 0x0B3, 0x1B1,
+    0x038, 0x139, 0x1FD, 0x57C, 0x27E, 0x1FF, 0x47B, 0x4BA,
+    0x5DE, 0x29F, 0x45D, 0x49C, 0x598, 0x459, 0x1DB, 0x55A,
+    0x4D3, 0x197, 0x495, 0x451, 0x510, 0x494, 0x156, 0x412,
+    0x5F6, 0x2B7, 0x475, 0x4B4, 0x5B0, 0x471, 0x1F3, 0x572,
+    0x416, 0x212, 0x590, 0x514, 0x455, 0x591, 0x313, 0x4D7,
+    0x45E, 0x59A, 0x21B, 0x05F, 0x41D, 0x219, 0x3D8, 0x11C,
+    0x1F8, 0x27A, 0x07B, 0x239, 0x17D, 0x07F, 0x2FE, 0x2BC,
+    0x2AE, 0x5EC, 0x42D, 0x16F, 0x22B, 0x429, 0x568, 0x1EA,
+    0x44E, 0x58A, 0x20B, 0x04F, 0x40D, 0x209, 0x3C8, 0x10C,
+    0x085, 0x301, 0x3C3, 0x107, 0x0C6, 0x3C2, 0x200, 0x044,
+    0x260, 0x1E1, 0x123, 0x3E2, 0x026, 0x127, 0x2A5, 0x2E4,
+    0x100, 0x004, 0x145, 0x401, 0x043, 0x147, 0x486, 0x442,
+    0x1D0, 0x252, 0x053, 0x211, 0x155, 0x057, 0x2D6, 0x294,
+    0x170, 0x072, 0x276, 0x374, 0x1F5, 0x277, 0x0B3, 0x1B1,
+    0x4A3, 0x522, 0x366, 0x267, 0x565, 0x364, 0x0E0, 0x021,
+    0x028, 0x129, 0x1ED, 0x56C, 0x26E, 0x1EF, 0x46B, 0x4AA,
+    0x178, 0x07A, 0x27E, 0x37C, 0x1FD, 0x27F, 0x0BB, 0x1B9,
+    0x39D, 0x2DF, 0x09E, 0x19C, 0x318, 0x09A, 0x25B, 0x359,
+    0x50B, 0x48F, 0x18E, 0x08A, 0x4C8, 0x18C, 0x00D, 0x0C9,
+    0x436, 0x232, 0x5B0, 0x534, 0x475, 0x5B1, 0x333, 0x4F7,
+    0x5FE, 0x2BF, 0x47D, 0x4BC, 0x5B8, 0x479, 0x1FB, 0x57A,
+    0x59E, 0x45F, 0x29B, 0x2DA, 0x5D8, 0x299, 0x11D, 0x3DC,
+    0x315, 0x097, 0x2D3, 0x291, 0x390, 0x2D2, 0x056, 0x214,
+    0x206, 0x404, 0x5C0, 0x382, 0x283, 0x5C1, 0x4C5, 0x307,
+    0x58E, 0x44F, 0x28B, 0x2CA, 0x5C8, 0x289, 0x10D, 0x3CC,
+    0x268, 0x1E9, 0x12B, 0x3EA, 0x02E, 0x12F, 0x2AD, 0x2EC,
+    0x0A5, 0x321, 0x3E3, 0x127, 0x0E6, 0x3E2, 0x220, 0x064,
+    0x0ED, 0x3E9, 0x328, 0x4EC, 0x0AE, 0x32A, 0x5AB, 0x52F,
+    0x3BD, 0x2FF, 0x0BE, 0x1BC, 0x338, 0x0BA, 0x27B, 0x379,
+    0x31D, 0x09F, 0x2DB, 0x299, 0x398, 0x2DA, 0x05E, 0x21C,
+    0x58E, 0x44F, 0x28B, 0x2CA, 0x5C8, 0x289, 0x10D, 0x3CC,
+    0x3C5, 0x0C4, 0x380, 0x5C1, 0x2C3, 0x382, 0x506, 0x587,
+    0x315, 0x097, 0x2D3, 0x291, 0x390, 0x2D2, 0x056, 0x214,
+    0x1F0, 0x272, 0x073, 0x231, 0x175, 0x077, 0x2F6, 0x2B4,
+    0x466, 0x5A2, 0x223, 0x067, 0x425, 0x221, 0x3E0, 0x124,
+    0x2ED, 0x3AC, 0x0EE, 0x02F, 0x3EB, 0x0EA, 0x368, 0x269,
+    0x08D, 0x309, 0x3CB, 0x10F, 0x0CE, 0x3CA, 0x208, 0x04C,
+    0x0C5, 0x3C1, 0x300, 0x4C4, 0x086, 0x302, 0x583, 0x507,
+    0x363, 0x561, 0x4E0, 0x322, 0x1A6, 0x4E4, 0x5E5, 0x3A7,
+    0x3B5, 0x2F7, 0x0B6, 0x1B4, 0x330, 0x0B2, 0x273, 0x371,
+    0x0D5, 0x3D1, 0x310, 0x4D4, 0x096, 0x312, 0x593, 0x517,
+    0x41E, 0x21A, 0x598, 0x51C, 0x45D, 0x599, 0x31B, 0x4DF,
+    0x57B, 0x37A, 0x538, 0x5B9, 0x4BD, 0x53C, 0x3BE, 0x5FF,
+    0x4DB, 0x19F, 0x49D, 0x459, 0x518, 0x49C, 0x15E, 0x41A,
+    0x553, 0x352, 0x510, 0x591, 0x495, 0x514, 0x396, 0x5D7,
+    0x4B3, 0x532, 0x376, 0x277, 0x575, 0x374, 0x0F0, 0x031,
+    0x178, 0x07A, 0x27E, 0x37C, 0x1FD, 0x27F, 0x0BB, 0x1B9,
+    0x1AB, 0x4E9, 0x56D, 0x1EF, 0x36E, 0x56C, 0x428, 0x16A,
+    0x4A3, 0x522, 0x366, 0x267, 0x565, 0x364, 0x0E0, 0x021,
+    0x2C5, 0x384, 0x0C6, 0x007, 0x3C3, 0x0C2, 0x340, 0x241,
+    0x048, 0x14C, 0x00E, 0x0CA, 0x10B, 0x00F, 0x18D, 0x089,
+    0x0AD, 0x329, 0x3EB, 0x12F, 0x0EE, 0x3EA, 0x228, 0x06C,
+    0x2E5, 0x3A4, 0x0E6, 0x027, 0x3E3, 0x0E2, 0x360, 0x261,
+    0x3C5, 0x0C4, 0x380, 0x5C1, 0x2C3, 0x382, 0x506, 0x587,
+    0x20E, 0x40C, 0x5C8, 0x38A, 0x28B, 0x5C9, 0x4CD, 0x30F,
+    0x31D, 0x09F, 0x2DB, 0x299, 0x398, 0x2DA, 0x05E, 0x21C,
+    0x3D5, 0x0D4, 0x390, 0x5D1, 0x2D3, 0x392, 0x516, 0x597,
+    0x573, 0x372, 0x530, 0x5B1, 0x4B5, 0x534, 0x3B6, 0x5F7,
+    0x43E, 0x23A, 0x5B8, 0x53C, 0x47D, 0x5B9, 0x33B, 0x4FF,
+    0x3AD, 0x2EF, 0x0AE, 0x1AC, 0x328, 0x0AA, 0x26B, 0x369,
+    0x0CD, 0x3C9, 0x308, 0x4CC, 0x08E, 0x30A, 0x58B, 0x50F,
+    0x09D, 0x319, 0x3DB, 0x11F, 0x0DE, 0x3DA, 0x218, 0x05C,
+    0x278, 0x1F9, 0x13B, 0x3FA, 0x03E, 0x13F, 0x2BD, 0x2FC,
+    0x2F5, 0x3B4, 0x0F6, 0x037, 0x3F3, 0x0F2, 0x370, 0x271,
+    0x095, 0x311, 0x3D3, 0x117, 0x0D6, 0x3D2, 0x210, 0x054,
+    0x446, 0x582, 0x203, 0x047, 0x405, 0x201, 0x3C0, 0x104,
+    0x1E0, 0x262, 0x063, 0x221, 0x165, 0x067, 0x2E6, 0x2A4,
+    0x5B6, 0x477, 0x2B3, 0x2F2, 0x5F0, 0x2B1, 0x135, 0x3F4,
+    0x226, 0x424, 0x5E0, 0x3A2, 0x2A3, 0x5E1, 0x4E5, 0x327,
+    0x2AE, 0x5EC, 0x42D, 0x16F, 0x22B, 0x429, 0x568, 0x1EA,
+    0x138, 0x03C, 0x17D, 0x439, 0x07B, 0x17F, 0x4BE, 0x47A,
+    0x45E, 0x59A, 0x21B, 0x05F, 0x41D, 0x219, 0x3D8, 0x11C,
+    0x28E, 0x5CC, 0x40D, 0x14F, 0x20B, 0x409, 0x548, 0x1CA,
+    0x183, 0x4C1, 0x545, 0x1C7, 0x346, 0x544, 0x400, 0x142,
+    0x010, 0x111, 0x1D5, 0x554, 0x256, 0x1D7, 0x453, 0x492,
+    0x236, 0x434, 0x5F0, 0x3B2, 0x2B3, 0x5F1, 0x4F5, 0x337,
+    0x5BE, 0x47F, 0x2BB, 0x2FA, 0x5F8, 0x2B9, 0x13D, 0x3FC,
+    0x5EE, 0x2AF, 0x46D, 0x4AC, 0x5A8, 0x469, 0x1EB, 0x56A,
+    0x4E3, 0x1A7, 0x4A5, 0x461, 0x520, 0x4A4, 0x166, 0x422,
+    0x406, 0x202, 0x580, 0x504, 0x445, 0x581, 0x303, 0x4C7,
+    0x5CE, 0x28F, 0x44D, 0x48C, 0x588, 0x449, 0x1CB, 0x54A,
+    0x018, 0x119, 0x1DD, 0x55C, 0x25E, 0x1DF, 0x45B, 0x49A,
+    0x193, 0x4D1, 0x555, 0x1D7, 0x356, 0x554, 0x410, 0x152,
+    0x35B, 0x559, 0x4D8, 0x31A, 0x19E, 0x4DC, 0x5DD, 0x39F,
+    0x53B, 0x4BF, 0x1BE, 0x0BA, 0x4F8, 0x1BC, 0x03D, 0x0F9,
+    0x4EB, 0x1AF, 0x4AD, 0x469, 0x528, 0x4AC, 0x16E, 0x42A,
+    0x5CE, 0x28F, 0x44D, 0x48C, 0x588, 0x449, 0x1CB, 0x54A,
+    0x543, 0x342, 0x500, 0x581, 0x485, 0x504, 0x386, 0x5C7,
+    0x4E3, 0x1A7, 0x4A5, 0x461, 0x520, 0x4A4, 0x166, 0x422,
+    0x130, 0x034, 0x175, 0x431, 0x073, 0x177, 0x4B6, 0x472,
+    0x296, 0x5D4, 0x415, 0x157, 0x213, 0x411, 0x550, 0x1D2,
+    0x49B, 0x51A, 0x35E, 0x25F, 0x55D, 0x35C, 0x0D8, 0x019,
+    0x18B, 0x4C9, 0x54D, 0x1CF, 0x34E, 0x54C, 0x408, 0x14A,
+    0x343, 0x541, 0x4C0, 0x302, 0x186, 0x4C4, 0x5C5, 0x387,
+    0x0D5, 0x3D1, 0x310, 0x4D4, 0x096, 0x312, 0x593, 0x517,
+    0x533, 0x4B7, 0x1B6, 0x0B2, 0x4F0, 0x1B4, 0x035, 0x0F1,
+    0x363, 0x561, 0x4E0, 0x322, 0x1A6, 0x4E4, 0x5E5, 0x3A7,
+    0x22E, 0x42C, 0x5E8, 0x3AA, 0x2AB, 0x5E9, 0x4ED, 0x32F,
+    0x3FD, 0x0FC, 0x3B8, 0x5F9, 0x2FB, 0x3BA, 0x53E, 0x5BF,
+    0x19B, 0x4D9, 0x55D, 0x1DF, 0x35E, 0x55C, 0x418, 0x15A,
+    0x493, 0x512, 0x356, 0x257, 0x555, 0x354, 0x0D0, 0x011,
+    0x543, 0x342, 0x500, 0x581, 0x485, 0x504, 0x386, 0x5C7,
+    0x40E, 0x20A, 0x588, 0x50C, 0x44D, 0x589, 0x30B, 0x4CF,
+    0x4EB, 0x1AF, 0x4AD, 0x469, 0x528, 0x4AC, 0x16E, 0x42A,
+    0x563, 0x362, 0x520, 0x5A1, 0x4A5, 0x524, 0x3A6, 0x5E7,
+    0x3F5, 0x0F4, 0x3B0, 0x5F1, 0x2F3, 0x3B2, 0x536, 0x5B7,
+    0x23E, 0x43C, 0x5F8, 0x3BA, 0x2BB, 0x5F9, 0x4FD, 0x33F,
+    0x51B, 0x49F, 0x19E, 0x09A, 0x4D8, 0x19C, 0x01D, 0x0D9,
+    0x34B, 0x549, 0x4C8, 0x30A, 0x18E, 0x4CC, 0x5CD, 0x38F,
+    0x1AB, 0x4E9, 0x56D, 0x1EF, 0x36E, 0x56C, 0x428, 0x16A,
+    0x038, 0x139, 0x1FD, 0x57C, 0x27E, 0x1FF, 0x47B, 0x4BA,
+    0x4B3, 0x532, 0x376, 0x277, 0x575, 0x374, 0x0F0, 0x031,
+    0x1A3, 0x4E1, 0x565, 0x1E7, 0x366, 0x564, 0x420, 0x162,
+    0x286, 0x5C4, 0x405, 0x147, 0x203, 0x401, 0x540, 0x1C2,
+    0x110, 0x014, 0x155, 0x411, 0x053, 0x157, 0x496, 0x452,
+    0x2B6, 0x5F4, 0x435, 0x177, 0x233, 0x431, 0x570, 0x1F2,
+    0x456, 0x592, 0x213, 0x057, 0x415, 0x211, 0x3D0, 0x114,
+    0x406, 0x202, 0x580, 0x504, 0x445, 0x581, 0x303, 0x4C7,
+    0x563, 0x362, 0x520, 0x5A1, 0x4A5, 0x524, 0x3A6, 0x5E7,
+    0x5EE, 0x2AF, 0x46D, 0x4AC, 0x5A8, 0x469, 0x1EB, 0x56A,
+    0x40E, 0x20A, 0x588, 0x50C, 0x44D, 0x589, 0x30B, 0x4CF,
+    0x0DD, 0x3D9, 0x318, 0x4DC, 0x09E, 0x31A, 0x59B, 0x51F,
+    0x37B, 0x579, 0x4F8, 0x33A, 0x1BE, 0x4FC, 0x5FD, 0x3BF,
+    0x476, 0x5B2, 0x233, 0x077, 0x435, 0x231, 0x3F0, 0x134,
+    0x2A6, 0x5E4, 0x425, 0x167, 0x223, 0x421, 0x560, 0x1E2,
+    0x206, 0x404, 0x5C0, 0x382, 0x283, 0x5C1, 0x4C5, 0x307,
+    0x3D5, 0x0D4, 0x390, 0x5D1, 0x2D3, 0x392, 0x516, 0x597,
+    0x59E, 0x45F, 0x29B, 0x2DA, 0x5D8, 0x299, 0x11D, 0x3DC,
+    0x20E, 0x40C, 0x5C8, 0x38A, 0x28B, 0x5C9, 0x4CD, 0x30F,
+    0x36B, 0x569, 0x4E8, 0x32A, 0x1AE, 0x4EC, 0x5ED, 0x3AF,
+    0x0FD, 0x3F9, 0x338, 0x4FC, 0x0BE, 0x33A, 0x5BB, 0x53F
+};
+
+/**
+ * Walk the 3D state tables for the 63-bit code _code, the Morton code to
+ * encode or the Hilbert index to decode: one level from the top row and then
+ * two levels per lookup.
+ */
+static uint64_t
+hilbertWalk3D(uint16_t const *const _top, uint16_t const *const _table,
+        uint64_t const _code)
+{
+    uint16_t e = _top[(_code >> 60) & 0x7];
+    uint64_t result = e & 0x7;
+
+    for (uint8_t i = 60; i > 0; i -= 6) {
+        e = _table[(e & ~0x3F) | ((_code >> (i - 6)) & 0x3F)];
+        result = (result << 6) | (e & 0x3F);
+    }
+
+    return (result);
+}
+
+uint64_t
+hilbertEncode2D(uint32_t const _x, uint32_t const _y)
+{
+    uint32_t i0, i1;
+
+    hilbertTransform2D(_x, _y, &i0, &i1);
+
+    return (mortonSpread2D(i0) | (mortonSpread2D(i1) << 1));
+}
+
+void
+hilbertDecode2D(uint64_t const _index, uint32_t *const _x, uint32_t *const _y)
+{
+    hilbertInverseTransform2D(mortonCompact2D(_index),
+            mortonCompact2D(_index >> 1), _x, _y);
+
+    return;
+}
+
+/**
+ * Each level of the Hilbert index is the Morton digit of that level, permuted
+ * according to the orientation (state) of the sub-cube it lies in. Both
+ * directions therefore walk the levels of a Morton code from high to low.
+ */
+uint64_t
+hilbertEncode3D(uint32_t const _x, uint32_t const _y, uint32_t const _z)
+{
+    return (hilbertWalk3D(hilbert3DEncodeTop, hilbert3DEncodeTable,
+            mortonEncode3D(_x, _y, _z)));
+}
+
+void
+hilbertDecode3D(uint64_t const _index, uint32_t *const _x, uint32_t *const _y,
+        uint32_t *const _z)
+{
+    mortonDecode3D(hilbertWalk3D(hilbert3DDecodeTop, hilbert3DDecodeTable,
+            _index), _x, _y, _z);
+
+    return;
+}
+
+void
+hilbertEncode2DBatch(uint64_t *const _indices, uint32_t const *const _x,
+        uint32_t const *const _y, size_t const _n)
+{
+    size_t i = 0;
+
+#ifdef BITOPERATIONS_USE_SSE2
+    for (; i + 4 <= _n; i += 4) {
+        hilbertEncode2DSse2(&_indices[i], &_x[i], &_y[i]);
+    }
+#endif
+    for (; i < _n; i++) {
+        _indices[i] = hilbertEncode2D(_x[i], _y[i]);
+    }
+
+    return;
+}
+
+void
+hilbertDecode2DBatch(uint32_t *const _x, uint32_t *const _y,
+        uint64_t const *const _indices, size_t const _n)
+{
+    for (size_t i = 0; i < _n; i++) {
+        hilbertDecode2D(_indices[i], &_x[i], &_y[i]);
+    }
+
+    return;
+}
+
+/**
+ * Walk the 3D state tables for HILBERT_3D_BATCH codes side by side. The walk
+ * of one code is a chain of dependent loads, the walks of the codes overlap.
+ */
+static void
+hilbertWalk3DBatch(uint16_t const *const _top, uint16_t const *const _table,
+        uint64_t *const _codes)
+{
+    uint16_t e[HILBERT_3D_BATCH];
+    uint64_t result[HILBERT_3D_BATCH];
+
+    for (uint8_t j = 0; j < HILBERT_3D_BATCH; j++) {
+        e[j] = _top[(_codes[j] >> 60) & 0x7];
+        result[j] = e[j] & 0x7;
+    }
+    for (uint8_t i = 60; i > 0; i -= 6) {
+        for (uint8_t j = 0; j < HILBERT_3D_BATCH; j++) {
+            e[j] = _table[(e[j] & ~0x3F) | ((_codes[j] >> (i - 6)) & 0x3F)];
+            result[j] = (result[j] << 6) | (e[j] & 0x3F);
+        }
+    }
+    for (uint8_t j = 0; j < HILBERT_3D_BATCH; j++) {
+        _codes[j] = result[j];
+    }
+
+    return;
+}
+
+void
+hilbertEncode3DBatch(uint64_t *const _indices, uint32_t const *const _x,
+        uint32_t const *const _y, uint32_t const *const _z, size_t const _n)
+{
+    size_t i = 0;
+
+    for (; i + HILBERT_3D_BATCH <= _n; i += HILBERT_3D_BATCH) {
+        for (uint8_t j = 0; j < HILBERT_3D_BATCH; j++) {
+            _indices[i + j] = mortonSpread3D(_x[i + j])
+                    | (mortonSpread3D(_y[i + j]) << 1)
+                    | (mortonSpread3D(_z[i + j]) << 2);
+        }
+        hilbertWalk3DBatch(hilbert3DEncodeTop, hilbert3DEncodeTable,
+                &_indices[i]);
+    }
+    for (; i < _n; i++) {
+        _indices[i] = hilbertEncode3D(_x[i], _y[i], _z[i]);
+    }
+
+    return;
+}
+
+void
+hilbertDecode3DBatch(uint32_t *const _x, uint32_t *const _y, uint32_t *const _z,
+        uint64_t const *const _indices, size_t const _n)
+{
+    size_t i = 0;
+
+    for (; i + HILBERT_3D_BATCH <= _n; i += HILBERT_3D_BATCH) {
+        uint64_t codes[HILBERT_3D_BATCH];
+
+        for (uint8_t j = 0; j < HILBERT_3D_BATCH; j++) {
+            codes[j] = _indices[i + j];
+        }
+        hilbertWalk3DBatch(hilbert3DDecodeTop, hilbert3DDecodeTable, codes);
+        for (uint8_t j = 0; j < HILBERT_3D_BATCH; j++) {
+            _x[i + j] = mortonCompact3D(codes[j]);
+            _y[i + j] = mortonCompact3D(codes[j] >> 1);
+            _z[i + j] = mortonCompact3D(codes[j] >> 2);
+        }
+    }
+    for (; i < _n; i++) {
+        hilbertDecode3D(_indices[i], &_x[i], &_y[i], &_z[i]);
+    }
+
+    return;
+}
+
+/********** Bit matrix transpose **********************************************/
+/**
+ * Like reverseBitOrder, but swapping the off-diagonal blocks of 1x1, 2x2 and
+ * 4x4 bits instead of halves.
+ */
+uint64_t
+transposeBits8x8(uint64_t const _var)
+{
+    uint64_t v = _var;
+    uint64_t t;
+
+    // swap 1x1 blocks
+    t = (v ^ (v >> 7)) & 0x00AA00AA00AA00AAULL;
+    v ^= t ^ (t << 7);
+    // swap 2x2 blocks
+    t = (v ^ (v >> 14)) & 0x0000CCCC0000CCCCULL;
+    v ^= t ^ (t << 14);
+    // swap 4x4 blocks
+    t = (v ^ (v >> 28)) & 0x00000000F0F0F0F0ULL;
+    v ^= t ^ (t << 28);
+
+    return (v);
+}
+
+/**
+ * Recursive mask-and-shift transpose: in the step with block size j, the high
+ * j bits of row r are swapped with the low j bits of row r + j, for the first
+ * j rows of every 2j rows. The rows of one step are independent and
+ * contiguous, so the inner loop vectorises.
+ */
+void
+transposeBits32x32(uint32_t *const _dst, uint32_t const *const _src)
+{
+    uint32_t m = 0x0000FFFF;
+
+    if (_dst != _src) {
+        memcpy(_dst, _src, 32 * sizeof(uint32_t));
+    }
+
+    for (uint8_t j = 16; j != 0; j >>= 1, m ^= m << j) {
+        for (uint8_t k = 0; k < 32; k += 2 * j) {
+            for (uint8_t r = k; r < k + j; r++) {
+                uint32_t const t = ((_dst[r] >> j) ^ _dst[r + j]) & m;
+
+                _dst[r + j] ^= t;
+                _dst[r] ^= t << j;
+            }
+        }
+    }
+
+    return;
+}
+
+void
+transposeBits64x64(uint64_t *const _dst, uint64_t const *const _src)
+{
+    uint64_t m = 0x00000000FFFFFFFFULL;
+
+    if (_dst != _src) {
+        memcpy(_dst, _src, 64 * sizeof(uint64_t));
+    }
+
+    for (uint8_t j = 32; j != 0; j >>= 1, m ^= m << j) {
+        for (uint8_t k = 0; k < 64; k += 2 * j) {
+            for (uint8_t r = k; r < k + j; r++) {
+                uint64_t const t = ((_dst[r] >> j) ^ _dst[r + j]) & m;
+
+                _dst[r + j] ^= t;
+                _dst[r] ^= t << j;
+            }
+        }
+    }
+
+    return;
+}
+
+/**
+ * With GFNI two matrices at a time are transposed by one affine transformation
+ * of the identity matrix. That transformation takes the rows of the matrix in
+ * reversed order, so the bytes of each matrix are reversed first.
+ */
+void
+transposeBits8x8Batch(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _n)
+{
+    size_t i = 0;
+
+#if defined(BITOPERATIONS_USE_GFNI)
+    __m128i const identity = _mm_set1_epi64x(0x8040201008040201LL);
+    __m128i const reverse = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15,
+            0, 1, 2, 3, 4, 5, 6, 7);
+
+    for (; i + 2 <= _n; i += 2) {
+        __m128i v = _mm_loadu_si128((__m128i const *)&_src[i]);
+
+        v = _mm_shuffle_epi8(v, reverse);
+        v = _mm_gf2p8affine_epi64_epi8(identity, v, 0);
+        _mm_storeu_si128((__m128i *)&_dst[i], v);
+    }
+#endif
+    for (; i < _n; i++) {
+        _dst[i] = transposeBits8x8(_src[i]);
+    }
+
+    return;
+}
+
+void
+transposeBits32x32Batch(uint32_t *const _dst, uint32_t const *const _src,
+        size_t const _n)
+{
+    for (size_t i = 0; i < _n; i++) {
+        transposeBits32x32(&_dst[32 * i], &_src[32 * i]);
+    }
+
+    return;
+}
+
+void
+transposeBits64x64Batch(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _n)
+{
+    for (size_t i = 0; i < _n; i++) {
+        transposeBits64x64(&_dst[64 * i], &_src[64 * i]);
+    }
+
+    return;
+}
+
+/********** Positional population count ***************************************/
+/**
+ * Carry-save adder: add the bits of three words, giving the sum bits in _l
+ * and the carry bits in _h.
+ */
+static void
+carrySaveAdd(uint64_t *const _h, uint64_t *const _l, uint64_t const _a,
+        uint64_t const _b, uint64_t const _c)
+{
+    uint64_t const u = _a ^ _b;
+
+    *_h = (_a & _b) | (u & _c);
+    *_l = u ^ _c;
+
+    return;
+}
+
+/**
+ * Add _weight times the bits of a word holding 64 / _width variables of
+ * _width bits to the counters. The bits of one position in all variables are
+ * summed with one multiply, which adds all lanes into the highest lane.
+ */
+static void
+positionalPopcountAdd(uint64_t *const _counts, uint64_t const _word,
+        uint64_t const _weight, uint8_t const _width)
+{
+    uint64_t const lanes = ~0ULL / (~0ULL >> (64 - _width));
+
+    for (uint8_t b = 0; b < _width; b++) {
+        _counts[b] += _weight
+                * ((((_word >> b) & lanes) * lanes) >> (64 - _width));
+    }
+
+    return;
+}
+
+/**
+ * Harley-Seal positional population count. Blocks of 16 words go through a
+ * network of carry-save adders, so that only the resulting sixteens word of
+ * every block has to be counted per bit position. The words are loaded with
+ * memcpy, which keeps the bits of every variable together in one lane on both
+ * little- and big-endian machines.
+ */
+static void
+positionalPopcount(uint64_t *const _counts, uint8_t const *const _data,
+        size_t const _nBytes, uint8_t const _width)
+{
+    uint64_t ones = 0, twos = 0, fours = 0, eights = 0;
+    uint64_t twosA, twosB, foursA, foursB, eightsA, eightsB, sixteens;
+    uint64_t w[16];
+    size_t i = 0;
+
+    for (; i + sizeof(w) <= _nBytes; i += sizeof(w)) {
+        memcpy(w, &_data[i], sizeof(w));
+        carrySaveAdd(&twosA, &ones, ones, w[0], w[1]);
+        carrySaveAdd(&twosB, &ones, ones, w[2], w[3]);
+        carrySaveAdd(&foursA, &twos, twos, twosA, twosB);
+        carrySaveAdd(&twosA, &ones, ones, w[4], w[5]);
+        carrySaveAdd(&twosB, &ones, ones, w[6], w[7]);
+        carrySaveAdd(&foursB, &twos, twos, twosA, twosB);
+        carrySaveAdd(&eightsA, &fours, fours, foursA, foursB);
+        carrySaveAdd(&twosA, &ones, ones, w[8], w[9]);
+        carrySaveAdd(&twosB, &ones, ones, w[10], w[11]);
+        carrySaveAdd(&foursA, &twos, twos, twosA, twosB);
+        carrySaveAdd(&twosA, &ones, ones, w[12], w[13]);
+        carrySaveAdd(&twosB, &ones, ones, w[14], w[15]);
+        carrySaveAdd(&foursB, &twos, twos, twosA, twosB);
+        carrySaveAdd(&eightsB, &fours, fours, foursA, foursB);
+        carrySaveAdd(&sixteens, &eights, eights, eightsA, eightsB);
+        positionalPopcountAdd(_counts, sixteens, 16, _width);
+    }
+    positionalPopcountAdd(_counts, ones, 1, _width);
+    positionalPopcountAdd(_counts, twos, 2, _width);
+    positionalPopcountAdd(_counts, fours, 4, _width);
+    positionalPopcountAdd(_counts, eights, 8, _width);
+
+    for (; i + sizeof(uint64_t) <= _nBytes; i += sizeof(uint64_t)) {
+        memcpy(&w[0], &_data[i], sizeof(uint64_t));
+        positionalPopcountAdd(_counts, w[0], 1, _width);
+    }
+    if (i < _nBytes) {
+        w[0] = 0;
+        memcpy(&w[0], &_data[i], _nBytes - i);
+        positionalPopcountAdd(_counts, w[0], 1, _width);
+    }
+
+    return;
+}
+
+void
+positionalPopcount8(uint64_t *const _counts, uint8_t const *const _data,
+        size_t const _n)
+{
+    positionalPopcount(_counts, _data, _n, 8);
+
+    return;
+}
+
+void
+positionalPopcount16(uint64_t *const _counts, uint16_t const *const _data,
+        size_t const _n)
+{
+    positionalPopcount(_counts, (uint8_t const *)_data, 2 * _n, 16);
+
+    return;
+}
+
+void
+positionalPopcount32(uint64_t *const _counts, uint32_t const *const _data,
+        size_t const _n)
+{
+    positionalPopcount(_counts, (uint8_t const *)_data, 4 * _n, 32);
+
+    return;
+}
+
+/********** Hamming distance search *******************************************/
+uint32_t
+hammingDistance(uint64_t const *const _a, uint64_t const *const _b,
+        size_t const _nWords)
+{
+    uint32_t d = 0;
+    size_t i = 0;
+
+#ifdef BITOPERATIONS_USE_AVX512_POPCNT
+    __m512i sum = _mm512_setzero_si512();
+
+    for (; i + 8 <= _nWords; i += 8) {
+        __m512i const x = _mm512_xor_si512(_mm512_loadu_si512(&_a[i]),
+                                           _mm512_loadu_si512(&_b[i]));
+        sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(x));
+    }
+    d = (uint32_t)_mm512_reduce_add_epi64(sum);
+#endif
+    for (; i < _nWords; i++) {
+        d += nBitsSet64(_a[i] ^ _b[i]);
+    }
+
+    return (d);
+}
+
+/**
+ * Hamming distance that stops counting in steps of 8 words once the distance
+ * exceeds _bound, in which case any distance larger than _bound is returned.
+ */
+static uint32_t
+hammingDistanceBounded(uint64_t const *const _a, uint64_t const *const _b,
+        size_t const _nWords, uint32_t const _bound)
+{
+    uint32_t d = 0;
+
+    for (size_t i = 0; i < _nWords && d <= _bound; i += 8) {
+        size_t const n = (_nWords - i < 8) ? _nWords - i : 8;
+        d += hammingDistance(&_a[i], &_b[i], n);
+    }
+
+    return (d);
+}
+
+/** Get the score of the result at heap position _i. */
+static double
+topKScore(TopKHeap const *const _h, size_t const _i)
+{
+    return ((_h->distance != NULL)
+            ? -(double)_h->distance[_i] : _h->similarity[_i]);
+}
+
+/** Put result (_score, _index) at heap position _i. */
+static void
+topKStore(TopKHeap const *const _h, size_t const _i, double const _score,
+        size_t const _index)
+{
+    if (_h->distance != NULL) {
+        _h->distance[_i] = (uint32_t)-_score;
+    } else {
+        _h->similarity[_i] = _score;
+    }
+    _h->index[_i] = _index;
+
+    return;
+}
+
+/** Whether result (_s1, _i1) ranks after result (_s2, _i2). */
+static bool
+topKRanksAfter(double const _s1, size_t const _i1, double const _s2,
+        size_t const _i2)
+{
+    return (_s1 < _s2 || (_s1 == _s2 && _i1 > _i2));
+}
+
+/**
+ * Put result (_score, _index) in the hole at heap position _i of a heap of _n
+ * results, sifting it down below the results that rank after it.
+ */
+static void
+topKSiftDown(TopKHeap const *const _h, size_t _i, size_t const _n,
+        double const _score, size_t const _index)
+{
+    for (size_t c = 2 * _i + 1; c < _n; c = 2 * _i + 1) {
+        if (c + 1 < _n && topKRanksAfter(topKScore(_h, c + 1),
+                _h->index[c + 1], topKScore(_h, c), _h->index[c])) {
+            c++;
+        }
+        if (!topKRanksAfter(topKScore(_h, c), _h->index[c], _score,
+                _index)) {
+            break;
+        }
+        topKStore(_h, _i, topKScore(_h, c), _h->index[c]);
+        _i = c;
+    }
+    topKStore(_h, _i, _score, _index);
+
+    return;
+}
+
+/** Add a result to a heap if it ranks before the result at the root. */
+static void
+topKPush(TopKHeap const *const _h, double const _score, size_t const _index)
+{
+    if (*_h->n < _h->k) {
+        size_t i = (*_h->n)++;
+
+        while (i > 0 && topKRanksAfter(_score, _index,
+                topKScore(_h, (i - 1) / 2), _h->index[(i - 1) / 2])) {
+            topKStore(_h, i, topKScore(_h, (i - 1) / 2),
+                    _h->index[(i - 1) / 2]);
+            i = (i - 1) / 2;
+        }
+        topKStore(_h, i, _score, _index);
+    } else if (_h->k > 0 && topKRanksAfter(topKScore(_h, 0), _h->index[0],
+            _score, _index)) {
+        topKSiftDown(_h, 0, *_h->n, _score, _index);
+    }
+
+    return;
+}
+
+/** Sort a heap from the first to the last ranked result, with a heapsort. */
+static void
+topKSort(TopKHeap const *const _h)
+{
+    /* Move the last ranked result to the end of the shrinking heap */
+    for (size_t n = *_h->n; n > 1; n--) {
+        double const score = topKScore(_h, n - 1);
+        size_t const index = _h->index[n - 1];
+
+        topKStore(_h, n - 1, topKScore(_h, 0), _h->index[0]);
+        topKSiftDown(_h, 0, n - 1, score, index);
+    }
+
+    return;
+}
+
+/** Add a result to a result set if it ranks before the furthest result. */
+static void
+hammingTopKPush(HammingTopK *const _t, uint32_t const _d, size_t const _index)
+{
+    TopKHeap const h = { _t->index, _t->distance, NULL, _t->k, &_t->n };
+
+    topKPush(&h, -(double)_d, _index);
+
+    return;
+}
+
+void
+hammingTopKInit(HammingTopK *const _t, size_t *const _index,
+        uint32_t *const _distance, size_t const _k)
+{
+    _t->index = _index;
+    _t->distance = _distance;
+    _t->k = _k;
+    _t->n = 0;
+
+    return;
+}
+
+void
+hammingTopKScan(HammingTopK *const _t, uint64_t const *const _query,
+        uint64_t const *const _codes, size_t const _nCodes,
+        size_t const _nWords, size_t const _firstIndex)
+{
+    if (_t->k == 0) {
+        return;
+    }
+    for (size_t i = 0; i < _nCodes; i++) {
+        uint32_t const bound = (_t->n < _t->k) ? UINT32_MAX : _t->distance[0];
+        uint32_t const d = hammingDistanceBounded(_query,
+                &_codes[i * _nWords], _nWords, bound);
+
+        if (d <= bound) {
+            hammingTopKPush(_t, d, _firstIndex + i);
+        }
+    }
+
+    return;
+}
+
+void
+hammingTopKScanBatch(HammingTopK *const _t, uint64_t const *const _queries,
+        size_t const _nQueries, uint64_t const *const _codes,
+        size_t const _nCodes, size_t const _nWords, size_t const _firstIndex)
+{
+    size_t block = HAMMING_BLOCK_BYTES / sizeof(uint64_t) / _nWords;
+
+    if (block == 0) {
+        block = 1;
+    }
+    for (size_t i = 0; i < _nCodes; i += block) {
+        size_t const n = (_nCodes - i < block) ? _nCodes - i : block;
+
+        for (size_t q = 0; q < _nQueries; q++) {
+            hammingTopKScan(&_t[q], &_queries[q * _nWords],
+                    &_codes[i * _nWords], n, _nWords, _firstIndex + i);
+        }
+    }
+
+    return;
+}
+
+void
+hammingTopKMerge(HammingTopK *const _dst, HammingTopK const *const _src)
+{
+    for (size_t i = 0; i < _src->n; i++) {
+        hammingTopKPush(_dst, _src->distance[i], _src->index[i]);
+    }
+
+    return;
+}
+
+size_t
+hammingTopKSort(HammingTopK *const _t)
+{
+    TopKHeap const h = { _t->index, _t->distance, NULL, _t->k, &_t->n };
+
+    topKSort(&h);
+
+    return (_t->n);
+}
+
+/********** Tanimoto similarity search ****************************************/
+void
+nBitsSetBatch(uint32_t *const _counts, uint64_t const *const _codes,
+        size_t const _nCodes, size_t const _nWords)
+{
+    for (size_t i = 0; i < _nCodes; i++) {
+        uint32_t n = 0;
+
+        for (size_t j = 0; j < _nWords; j++) {
+            n += nBitsSet64(_codes[i * _nWords + j]);
+        }
+        _counts[i] = n;
+    }
+
+    return;
+}
+
+/** Count the bits set in both _a and _b. */
+static uint32_t
+nBitsSetAnd(uint64_t const *const _a, uint64_t const *const _b,
+        size_t const _nWords)
+{
+    uint32_t n = 0;
+    size_t i = 0;
+
+#ifdef BITOPERATIONS_USE_AVX512_POPCNT
+    __m512i sum = _mm512_setzero_si512();
+
+    for (; i + 8 <= _nWords; i += 8) {
+        __m512i const x = _mm512_and_si512(_mm512_loadu_si512(&_a[i]),
+                                           _mm512_loadu_si512(&_b[i]));
+        sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(x));
+    }
+    n = (uint32_t)_mm512_reduce_add_epi64(sum);
+#endif
+    for (; i < _nWords; i++) {
+        n += nBitsSet64(_a[i] & _b[i]);
+    }
+
+    return (n);
+}
+
+double
+tanimotoSimilarity(uint64_t const *const _a, uint64_t const *const _b,
+        size_t const _nWords)
+{
+    uint32_t nAnd = 0, nOr = 0;
+
+    for (size_t i = 0; i < _nWords; i++) {
+        nAnd += nBitsSet64(_a[i] & _b[i]);
+        nOr += nBitsSet64(_a[i] | _b[i]);
+    }
+
+    return ((nOr > 0) ? (double)nAnd / nOr : 0.0);
+}
+
+/**
+ * Add a result to a result set if it reaches the threshold and ranks before
+ * the least similar result.
+ */
+static void
+tanimotoTopKPush(TanimotoTopK *const _t, double const _s, size_t const _index)
+{
+    TopKHeap const h = { _t->index, NULL, _t->similarity, _t->k, &_t->n };
+
+    if (_s >= _t->threshold) {
+        topKPush(&h, _s, _index);
+    }
+
+    return;
+}
+
+void
+tanimotoTopKInit(TanimotoTopK *const _t, size_t *const _index,
+        double *const _similarity, size_t const _k, double const _threshold)
+{
+    _t->index = _index;
+    _t->similarity = _similarity;
+    _t->k = _k;
+    _t->n = 0;
+    _t->threshold = _threshold;
+
+    return;
+}
+
+void
+tanimotoTopKScan(TanimotoTopK *const _t, uint64_t const *const _query,
+        uint64_t const *const _codes, uint32_t const *const _counts,
+        size_t const _nCodes, size_t const _nWords, size_t const _firstIndex)
+{
+    uint32_t nQuery = 0;
+
+    if (_t->k == 0) {
+        return;
+    }
+    for (size_t j = 0; j < _nWords; j++) {
+        nQuery += nBitsSet64(_query[j]);
+    }
+    for (size_t i = 0; i < _nCodes; i++) {
+        double const bound = (_t->n < _t->k)
+                ? _t->threshold : _t->similarity[0];
+        uint32_t const lo = (_counts[i] < nQuery) ? _counts[i] : nQuery;
+        uint32_t const hi = (_counts[i] < nQuery) ? nQuery : _counts[i];
+
+        /* The similarity is at most lo / hi, reached when one code contains
+         * the other.
+         */
+        if ((hi > 0 ? (double)lo / hi : 0.0) >= bound) {
+            uint32_t const nAnd = nBitsSetAnd(_query, &_codes[i * _nWords],
+                                              _nWords);
+            uint32_t const nOr = nQuery + _counts[i] - nAnd;
+
+            tanimotoTopKPush(_t, (nOr > 0) ? (double)nAnd / nOr : 0.0,
+                             _firstIndex + i);
+        }
+    }
+
+    return;
+}
+
+void
+tanimotoTopKMerge(TanimotoTopK *const _dst, TanimotoTopK const *const _src)
+{
+    for (size_t i = 0; i < _src->n; i++) {
+        tanimotoTopKPush(_dst, _src->similarity[i], _src->index[i]);
+    }
+
+    return;
+}
+
+size_t
+tanimotoTopKSort(TanimotoTopK *const _t)
+{
+    TopKHeap const h = { _t->index, NULL, _t->similarity, _t->k, &_t->n };
+
+    topKSort(&h);
+
+    return (_t->n);
+}
+
+/********** Blocked Bloom filter **********************************************/
+/**
+ * Select the block of a key from the high half of its hash. The 32 bits of
+ * hash can only reach 2^32 blocks, which bloomFilterInit enforces, so the
+ * product fits in 64 bits.
+ */
+static uint64_t *
+bloomFilterBlock(BloomFilter const *const _f, uint64_t const _hash)
+{
+    return (&_f->blocks[8 * (((_hash >> 32) * _f->nBlocks) >> 32)]);
+}
+
+/**
+ * Select the bit to set in every word of a block from the low half of the
+ * hash of a key, by multiplying it with a different odd constant per word
+ * and taking the top 6 bits of the product (split block Bloom filter).
+ */
+static void
+bloomFilterMasks(uint64_t *const _masks, uint64_t const _hash)
+{
+    static uint32_t const salt[8] = {
+        0x47B6137BU, 0x44974D91U, 0x8824AD5BU, 0xA2B7289DU,
+        0x705495C7U, 0x2DF1424BU, 0x9EFC4947U, 0x5C6BFB31U
+    };
+
+    for (uint8_t i = 0; i < 8; i++) {
+        _masks[i] = 1ULL << (((uint32_t)_hash * salt[i]) >> 26);
+    }
+
+    return;
+}
+
+void
+bloomFilterInit(BloomFilter *const _f, uint64_t *const _words,
+        size_t const _nWords)
+{
+    _f->blocks = _words;
+    _f->nBlocks = (_nWords / 8 < BLOOM_FILTER_MAX_BLOCKS)
+            ? _nWords / 8 : BLOOM_FILTER_MAX_BLOCKS;
+    memset(_words, 0, 8 * _f->nBlocks * sizeof(uint64_t));
+
+    return;
+}
+
+void
+bloomFilterInsert(BloomFilter *const _f, uint64_t const _hash)
+{
+    uint64_t *const block = bloomFilterBlock(_f, _hash);
+    uint64_t masks[8];
+
+    bloomFilterMasks(masks, _hash);
+    for (uint8_t i = 0; i < 8; i++) {
+        block[i] |= masks[i];
+    }
+
+    return;
+}
+
+bool
+bloomFilterQuery(BloomFilter const *const _f, uint64_t const _hash)
+{
+    uint64_t const *const block = bloomFilterBlock(_f, _hash);
+    uint64_t masks[8];
+    uint64_t missing = 0;
+
+    bloomFilterMasks(masks, _hash);
+    for (uint8_t i = 0; i < 8; i++) {
+        missing |= masks[i] & ~block[i];
+    }
+
+    return (missing == 0);
+}
+
+void
+bloomFilterInsertBatch(BloomFilter *const _f, uint64_t const *const _hashes,
+        size_t const _n)
+{
+    for (size_t i = 0; i < _n; i += PREFETCH_BATCH) {
+        size_t const n = (_n - i < PREFETCH_BATCH) ? _n - i : PREFETCH_BATCH;
+
+        for (size_t j = 0; j < n; j++) {
+            PREFETCH(bloomFilterBlock(_f, _hashes[i + j]));
+        }
+        for (size_t j = 0; j < n; j++) {
+            bloomFilterInsert(_f, _hashes[i + j]);
+        }
+    }
+
+    return;
+}
+
+size_t
+bloomFilterQueryBatch(BloomFilter const *const _f, uint64_t *const _result,
+        uint64_t const *const _hashes, size_t const _n)
+{
+    size_t nFound = 0;
+
+    for (size_t i = 0; i < _n; i += PREFETCH_BATCH) {
+        size_t const n = (_n - i < PREFETCH_BATCH) ? _n - i : PREFETCH_BATCH;
+        uint64_t found = 0;
+
+        for (size_t j = 0; j < n; j++) {
+            PREFETCH(bloomFilterBlock(_f, _hashes[i + j]));
+        }
+        for (size_t j = 0; j < n; j++) {
+            found |= (uint64_t)bloomFilterQuery(_f, _hashes[i + j]) << j;
+        }
+        /* The groups are aligned to and smaller than a word of _result */
+        _result[i / 64] = (_result[i / 64] & ~(((1ULL << n) - 1) << (i % 64)))
+                | (found << (i % 64));
+        nFound += nBitsSet64(found);
+    }
+
+    return (nFound);
+}
+
+/********** Binary fuse filter ************************************************/
+/** Base 2 logarithm of _x >= 1 to about 20 bits, without the math library. */
+static double
+binaryFuseLog2(double _x)
+{
+    double r = 0.0;
+
+    while (_x >= 2.0) {
+        _x /= 2.0;
+        r += 1.0;
+    }
+    for (double b = 0.5; b > 1e-6; b /= 2.0) {
+        _x *= _x;
+        if (_x >= 2.0) {
+            _x /= 2.0;
+            r += b;
+        }
+    }
+
+    return (r);
+}
+
+/** High 64 bits of the 128-bit product of _a and _b. */
+static uint64_t
+binaryFuseMulHi(uint64_t const _a, uint32_t const _b)
+{
+    return (((_a >> 32) * _b + (((_a & 0xFFFFFFFFULL) * _b) >> 32)) >> 32);
+}
+
+/** Hash a key with a seed by the MurmurHash3 finaliser. */
+static uint64_t
+binaryFuseHash(uint64_t const _key, uint64_t const _seed)
+{
+    uint64_t h = _key + _seed;
+
+    h = (h ^ (h >> 33)) * 0xFF51AFD7ED558CCDULL;
+    h = (h ^ (h >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+    return (h ^ (h >> 33));
+}
+
+/** Next seed of a SplitMix64 generator. */
+static uint64_t
+binaryFuseNextSeed(uint64_t *const _state)
+{
+    uint64_t z = (*_state += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (z ^ (z >> 31));
+}
+
+/**
+ * Position of the fingerprint of a hash in its segment _i (0, 1 or 2). The
+ * first segment follows from the high bits of the hash, the offsets in the
+ * second and third segment from bits 18-35 and 0-17.
+ */
+static uint32_t
+binaryFusePosition(BinaryFuseFilter const *const _f, uint64_t const _hash,
+        uint8_t const _i)
+{
+    uint64_t const low = _hash & ((1ULL << 36) - 1);
+
+    return (((uint32_t)binaryFuseMulHi(_hash, _f->segmentCountLength)
+            + _i * _f->segmentLength)
+            ^ ((uint32_t)(low >> (36 - 18 * _i)) & (_f->segmentLength - 1)));
+}
+
+/** Fingerprint of a hash, its high and low half folded together. */
+static uint16_t
+binaryFuseFingerprint(BinaryFuseFilter const *const _f, uint64_t const _hash)
+{
+    return ((uint16_t)((_hash ^ (_hash >> 32)) & ((1U << _f->bits) - 1)));
+}
+
+/** Fingerprint at position _i of a filter. */
+static uint16_t
+binaryFuseGet(BinaryFuseFilter const *const _f, uint32_t const _i)
+{
+    return ((_f->bits == 8) ? ((uint8_t const *)_f->fingerprints)[_i]
+                            : ((uint16_t const *)_f->fingerprints)[_i]);
+}
+
+/** Number of bits of the buckets by which the hashes are sorted to build. */
+static uint8_t
+binaryFuseBlockBits(BinaryFuseFilter const *const _f)
+{
+    uint8_t b = 1;
+
+    while ((1U << b) < _f->segmentCountLength / _f->segmentLength) {
+        b++;
+    }
+
+    return (b);
+}
+
+size_t
+binaryFuseFilterInit(BinaryFuseFilter *const _f, size_t const _n,
+        uint8_t const _bits)
+{
+    uint32_t capacity = 0;
+    uint32_t nSegments;
+
+    _f->fingerprints = NULL;
+    _f->seed = 0;
+    _f->bits = _bits;
+    /* Segment length and size factor for three segments per key of the
+     * reference implementation, in which log(3.33) / log(2) = 1.7355 and
+     * log(10^6) / log(2) = 19.9316.
+     */
+    _f->segmentLength = (_n == 0) ? 4
+            : 1U << (uint8_t)(binaryFuseLog2(_n) / 1.7355221772965 + 2.25);
+    if (_f->segmentLength > 262144) {
+        _f->segmentLength = 262144;
+    }
+    if (_n > 1) {
+        double factor = 0.875 + 0.25 * 19.931568569324174 / binaryFuseLog2(_n);
+
+        capacity = (uint32_t)(_n * ((factor < 1.125) ? 1.125 : factor) + 0.5);
+    }
+    nSegments = (capacity + _f->segmentLength - 1) / _f->segmentLength;
+    nSegments = (nSegments <= 2) ? 1 : nSegments - 2;
+    _f->segmentCountLength = nSegments * _f->segmentLength;
+    _f->arrayLength = (nSegments + 2) * _f->segmentLength;
+
+    return (_f->arrayLength);
+}
+
+size_t
+binaryFuseFilterScratchSize(BinaryFuseFilter const *const _f, size_t const _n)
+{
+    return ((_n + 1) * sizeof(uint64_t) + _f->arrayLength * sizeof(uint64_t)
+            + _f->arrayLength * sizeof(uint32_t)
+            + (1U << binaryFuseBlockBits(_f)) * sizeof(uint32_t)
+            + _f->arrayLength + _n);
+}
+
+bool
+binaryFuseFilterBuild(BinaryFuseFilter *const _f, void *const _fingerprints,
+        void *const _scratch, uint64_t const *const _keys, size_t const _n)
+{
+    uint32_t const capacity = _f->arrayLength;
+    uint8_t const blockBits = binaryFuseBlockBits(_f);
+    uint32_t const nBlocks = 1U << blockBits;
+    /* Hashes sorted by block, and later the stack of peeled hashes */
+    uint64_t *const order = _scratch;
+    /* XOR of the hashes mapped to every position */
+    uint64_t *const xorHash = &order[_n + 1];
+    /* Queue of positions to which only one hash is mapped */
+    uint32_t *const alone = (uint32_t *)&xorHash[capacity];
+    uint32_t *const startPos = &alone[capacity];
+    /* Number of hashes mapped to every position in bits 2-7, and the XOR of
+     * the segments (0, 1 or 2) in which they are mapped to it in bits 0-1
+     */
+    uint8_t *const count = (uint8_t *)&startPos[nBlocks];
+    /* Segment of every peeled hash */
+    uint8_t *const segment = &count[capacity];
+    uint64_t rng = 0x726B2B9D438B9D4DULL;
+    uint32_t nPeeled = 0;
+
+    _f->fingerprints = _fingerprints;
+    memset(_fingerprints, 0, capacity * (_f->bits / 8));
+    for (uint8_t iteration = 0; ; iteration++) {
+        uint32_t nDuplicates = 0;
+        uint32_t nAlone = 0;
+        bool error = false;
+
+        if (iteration == BINARY_FUSE_MAX_ITERATIONS) {
+            return (false);
+        }
+        _f->seed = binaryFuseNextSeed(&rng);
+        memset(order, 0, _n * sizeof(uint64_t));
+        order[_n] = 1;
+        memset(xorHash, 0, capacity * sizeof(uint64_t));
+        memset(count, 0, capacity);
+
+        /* Sort the hashes roughly by their first segment for locality */
+        for (uint32_t i = 0; i < nBlocks; i++) {
+            startPos[i] = (uint32_t)(((uint64_t)i * _n) >> blockBits);
+        }
+        for (size_t i = 0; i < _n; i++) {
+            uint64_t const hash = binaryFuseHash(_keys[i], _f->seed);
+            uint32_t b = (uint32_t)(hash >> (64 - blockBits));
+
+            while (order[startPos[b]] != 0) {
+                b = (b + 1) & (nBlocks - 1);
+            }
+            order[startPos[b]++] = hash;
+        }
+
+        for (size_t i = 0; i < _n; i++) {
+            uint64_t const hash = order[i];
+            uint32_t h[3];
+
+            for (uint8_t j = 0; j < 3; j++) {
+                h[j] = binaryFusePosition(_f, hash, j);
+                count[h[j]] = (uint8_t)(count[h[j]] + 4) ^ j;
+                xorHash[h[j]] ^= hash;
+            }
+            /* A duplicate of an earlier key cancels it in some position */
+            if ((xorHash[h[0]] & xorHash[h[1]] & xorHash[h[2]]) == 0
+                    && ((xorHash[h[0]] == 0 && count[h[0]] == 8)
+                    || (xorHash[h[1]] == 0 && count[h[1]] == 8)
+                    || (xorHash[h[2]] == 0 && count[h[2]] == 8))) {
+                nDuplicates++;
+                for (uint8_t j = 0; j < 3; j++) {
+                    count[h[j]] = (uint8_t)(count[h[j]] - 4) ^ j;
+                    xorHash[h[j]] ^= hash;
+                }
+            }
+            for (uint8_t j = 0; j < 3; j++) {
+                error |= count[h[j]] < 4;
+            }
+        }
+        if (error) {
+            continue;
+        }
+
+        /* Peel the hashes that are alone in a position */
+        for (uint32_t i = 0; i < capacity; i++) {
+            alone[nAlone] = i;
+            nAlone += (count[i] >> 2) == 1;
+        }
+        nPeeled = 0;
+        while (nAlone > 0) {
+            uint32_t const i = alone[--nAlone];
+
+            if ((count[i] >> 2) == 1) {
+                uint64_t const hash = xorHash[i];
+                uint8_t const found = count[i] & 3;
+
+                segment[nPeeled] = found;
+                order[nPeeled++] = hash;
+                for (uint8_t j = 1; j <= 2; j++) {
+                    uint8_t const s = (found + j) % 3;
+                    uint32_t const other = binaryFusePosition(_f, hash, s);
+
+                    alone[nAlone] = other;
+                    nAlone += (count[other] >> 2) == 2;
+                    count[other] = (uint8_t)(count[other] - 4) ^ s;
+                    xorHash[other] ^= hash;
+                }
+            }
+        }
+        if (nPeeled + nDuplicates == _n) {
+            break;
+        }
+    }
+
+    /* Assign the fingerprints in reverse peeling order */
+    for (uint32_t i = nPeeled; i-- > 0;) {
+        uint64_t const hash = order[i];
+        uint8_t const s = segment[i];
+        uint16_t const x = binaryFuseFingerprint(_f, hash)
+                ^ binaryFuseGet(_f, binaryFusePosition(_f, hash, (s + 1) % 3))
+                ^ binaryFuseGet(_f, binaryFusePosition(_f, hash, (s + 2) % 3));
+        uint32_t const p = binaryFusePosition(_f, hash, s);
+
+        if (_f->bits == 8) {
+            ((uint8_t *)_fingerprints)[p] = (uint8_t)x;
+        } else {
+            ((uint16_t *)_fingerprints)[p] = x;
+        }
+    }
+
+    return (true);
+}
+
+/** Whether the key of a hash may be in a filter. */
+static bool
+binaryFuseContainsHash(BinaryFuseFilter const *const _f, uint64_t const _hash)
+{
+    return ((binaryFuseFingerprint(_f, _hash)
+            ^ binaryFuseGet(_f, binaryFusePosition(_f, _hash, 0))
+            ^ binaryFuseGet(_f, binaryFusePosition(_f, _hash, 1))
+            ^ binaryFuseGet(_f, binaryFusePosition(_f, _hash, 2))) == 0);
+}
+
+bool
+binaryFuseFilterContains(BinaryFuseFilter const *const _f,
+        uint64_t const _key)
+{
+    return (binaryFuseContainsHash(_f, binaryFuseHash(_key, _f->seed)));
+}
+
+size_t
+binaryFuseFilterContainsBatch(BinaryFuseFilter const *const _f,
+        uint64_t *const _result, uint64_t const *const _keys,
+        size_t const _n)
+{
+    uint8_t const *const fingerprints = _f->fingerprints;
+    size_t nFound = 0;
+
+    for (size_t i = 0; i < _n; i += PREFETCH_BATCH) {
+        size_t const n = (_n - i < PREFETCH_BATCH) ? _n - i : PREFETCH_BATCH;
+        uint64_t hashes[PREFETCH_BATCH];
+        uint64_t found = 0;
+
+        for (size_t j = 0; j < n; j++) {
+            hashes[j] = binaryFuseHash(_keys[i + j], _f->seed);
+            for (uint8_t s = 0; s < 3; s++) {
+                PREFETCH(&fingerprints[binaryFusePosition(_f, hashes[j], s)
+                                       * (_f->bits / 8)]);
+            }
+        }
+        for (size_t j = 0; j < n; j++) {
+            found |= (uint64_t)binaryFuseContainsHash(_f, hashes[j]) << j;
+        }
+        /* The groups are aligned to and smaller than a word of _result */
+        _result[i / 64] = (_result[i / 64] & ~(((1ULL << n) - 1) << (i % 64)))
+                | (found << (i % 64));
+        nFound += nBitsSet64(found);
+    }
+
+    return (nFound);
+}
+
+/********** Atomic bitmap *****************************************************/
+#ifdef BITOPERATIONS_ATOMIC
+void
+atomicBitSet(uint64_t *const _bits, size_t const _n)
+{
+    __atomic_fetch_or(&_bits[_n / 64], 1ULL << (_n % 64), __ATOMIC_ACQ_REL);
+
+    return;
+}
+
+void
+atomicBitClear(uint64_t *const _bits, size_t const _n)
+{
+    __atomic_fetch_and(&_bits[_n / 64], ~(1ULL << (_n % 64)),
+                       __ATOMIC_ACQ_REL);
+
+    return;
+}
+
+bool
+atomicBitTestAndSet(uint64_t *const _bits, size_t const _n)
+{
+    uint64_t const bit = 1ULL << (_n % 64);
+
+    return ((__atomic_fetch_or(&_bits[_n / 64], bit, __ATOMIC_ACQ_REL) & bit)
+            != 0);
+}
+
+bool
+atomicBitTestAndClear(uint64_t *const _bits, size_t const _n)
+{
+    uint64_t const bit = 1ULL << (_n % 64);
+
+    return ((__atomic_fetch_and(&_bits[_n / 64], ~bit, __ATOMIC_ACQ_REL) & bit)
+            != 0);
+}
+
+size_t
+atomicBitAcquireFirstZero(uint64_t *const _bits, size_t const _nBits,
+        size_t const _hint)
+{
+    size_t const nWords = BITBUF_NWORDS(_nBits);
+    size_t w = (_hint < _nBits) ? _hint / 64 : 0;
+
+    for (size_t i = 0; i < nWords; i++) {
+        /* The bits beyond the end of the buffer count as set */
+        uint64_t const end = (w == nWords - 1 && _nBits % 64 != 0)
+                ? ~0ULL << (_nBits % 64) : 0;
+        uint64_t word = __atomic_load_n(&_bits[w], __ATOMIC_RELAXED);
+
+        while ((word | end) != ~0ULL) {
+            uint8_t const n = nTrailingZeros64(~(word | end));
+
+            word = __atomic_fetch_or(&_bits[w], 1ULL << n, __ATOMIC_ACQ_REL);
+            if ((word & (1ULL << n)) == 0) {
+                return (64 * w + n);
+            }
+        }
+        w = (w + 1 == nWords) ? 0 : w + 1;
+    }
+
+    return (_nBits);
+}
+#endif	/* BITOPERATIONS_ATOMIC */
+
+/********** Hierarchical bitmap ***********************************************/
+size_t
+hierarchicalBitmapNWords(size_t const _nBits)
+{
+    size_t w = BITBUF_NWORDS(_nBits);
+    size_t n = w;
+
+    while (w > 1) {
+        w = BITBUF_NWORDS(w);
+        n += 2 * w;
+    }
+
+    return (n);
+}
+
+void
+hierarchicalBitmapInit(HierarchicalBitmap *const _b, uint64_t *const _words,
+        size_t const _nBits)
+{
+    size_t w = BITBUF_NWORDS(_nBits);
+    uint8_t l = 1;
+
+    memset(_words, 0, hierarchicalBitmapNWords(_nBits) * sizeof(uint64_t));
+    _b->nBits = _nBits;
+    _b->nonEmpty[0] = _words;
+    _b->nonFull[0] = NULL;
+    _b->nWords[0] = w;
+    for (uint64_t *p = &_words[w]; w > 1; l++) {
+        w = BITBUF_NWORDS(w);
+        _b->nonEmpty[l] = p;
+        _b->nonFull[l] = &p[w];
+        _b->nWords[l] = w;
+        p += 2 * w;
+        /* Every word of the level below is not full */
+        fillBits(_b->nonFull[l], 0, _b->nWords[l - 1], true);
+    }
+    _b->nLevels = l;
+
+    return;
+}
+
+/** Mask of the bits of word _w of the bitmap that are in the bitmap. */
+static uint64_t
+hierarchicalBitmapValid(HierarchicalBitmap const *const _b, size_t const _w)
+{
+    return ((_w + 1 == _b->nWords[0] && _b->nBits % 64 != 0)
+            ? (1ULL << (_b->nBits % 64)) - 1 : ~0ULL);
+}
+
+void
+hierarchicalBitmapSet(HierarchicalBitmap *const _b, size_t const _n)
+{
+    uint64_t *const word = &_b->nonEmpty[0][_n / 64];
+    uint64_t const old = *word;
+
+    *word |= 1ULL << (_n % 64);
+    if (*word == old) {
+        return;
+    }
+    /* The word became non-empty: propagate while summary words were empty */
+    if (old == 0) {
+        for (size_t i = _n / 64, l = 1; l < _b->nLevels; l++, i /= 64) {
+            uint64_t const was = _b->nonEmpty[l][i / 64];
+
+            _b->nonEmpty[l][i / 64] = was | (1ULL << (i % 64));
+            if (was != 0) {
+                break;
+            }
+        }
+    }
+    /* The word became full: propagate while summary words become all full */
+    if (*word == hierarchicalBitmapValid(_b, _n / 64)) {
+        for (size_t i = _n / 64, l = 1; l < _b->nLevels; l++, i /= 64) {
+            _b->nonFull[l][i / 64] &= ~(1ULL << (i % 64));
+            if (_b->nonFull[l][i / 64] != 0) {
+                break;
+            }
+        }
+    }
+
+    return;
+}
+
+void
+hierarchicalBitmapClear(HierarchicalBitmap *const _b, size_t const _n)
+{
+    uint64_t *const word = &_b->nonEmpty[0][_n / 64];
+    uint64_t const old = *word;
+
+    *word &= ~(1ULL << (_n % 64));
+    if (*word == old) {
+        return;
+    }
+    /* The word became empty: propagate while summary words become empty */
+    if (*word == 0) {
+        for (size_t i = _n / 64, l = 1; l < _b->nLevels; l++, i /= 64) {
+            _b->nonEmpty[l][i / 64] &= ~(1ULL << (i % 64));
+            if (_b->nonEmpty[l][i / 64] != 0) {
+                break;
+            }
+        }
+    }
+    /* The word was full: propagate while summary words were all full */
+    if (old == hierarchicalBitmapValid(_b, _n / 64)) {
+        for (size_t i = _n / 64, l = 1; l < _b->nLevels; l++, i /= 64) {
+            uint64_t const was = _b->nonFull[l][i / 64];
+
+            _b->nonFull[l][i / 64] = was | (1ULL << (i % 64));
+            if (was != 0) {
+                break;
+            }
+        }
+    }
+
+    return;
+}
+
+bool
+hierarchicalBitmapGet(HierarchicalBitmap const *const _b, size_t const _n)
+{
+    return ((_b->nonEmpty[0][_n / 64] >> (_n % 64)) & 1);
+}
+
+/**
+ * Word _w of level _l of the set bits, or of the cleared bits if _zero is
+ * true.
+ */
+static uint64_t
+hierarchicalBitmapWord(HierarchicalBitmap const *const _b, bool const _zero,
+        uint8_t const _l, size_t const _w)
+{
+    if (!_zero) {
+        return (_b->nonEmpty[_l][_w]);
+    } else if (_l > 0) {
+        return (_b->nonFull[_l][_w]);
+    } else {
+        return (~_b->nonEmpty[0][_w] & hierarchicalBitmapValid(_b, _w));
+    }
+}
+
+/**
+ * Find the first set, or cleared, bit from bit _n onwards. Go up the levels
+ * until the rest of a word has a bit set, then down along the lowest set bits.
+ */
+static size_t
+hierarchicalBitmapNext(HierarchicalBitmap const *const _b, size_t const _n,
+        bool const _zero)
+{
+    size_t i = _n;
+    uint8_t l = 0;
+
+    if (_n >= _b->nBits) {
+        return (_b->nBits);
+    }
+    for (;;) {
+        uint64_t const word = hierarchicalBitmapWord(_b, _zero, l, i / 64)
+                & (~0ULL << (i % 64));
+
+        if (word != 0) {
+            i = 64 * (i / 64) + nTrailingZeros64(word);
+            break;
+        }
+        i = i / 64 + 1;
+        if (i >= _b->nWords[l] || ++l == _b->nLevels) {
+            return (_b->nBits);
+        }
+    }
+    while (l > 0) {
+        l--;
+        i = 64 * i + nTrailingZeros64(hierarchicalBitmapWord(_b, _zero, l, i));
+    }
+
+    return (i);
+}
+
+size_t
+hierarchicalBitmapNextSet(HierarchicalBitmap const *const _b, size_t const _n)
+{
+    return (hierarchicalBitmapNext(_b, _n, false));
+}
+
+size_t
+hierarchicalBitmapNextZero(HierarchicalBitmap const *const _b,
+        size_t const _n)
+{
+    return (hierarchicalBitmapNext(_b, _n, true));
+}
+
+size_t
+hierarchicalBitmapPrevSet(HierarchicalBitmap const *const _b, size_t const _n)
+{
+    size_t i = (_n < _b->nBits) ? _n : _b->nBits - 1;
+    uint8_t l = 0;
+
+    if (_b->nBits == 0) {
+        return (0);
+    }
+    for (;;) {
+        uint64_t const word = _b->nonEmpty[l][i / 64]
+                & (~0ULL >> (63 - i % 64));
+
+        if (word != 0) {
+            i = 64 * (i / 64) + 63 - nLeadingZeros64(word);
+            break;
+        }
+        if (i < 64 || ++l == _b->nLevels) {
+            return (_b->nBits);
+        }
+        i = i / 64 - 1;
+    }
+    while (l > 0) {
+        l--;
+        i = 64 * i + 63 - nLeadingZeros64(_b->nonEmpty[l][i]);
+    }
+
+    return (i);
+}
+
+bool
+hierarchicalBitmapIsRangeEmpty(HierarchicalBitmap const *const _b,
+        size_t const _first, size_t const _nBits)
+{
+    return (_nBits == 0
+            || hierarchicalBitmapNextSet(_b, _first) >= _first + _nBits);
+}
+
+/********** Priority bitmap ***************************************************/
+void
+priorityBitmapInit(PriorityBitmap *const _b)
+{
+    memset(_b, 0, sizeof(*_b));
+
+    return;
+}
+
+void
+priorityBitmapSet(PriorityBitmap *const _b, uint16_t const _priority)
+{
+    _b->words[_priority / 64] |= 1ULL << (_priority % 64);
+    _b->summary |= 1ULL << (_priority / 64);
+
+    return;
+}
+
+void
+priorityBitmapClear(PriorityBitmap *const _b, uint16_t const _priority)
+{
+    _b->words[_priority / 64] &= ~(1ULL << (_priority % 64));
+    if (_b->words[_priority / 64] == 0) {
+        _b->summary &= ~(1ULL << (_priority / 64));
+    }
+
+    return;
+}
+
+int16_t
+priorityBitmapHighest(PriorityBitmap const *const _b)
+{
+    uint8_t w;
+
+    if (_b->summary == 0) {
+        return (-1);
+    }
+    w = 63 - nLeadingZeros64(_b->summary);
+
+    return ((int16_t)(64 * w + 63 - nLeadingZeros64(_b->words[w])));
+}
+
+#ifdef BITOPERATIONS_ATOMIC
+void
+atomicPriorityBitmapSet(PriorityBitmap *const _b, uint16_t const _priority)
+{
+    __atomic_fetch_or(&_b->words[_priority / 64], 1ULL << (_priority % 64),
+                      __ATOMIC_SEQ_CST);
+
+    return;
+}
+
+void
+atomicPriorityBitmapClear(PriorityBitmap *const _b, uint16_t const _priority)
+{
+    __atomic_fetch_and(&_b->words[_priority / 64],
+                       ~(1ULL << (_priority % 64)), __ATOMIC_SEQ_CST);
+
+    return;
+}
+
+/**
+ * The summary cannot be kept exact without a lock: between a clear emptying a
+ * word and dropping its summary bit, a set can add a bit to the word whose
+ * summary update is then lost. Scan the few words directly instead, from the
+ * highest down, each with a single load.
+ */
+int16_t
+atomicPriorityBitmapHighest(PriorityBitmap const *const _b)
+{
+    for (uint8_t w = PRIORITY_BITMAP_LEVELS / 64; w > 0; w--) {
+        uint64_t const word = __atomic_load_n(&_b->words[w - 1],
+                                              __ATOMIC_SEQ_CST);
+
+        if (word != 0) {
+            return ((int16_t)(64 * (w - 1) + 63 - nLeadingZeros64(word)));
+        }
+    }
+
+    return (-1);
+}
+#endif	/* BITOPERATIONS_ATOMIC */
+
+/********** Timing wheel ******************************************************/
+/** Move the timers of list _src to the end of list _dst. */
+static void
+timingWheelSplice(TimingWheelTimer *const _dst, TimingWheelTimer *const _src)
+{
+    if (_src->next != _src) {
+        _src->next->prev = _dst->prev;
+        _src->prev->next = _dst;
+        _dst->prev->next = _src->next;
+        _dst->prev = _src->prev;
+        _src->next = _src;
+        _src->prev = _src;
+    }
+
+    return;
+}
+
+/** Take the timers of a slot out of the wheel into list _list. */
+static void
+timingWheelTake(TimingWheel *const _w, uint16_t const _slot,
+        TimingWheelTimer *const _list)
+{
+    timingWheelTimerInit(_list);
+    timingWheelSplice(_list, &_w->slots[_slot]);
+    if (_slot != TIMING_WHEEL_OVERFLOW) {
+        _w->occupied[_slot / 64] &= ~(1ULL << (_slot % 64));
+    }
+
+    return;
+}
+
+void
+timingWheelTimerInit(TimingWheelTimer *const _t)
+{
+    _t->next = _t;
+    _t->prev = _t;
+    _t->expiry = 0;
+    _t->slot = TIMING_WHEEL_NONE;
+
+    return;
+}
+
+void
+timingWheelInit(TimingWheel *const _w, uint64_t const _now)
+{
+    _w->now = _now;
+    _w->later = UINT64_MAX;
+    memset(_w->occupied, 0, sizeof(_w->occupied));
+    for (uint16_t i = 0; i <= TIMING_WHEEL_OVERFLOW; i++) {
+        timingWheelTimerInit(&_w->slots[i]);
+    }
+
+    return;
+}
+
+void
+timingWheelInsert(TimingWheel *const _w, TimingWheelTimer *const _t,
+        uint64_t const _expiry)
+{
+    uint64_t const e = (_expiry < _w->now) ? _w->now : _expiry;
+    uint64_t const diff = e ^ _w->now;
+    uint8_t const l = (diff == 0) ? 0 : (63 - nLeadingZeros64(diff)) / 6;
+    TimingWheelTimer *head;
+
+    timingWheelCancel(_w, _t);
+    _t->expiry = _expiry;
+    if (l >= TIMING_WHEEL_LEVELS) {
+        /* Place it when the top level reaches the range of its expiry */
+        uint64_t const t = e >> (6 * TIMING_WHEEL_LEVELS)
+                << (6 * TIMING_WHEEL_LEVELS);
+
+        _w->later = (t < _w->later) ? t : _w->later;
+        _t->slot = TIMING_WHEEL_OVERFLOW;
+    } else {
+        _t->slot = 64 * l + ((e >> (6 * l)) & 63);
+        _w->occupied[l] |= 1ULL << (_t->slot % 64);
+    }
+    head = &_w->slots[_t->slot];
+    _t->next = head;
+    _t->prev = head->prev;
+    head->prev->next = _t;
+    head->prev = _t;
+
+    return;
+}
+
+void
+timingWheelCancel(TimingWheel *const _w, TimingWheelTimer *const _t)
+{
+    _t->next->prev = _t->prev;
+    _t->prev->next = _t->next;
+    if (_t->slot < TIMING_WHEEL_OVERFLOW
+            && _w->slots[_t->slot].next == &_w->slots[_t->slot]) {
+        _w->occupied[_t->slot / 64] &= ~(1ULL << (_t->slot % 64));
+    }
+    _t->next = _t;
+    _t->prev = _t;
+    _t->slot = TIMING_WHEEL_NONE;
+
+    return;
+}
+
+uint64_t
+timingWheelNextTick(TimingWheel const *const _w)
+{
+    uint64_t next = UINT64_MAX;
+
+    for (uint8_t l = 0; l < TIMING_WHEEL_LEVELS; l++) {
+        uint8_t const shift = 6 * l;
+        uint8_t const current = (_w->now >> shift) & 63;
+        /* The current slot of a level is due only at its first tick, later
+         * slots at theirs
+         */
+        uint64_t const due = ((_w->now & ((1ULL << shift) - 1)) == 0)
+                ? ~0ULL << current : (~0ULL << current) << 1;
+        uint64_t const slots = _w->occupied[l] & due;
+
+        if (slots != 0) {
+            uint64_t const t = ((_w->now >> shift >> 6 << 6)
+                    + nTrailingZeros64(slots)) << shift;
+
+            next = (t < next) ? t : next;
+        }
+    }
+
+    return ((_w->later < next) ? _w->later : next);
+}
+
+size_t
+timingWheelAdvance(TimingWheel *const _w, uint64_t const _now,
+        TimingWheelTimer *const _expired)
+{
+    size_t n = 0;
+    uint64_t t;
+
+    while ((t = timingWheelNextTick(_w)) <= _now) {
+        TimingWheelTimer list;
+
+        _w->now = t;
+        if (t == _w->later) {
+            _w->later = UINT64_MAX;
+            timingWheelTake(_w, TIMING_WHEEL_OVERFLOW, &list);
+        } else {
+            timingWheelTimerInit(&list);
+        }
+        /* Move the timers of the slots that start now down the levels */
+        for (uint8_t l = TIMING_WHEEL_LEVELS - 1; l > 0; l--) {
+            uint8_t const s = (t >> (6 * l)) & 63;
+
+            if (t % (1ULL << (6 * l)) == 0 && bitGet(_w->occupied[l], s)) {
+                TimingWheelTimer slot;
+
+                timingWheelTake(_w, 64 * l + s, &slot);
+                timingWheelSplice(&list, &slot);
+            }
+        }
+        while (list.next != &list) {
+            timingWheelInsert(_w, list.next, list.next->expiry);
+        }
+
+        if (bitGet(_w->occupied[0], t & 63)) {
+            TimingWheelTimer *const head = &_w->slots[t & 63];
+
+            for (TimingWheelTimer *x = head->next; x != head; x = x->next) {
+                x->slot = TIMING_WHEEL_NONE;
+                n++;
+            }
+            timingWheelTake(_w, t & 63, &list);
+            timingWheelSplice(_expired, &list);
+        }
+        _w->now = t + 1;
+    }
+    _w->now = (_now + 1 > _w->now) ? _now + 1 : _w->now;
+
+    return (n);
+}
+
+/********** Slab allocator ****************************************************/
+size_t
+slabAllocatorNWords(size_t const _nSlabs, size_t const _slabObjects)
+{
+    return (2 * _nSlabs * (_slabObjects / 64));
+}
+
+void
+slabAllocatorInit(SlabAllocator *const _a, void *const _objects,
+        size_t const _objectSize, uint64_t *const _words,
+        size_t const _nSlabs, size_t const _slabObjects)
+{
+    size_t const nWords = _nSlabs * (_slabObjects / 64);
+
+    _a->objects = _objects;
+    _a->used = _words;
+    _a->freed = _words + nWords;
+    _a->objectSize = _objectSize;
+    _a->slabObjects = _slabObjects;
+    _a->nSlabs = _nSlabs;
+    _a->active = 0;
+    memset(_words, 0, 2 * nWords * sizeof(*_words));
+
+    return;
+}
+
+/** Move the objects of a slab freed by other threads to its free slots. */
+static void
+slabAllocatorCollect(SlabAllocator *const _a, size_t const _slab)
+{
+    size_t const first = _slab * (_a->slabObjects / 64);
+
+    for (size_t w = first; w < first + _a->slabObjects / 64; w++) {
+#ifdef BITOPERATIONS_ATOMIC
+        if (__atomic_load_n(&_a->freed[w], __ATOMIC_RELAXED) != 0) {
+            BIT_CLEARm(_a->used[w],
+                       __atomic_exchange_n(&_a->freed[w], 0,
+                                           __ATOMIC_ACQ_REL));
+        }
+#else
+        BIT_CLEARm(_a->used[w], _a->freed[w]);
+        _a->freed[w] = 0;
+#endif	/* BITOPERATIONS_ATOMIC */
+    }
+
+    return;
+}
+
+/** Allocate the first free object of a slab, or return NULL if it is full. */
+static void *
+slabAllocatorTake(SlabAllocator *const _a, size_t const _slab)
+{
+    size_t const first = _slab * (_a->slabObjects / 64);
+
+    for (size_t w = first; w < first + _a->slabObjects / 64; w++) {
+        if (_a->used[w] != ~0ULL) {
+            uint8_t const n = nTrailingZeros64(~_a->used[w]);
+
+            BIT_SET(_a->used[w], n);
+            return (_a->objects + (64 * w + n) * _a->objectSize);
+        }
+    }
+
+    return (NULL);
+}
+
+void *
+slabAllocatorAlloc(SlabAllocator *const _a)
+{
+    void *object = slabAllocatorTake(_a, _a->active);
+    size_t best = _a->nSlabs;
+    size_t bestOccupancy = 0;
+
+    if (object != NULL) {
+        return (object);
+    }
+    for (size_t s = 0; s < _a->nSlabs; s++) {
+        size_t const occupancy = slabAllocatorOccupancy(_a, s);
+
+        if (occupancy < _a->slabObjects
+                && (best == _a->nSlabs || occupancy > bestOccupancy)) {
+            best = s;
+            bestOccupancy = occupancy;
+        }
+    }
+    if (best == _a->nSlabs) {
+        return (NULL);
+    }
+    _a->active = best;
+
+    return (slabAllocatorTake(_a, best));
+}
+
+void
+slabAllocatorFree(SlabAllocator *const _a, void *const _object)
+{
+    size_t const n = ((uint8_t *)_object - _a->objects) / _a->objectSize;
+
+    BIT_CLEAR(_a->used[n / 64], n % 64);
+
+    return;
+}
+
+size_t
+slabAllocatorOccupancy(SlabAllocator *const _a, size_t const _slab)
+{
+    size_t const first = _slab * (_a->slabObjects / 64);
+    size_t n = 0;
+
+    slabAllocatorCollect(_a, _slab);
+    for (size_t w = first; w < first + _a->slabObjects / 64; w++) {
+        n += nBitsSet64(_a->used[w]);
+    }
+
+    return (n);
+}
+
+size_t
+slabAllocatorReclaimCandidate(SlabAllocator *const _a)
+{
+    size_t best = _a->active;
+    size_t bestOccupancy = SIZE_MAX;
+
+    for (size_t s = 0; s < _a->nSlabs; s++) {
+        if (s != _a->active) {
+            size_t const occupancy = slabAllocatorOccupancy(_a, s);
+
+            if (occupancy < bestOccupancy) {
+                best = s;
+                bestOccupancy = occupancy;
+            }
+        }
+    }
+
+    return (best);
+}
+
+#ifdef BITOPERATIONS_ATOMIC
+void
+atomicSlabAllocatorFree(SlabAllocator *const _a, void *const _object)
+{
+    atomicBitSet(_a->freed,
+                 ((uint8_t *)_object - _a->objects) / _a->objectSize);
+
+    return;
+}
+#endif	/* BITOPERATIONS_ATOMIC */
+
+/********** Runs of zeros *****************************************************/
+/** Find the runs of zeros of a length in a word, as a mask of their starts. */
+static uint64_t
+zeroRunStarts(uint64_t const _word, uint8_t const _length)
+{
+    uint64_t m = ~_word;
+    uint8_t n = 1;
+
+    /* Bit i of m is set while the n bits from bit i are zero */
+    while (2 * n <= _length) {
+        m &= m >> n;
+        n *= 2;
+    }
+    if (_length > n) {
+        m &= m >> (_length - n);
+    }
+
+    return (m);
+}
+
+/** Find the first run of zeros of a length in bits _first to _last. */
+static size_t
+zeroRunFirstFit(uint64_t const *const _bits, size_t const _first,
+        size_t const _last, size_t const _length)
+{
+    size_t run = 0;
+    size_t start = _first;
+
+    for (size_t w = _first / 64; 64 * w < _last; w++) {
+        uint64_t word = _bits[w];
+
+        /* Skip a cache line of set bits at a time */
+        if (run == 0 && w % 8 == 0 && 64 * (w + 8) <= _last
+                && 64 * w >= _first) {
+            uint64_t all = ~0ULL;
+
+            for (uint8_t i = 0; i < 8; i++) {
+                all &= _bits[w + i];
+            }
+            if (all == ~0ULL) {
+                w += 7;
+                continue;
+            }
+        }
+        /* The bits outside of the range count as set */
+        if (w == _first / 64) {
+            word |= (1ULL << (_first % 64)) - 1;
+        }
+        if (64 * (w + 1) > _last) {
+            word |= ~0ULL << (_last % 64);
+        }
+
+        if (word == 0) {
+            start = (run == 0) ? 64 * w : start;
+            run += 64;
+        } else {
+            start = (run == 0) ? 64 * w : start;
+            if (run + nTrailingZeros64(word) >= _length) {
+                return (start);
+            }
+            if (_length < 64 && zeroRunStarts(word, _length) != 0) {
+                return (64 * w
+                        + nTrailingZeros64(zeroRunStarts(word, _length)));
+            }
+            run = nLeadingZeros64(word);
+            start = 64 * (w + 1) - run;
+        }
+        if (run >= _length) {
+            return (start);
+        }
+    }
+
+    return (_last);
+}
+
+/** Find the next run of zeros from bit _n, up to bit _last. */
+static size_t
+zeroRunNext(uint64_t const *const _bits, size_t const _n, size_t const _last,
+        size_t *const _length)
+{
+    size_t w = _n / 64;
+    uint64_t word;
+    size_t start;
+    size_t end;
+
+    *_length = 0;
+    if (_n >= _last) {
+        return (_last);
+    }
+    word = ~_bits[w] & (~0ULL << (_n % 64));
+    while (word == 0 && 64 * ++w < _last) {
+        word = ~_bits[w];
+    }
+    start = 64 * w + ((word == 0) ? 0 : nTrailingZeros64(word));
+    if (start >= _last) {
+        return (_last);
+    }
+    word = _bits[w] & (~0ULL << (start % 64));
+    while (word == 0 && 64 * ++w < _last) {
+        word = _bits[w];
+    }
+    end = 64 * w + ((word == 0) ? 0 : nTrailingZeros64(word));
+    *_length = ((end < _last) ? end : _last) - start;
+
+    return (start);
+}
+
+size_t
+findZeroRun(uint64_t const *const _bits, size_t const _nBits,
+        size_t const _length, size_t const _hint)
+{
+    size_t const hint = (_hint < _nBits) ? _hint : 0;
+    size_t n = zeroRunFirstFit(_bits, hint, _nBits, _length);
+
+    if (n == _nBits && hint > 0) {
+        /* Wrap around to the runs that start before the hint */
+        size_t const last = (hint + _length - 1 < _nBits)
+                ? hint + _length - 1 : _nBits;
+
+        n = zeroRunFirstFit(_bits, 0, last, _length);
+        n = (n == last) ? _nBits : n;
+    }
+
+    return (n);
+}
+
+size_t
+findZeroRunBestFit(uint64_t const *const _bits, size_t const _nBits,
+        size_t const _length)
+{
+    size_t best = _nBits;
+    size_t bestLength = SIZE_MAX;
+    size_t length;
+
+    for (size_t n = zeroRunNext(_bits, 0, _nBits, &length);
+            n < _nBits && bestLength != _length;
+            n = zeroRunNext(_bits, n + length, _nBits, &length)) {
+        if (length >= _length && length < bestLength) {
+            best = n;
+            bestLength = length;
+        }
+    }
+
+    return (best);
+}
+
+size_t
+zeroRunIndexNChunks(size_t const _nBits)
+{
+    return ((_nBits + ZERO_RUN_CHUNK_BITS - 1) / ZERO_RUN_CHUNK_BITS);
+}
+
+/** Count the runs of zeros of a chunk of a zero run index. */
+static void
+zeroRunIndexUpdate(ZeroRunIndex *const _x, size_t const _chunk)
+{
+    size_t const first = _chunk * ZERO_RUN_CHUNK_BITS;
+    size_t const last = (first + ZERO_RUN_CHUNK_BITS < _x->nBits)
+            ? first + ZERO_RUN_CHUNK_BITS : _x->nBits;
+    size_t length;
+    size_t n = zeroRunNext(_x->bits, first, last, &length);
+
+    _x->head[_chunk] = (n == first) ? length : 0;
+    _x->longest[_chunk] = 0;
+    _x->tail[_chunk] = 0;
+    while (n < last) {
+        _x->longest[_chunk] = (length > _x->longest[_chunk])
+                ? length : _x->longest[_chunk];
+        _x->tail[_chunk] = (n + length == last) ? length : 0;
+        n = zeroRunNext(_x->bits, n + length, last, &length);
+    }
+
+    return;
+}
+
+void
+zeroRunIndexInit(ZeroRunIndex *const _x, uint64_t *const _bits,
+        size_t const _nBits, uint16_t *const _summary)
+{
+    _x->bits = _bits;
+    _x->nBits = _nBits;
+    _x->nChunks = zeroRunIndexNChunks(_nBits);
+    _x->longest = _summary;
+    _x->head = _summary + _x->nChunks;
+    _x->tail = _summary + 2 * _x->nChunks;
+    for (size_t c = 0; c < _x->nChunks; c++) {
+        zeroRunIndexUpdate(_x, c);
+    }
+
+    return;
+}
+
+void
+zeroRunIndexFill(ZeroRunIndex *const _x, size_t const _offset,
+        size_t const _nBits, bool const _f)
+{
+    if (_nBits == 0) {
+        return;
+    }
+    fillBits(_x->bits, _offset, _nBits, _f);
+    for (size_t c = _offset / ZERO_RUN_CHUNK_BITS;
+            c <= (_offset + _nBits - 1) / ZERO_RUN_CHUNK_BITS; c++) {
+        size_t const first = c * ZERO_RUN_CHUNK_BITS;
+        size_t const last = (first + ZERO_RUN_CHUNK_BITS < _x->nBits)
+                ? first + ZERO_RUN_CHUNK_BITS : _x->nBits;
+
+        /* Only the chunks at the ends of the range need to be counted */
+        if (first >= _offset && last <= _offset + _nBits) {
+            _x->longest[c] = _f ? 0 : last - first;
+            _x->head[c] = _x->longest[c];
+            _x->tail[c] = _x->longest[c];
+        } else {
+            zeroRunIndexUpdate(_x, c);
+        }
+    }
+
+    return;
+}
+
+/** Find the first run of zeros of a length in bits _first to _last. */
+static size_t
+zeroRunIndexFit(ZeroRunIndex const *const _x, size_t const _first,
+        size_t const _last, size_t const _length)
+{
+    size_t run = 0;
+    size_t start = _first;
+
+    for (size_t c = _first / ZERO_RUN_CHUNK_BITS;
+            c * ZERO_RUN_CHUNK_BITS < _last; c++) {
+        size_t const first = c * ZERO_RUN_CHUNK_BITS;
+        size_t const end = (first + ZERO_RUN_CHUNK_BITS < _x->nBits)
+                ? first + ZERO_RUN_CHUNK_BITS : _x->nBits;
+        size_t const lo = (first > _first) ? first : _first;
+        size_t const hi = (end < _last) ? end : _last;
+        size_t const head = (lo == first && _x->head[c] < hi - lo)
+                ? _x->head[c] : (lo == first) ? hi - lo : 0;
+
+        start = (run == 0) ? lo : start;
+        if (run + head >= _length) {
+            return (start);
+        }
+        /* Search the chunks of which the runs are not all known */
+        if (lo != first || hi != end || _x->longest[c] >= _length) {
+            size_t const n = zeroRunFirstFit(_x->bits, lo, hi, _length);
+
+            if (n < hi) {
+                return (n);
+            }
+        }
+        if (head == hi - lo) {
+            run += hi - lo;
+        } else {
+            run = (_x->tail[c] < hi - lo) ? _x->tail[c] : hi - lo;
+            start = hi - run;
+        }
+    }
+
+    return (_last);
+}
+
+size_t
+zeroRunIndexFirstFit(ZeroRunIndex const *const _x, size_t const _length,
+        size_t const _hint)
+{
+    size_t const hint = (_hint < _x->nBits) ? _hint : 0;
+    size_t n = zeroRunIndexFit(_x, hint, _x->nBits, _length);
+
+    if (n == _x->nBits && hint > 0) {
+        /* Wrap around to the runs that start before the hint */
+        size_t const last = (hint + _length - 1 < _x->nBits)
+                ? hint + _length - 1 : _x->nBits;
+
+        n = zeroRunIndexFit(_x, 0, last, _length);
+        n = (n == last) ? _x->nBits : n;
+    }
+
+    return (n);
+}
+
+size_t
+zeroRunIndexBestFit(ZeroRunIndex const *const _x, size_t const _length)
+{
+    size_t best = _x->nBits;
+    size_t bestLength = SIZE_MAX;
+    size_t run = 0;
+    size_t start = 0;
+
+    for (size_t c = 0; c < _x->nChunks && bestLength != _length; c++) {
+        size_t const first = c * ZERO_RUN_CHUNK_BITS;
+        size_t const last = (first + ZERO_RUN_CHUNK_BITS < _x->nBits)
+                ? first + ZERO_RUN_CHUNK_BITS : _x->nBits;
+        size_t length;
+
+        start = (run == 0) ? first : start;
+        if (_x->head[c] == last - first) {
+            run += last - first;
+            continue;
+        }
+        /* The run that ends at the start of the chunk */
+        run += _x->head[c];
+        if (run >= _length && run < bestLength) {
+            best = start;
+            bestLength = run;
+        }
+        /* The runs inside of the chunk */
+        if (_x->longest[c] >= _length) {
+            for (size_t n = zeroRunNext(_x->bits, first + _x->head[c], last,
+                                        &length);
+                    n + length < last;
+                    n = zeroRunNext(_x->bits, n + length, last, &length)) {
+                if (length >= _length && length < bestLength) {
+                    best = n;
+                    bestLength = length;
+                }
+            }
+        }
+        run = _x->tail[c];
+        start = last - run;
+    }
+    if (run >= _length && run < bestLength) {
+        best = start;
+    }
+
+    return (best);
+}
+
+/********** Work stealing *****************************************************/
+void
+workDequeInit(WorkDeque *const _d, uint64_t *const _tasks,
+        size_t const _capacity)
+{
+    _d->tasks = _tasks;
+    _d->mask = _capacity - 1;
+    _d->top = 0;
+    _d->bottom = 0;
+
+    return;
+}
+
+#ifdef BITOPERATIONS_ATOMIC
+bool
+atomicWorkDequePush(WorkDeque *const _d, uint64_t const _task)
+{
+    int64_t const b = __atomic_load_n(&_d->bottom, __ATOMIC_RELAXED);
+    int64_t const t = __atomic_load_n(&_d->top, __ATOMIC_ACQUIRE);
+
+    if (b - t > _d->mask) {
+        return (false);
+    }
+    __atomic_store_n(&_d->tasks[b & _d->mask], _task, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&_d->bottom, b + 1, __ATOMIC_RELAXED);
+
+    return (true);
+}
+
+bool
+atomicWorkDequePop(WorkDeque *const _d, uint64_t *const _task)
+{
+    int64_t const b = __atomic_load_n(&_d->bottom, __ATOMIC_RELAXED) - 1;
+    int64_t t;
+    bool popped = true;
+
+    /* Claim the newest task before looking at the thieves */
+    __atomic_store_n(&_d->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    t = __atomic_load_n(&_d->top, __ATOMIC_RELAXED);
+    if (t > b) {
+        __atomic_store_n(&_d->bottom, b + 1, __ATOMIC_RELAXED);
+        return (false);
+    }
+    *_task = __atomic_load_n(&_d->tasks[b & _d->mask], __ATOMIC_RELAXED);
+    if (t == b) {
+        /* The last task, which a thief may take as well */
+        popped = __atomic_compare_exchange_n(&_d->top, &t, t + 1, false,
+                                             __ATOMIC_SEQ_CST,
+                                             __ATOMIC_RELAXED);
+        __atomic_store_n(&_d->bottom, b + 1, __ATOMIC_RELAXED);
+    }
+
+    return (popped);
+}
+
+bool
+atomicWorkDequeSteal(WorkDeque *const _d, uint64_t *const _task)
+{
+    int64_t t = __atomic_load_n(&_d->top, __ATOMIC_ACQUIRE);
+    int64_t b;
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    b = __atomic_load_n(&_d->bottom, __ATOMIC_ACQUIRE);
+    if (t >= b) {
+        return (false);
+    }
+    *_task = __atomic_load_n(&_d->tasks[t & _d->mask], __ATOMIC_RELAXED);
+
+    return (__atomic_compare_exchange_n(&_d->top, &t, t + 1, false,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+}
+
+size_t
+atomicStealVictim(uint64_t const *const _nonEmpty, size_t const _nWorkers,
+        size_t const _thief)
+{
+    size_t const nWords = BITBUF_NWORDS(_nWorkers);
+    size_t const w = _thief / 64;
+    uint64_t const word = __atomic_load_n(&_nonEmpty[w], __ATOMIC_RELAXED);
+    /* The workers after the thief in its word, and then the ones before */
+    uint64_t const after = word & ((~0ULL << (_thief % 64)) << 1);
+    uint64_t const before = word & ((1ULL << (_thief % 64)) - 1);
+
+    if (after != 0) {
+        return (64 * w + nTrailingZeros64(after));
+    }
+    for (size_t i = 1; i < nWords; i++) {
+        size_t const v = (w + i) % nWords;
+        uint64_t const other = __atomic_load_n(&_nonEmpty[v],
+                                               __ATOMIC_RELAXED);
+
+        if (other != 0) {
+            return (64 * v + nTrailingZeros64(other));
+        }
+    }
+
+    return ((before != 0) ? 64 * w + nTrailingZeros64(before) : _nWorkers);
+}
+
+size_t
+atomicWorkerRun(WorkDeque *const _deques, uint64_t *const _nonEmpty,
+        size_t const _nWorkers, size_t const _self, WorkFunction const _run,
+        void *const _context)
+{
+    size_t n = 0;
+    uint64_t task;
+
+    for (;;) {
+        while (atomicWorkDequePop(&_deques[_self], &task)) {
+            _run(_context, task);
+            n++;
+        }
+        atomicBitClear(_nonEmpty, _self);
+        for (;;) {
+            size_t const victim = atomicStealVictim(_nonEmpty, _nWorkers,
+                                                    _self);
+            WorkDeque *const d = &_deques[victim];
+
+            if (victim == _nWorkers) {
+                return (n);
+            }
+            if (atomicWorkDequeSteal(d, &task)) {
+                break;
+            }
+            if (__atomic_load_n(&d->top, __ATOMIC_ACQUIRE)
+                    >= __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE)) {
+                atomicBitClear(_nonEmpty, victim);
+            }
+        }
+        _run(_context, task);
+        n++;
+    }
+}
+#endif	/* BITOPERATIONS_ATOMIC */
+
+/********** Large buffers *****************************************************/
+size_t
+bufferPartition(size_t *const _first, size_t const _nWords,
+        size_t const _minWords, size_t const _nThreads, size_t const _thread)
+{
+    size_t nChunks = (_minWords == 0) ? _nThreads : _nWords / _minWords;
+    size_t words;
+    size_t end;
+
+    nChunks = (nChunks < _nThreads) ? nChunks : _nThreads;
+    nChunks = (nChunks > 0) ? nChunks : 1;
+    words = ((_nWords + nChunks - 1) / nChunks + 7) / 8 * 8;
+    *_first = (_thread < nChunks && _thread * words < _nWords)
+            ? _thread * words : _nWords;
+    end = (*_first + words < _nWords) ? *_first + words : _nWords;
+
+    return (end - *_first);
+}
+
+uint64_t
+countBits(uint64_t const *const _src, size_t const _nWords)
+{
+    uint64_t n = 0;
+    size_t i = 0;
+
+#ifdef BITOPERATIONS_USE_AVX512_POPCNT
+    __m512i sum = _mm512_setzero_si512();
+
+    for (; i + 8 <= _nWords; i += 8) {
+        __m512i const x = _mm512_loadu_si512(&_src[i]);
+
+        sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(x));
+    }
+    n = _mm512_reduce_add_epi64(sum);
+#endif
+    for (; i < _nWords; i++) {
+        n += nBitsSet64(_src[i]);
+    }
+
+    return (n);
+}
+
+bool
+parityBits(uint64_t const *const _src, size_t const _nWords)
+{
+    uint64_t v = 0;
+
+    /* The parity of the XOR of the words is the parity of the buffer */
+    for (size_t i = 0; i < _nWords; i++) {
+        v ^= _src[i];
+    }
+
+    return (isOddParity(v));
+}
+
+void
+andBits(uint64_t *const _dst, uint64_t const *const _a,
+        uint64_t const *const _b, size_t const _nWords)
+{
+    for (size_t i = 0; i < _nWords; i++) {
+        _dst[i] = _a[i] & _b[i];
+    }
+
+    return;
+}
+
+void
+orBits(uint64_t *const _dst, uint64_t const *const _a,
+        uint64_t const *const _b, size_t const _nWords)
+{
+    for (size_t i = 0; i < _nWords; i++) {
+        _dst[i] = _a[i] | _b[i];
+    }
+
+    return;
+}
+
+void
+xorBits(uint64_t *const _dst, uint64_t const *const _a,
+        uint64_t const *const _b, size_t const _nWords)
+{
+    for (size_t i = 0; i < _nWords; i++) {
+        _dst[i] = _a[i] ^ _b[i];
+    }
+
+    return;
+}
+
+uint64_t
+orBitsN(uint64_t *const _dst, uint64_t const *const *const _srcs,
+        size_t const _nSrcs, size_t const _first, size_t const _nWords)
+{
+    uint64_t block[AGGREGATE_BLOCK_WORDS];
+    uint64_t n = 0;
+
+    for (size_t i = _first; i < _first + _nWords; i += AGGREGATE_BLOCK_WORDS) {
+        size_t const words = (_first + _nWords - i < AGGREGATE_BLOCK_WORDS)
+                ? _first + _nWords - i : AGGREGATE_BLOCK_WORDS;
+        uint64_t *const out = (_dst != NULL) ? &_dst[i] : block;
+
+        if (out != &_srcs[0][i]) {
+            memcpy(out, &_srcs[0][i], words * sizeof(*out));
+        }
+        /* Four buffers at a time, to load and store the block less often */
+        for (size_t s = 1; s < _nSrcs; s += 4) {
+            uint64_t const *const a = &_srcs[s][i];
+            uint64_t const *const b = &_srcs[(s + 1 < _nSrcs) ? s + 1 : s][i];
+            uint64_t const *const c = &_srcs[(s + 2 < _nSrcs) ? s + 2 : s][i];
+            uint64_t const *const d = &_srcs[(s + 3 < _nSrcs) ? s + 3 : s][i];
+
+            for (size_t w = 0; w < words; w++) {
+                out[w] |= a[w] | b[w] | c[w] | d[w];
+            }
+        }
+        n += countBits(out, words);
+    }
+
+    return (n);
+}
+
+uint64_t
+andBitsN(uint64_t *const _dst, uint64_t const *const *const _srcs,
+        size_t const _nSrcs, size_t const _first, size_t const _nWords)
+{
+    uint64_t block[AGGREGATE_BLOCK_WORDS];
+    uint64_t n = 0;
+
+    for (size_t i = _first; i < _first + _nWords; i += AGGREGATE_BLOCK_WORDS) {
+        size_t const words = (_first + _nWords - i < AGGREGATE_BLOCK_WORDS)
+                ? _first + _nWords - i : AGGREGATE_BLOCK_WORDS;
+        uint64_t *const out = (_dst != NULL) ? &_dst[i] : block;
+        uint64_t any = 1;
+
+        if (out != &_srcs[0][i]) {
+            memcpy(out, &_srcs[0][i], words * sizeof(*out));
+        }
+        for (size_t s = 1; s < _nSrcs && any != 0; s += 4) {
+            uint64_t const *const a = &_srcs[s][i];
+            uint64_t const *const b = &_srcs[(s + 1 < _nSrcs) ? s + 1 : s][i];
+            uint64_t const *const c = &_srcs[(s + 2 < _nSrcs) ? s + 2 : s][i];
+            uint64_t const *const d = &_srcs[(s + 3 < _nSrcs) ? s + 3 : s][i];
+
+            any = 0;
+            for (size_t w = 0; w < words; w++) {
+                out[w] &= a[w] & b[w] & c[w] & d[w];
+                any |= out[w];
+            }
+        }
+        n += (any != 0) ? countBits(out, words) : 0;
+    }
+
+    return (n);
+}
+
+void
+reverseBits(uint64_t *const _dst, uint64_t const *const _src,
+        size_t const _nWords)
+{
+    for (size_t i = 0; i < _nWords; i++) {
+        _dst[_nWords - 1 - i] = reverseBitOrder64(_src[i]);
+    }
+
+    return;
+}
+
+#ifdef BITOPERATIONS_THREADS
+void
+bufferThreadsInit(BufferThreads *const _t, size_t const _nThreads,
+        bool const _pin)
+{
+    _t->nThreads = _nThreads;
+    _t->minWords = BUFFER_PARTITION_MIN_WORDS;
+    _t->pin = _pin;
+
+    return;
+}
+
+/**
+ * Run a task of a parallel large-buffer function: task j of thread t is the
+ * j-th part of _job->taskWords words of the chunk of thread t.
+ */
+static void
+bufferTask(void *_context, uint64_t _task)
+{
+    BufferWorker *const w = _context;
+    BufferJob const *const job = w->job;
+    size_t first;
+    size_t const chunk = bufferPartition(&first, job->nWords, job->minWords,
+                                         job->nThreads,
+                                         _task / BUFFER_THREAD_TASKS);
+    size_t const offset = (_task % BUFFER_THREAD_TASKS) * job->taskWords;
+    size_t const n = (chunk - offset < job->taskWords)
+            ? chunk - offset : job->taskWords;
+
+    first += offset;
+    switch (job->operation) {
+    case BUFFER_CLEAR:
+        memset(&job->dst[first], 0, n * sizeof(*job->dst));
+        break;
+    case BUFFER_COUNT:
+        w->result += countBits(&job->a[first], n);
+        break;
+    case BUFFER_PARITY:
+        w->result ^= parityBits(&job->a[first], n);
+        break;
+    case BUFFER_AND:
+        andBits(&job->dst[first], &job->a[first], &job->b[first], n);
+        break;
+    case BUFFER_OR:
+        orBits(&job->dst[first], &job->a[first], &job->b[first], n);
+        break;
+    case BUFFER_XOR:
+        xorBits(&job->dst[first], &job->a[first], &job->b[first], n);
+        break;
+    case BUFFER_REVERSE:
+        reverseBits(&job->dst[job->nWords - first - n], &job->a[first], n);
+        break;
+    }
+
+    return;
+}
+
+/**
+ * Run the tasks of a thread of a parallel large-buffer function, and steal
+ * those of the others unless the buffer is being placed by the first touch.
+ */
+static void *
+bufferThread(void *_arg)
+{
+    BufferWorker *const w = _arg;
+    BufferJob *const job = w->job;
+    uint64_t task;
+
+    if (job->operation == BUFFER_CLEAR) {
+        while (atomicWorkDequePop(&job->deques[w->self], &task)) {
+            bufferTask(w, task);
+        }
+    } else {
+        atomicWorkerRun(job->deques, &job->nonEmpty, job->nThreads, w->self,
+                        bufferTask, w);
+    }
+
+    return (NULL);
+}
+
+/**
+ * Run an operation on the chunks of a buffer with threads, and return the
+ * sum or the XOR of the partial results of the threads. A buffer of one
+ * chunk is processed by the calling thread as a single task.
+ */
+static uint64_t
+bufferRun(BufferThreads const *const _t, BufferOperation const _operation,
+        uint64_t *const _dst, uint64_t const *const _a,
+        uint64_t const *const _b, size_t const _nWords)
+{
+    BufferJob job;
+    BufferWorker workers[BUFFER_THREADS_MAX];
+    pthread_t threads[BUFFER_THREADS_MAX];
+    bool started[BUFFER_THREADS_MAX];
+    size_t nThreads = (_t->nThreads < BUFFER_THREADS_MAX)
+            ? _t->nThreads : BUFFER_THREADS_MAX;
+    size_t first;
+    uint64_t result = 0;
+#ifdef __linux__
+    cpu_set_t allowed;
+    bool const pin = _t->pin
+            && sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+#endif
+
+    /* The threads after the last chunk are not needed */
+    while (nThreads > 1 && bufferPartition(&first, _nWords, _t->minWords,
+                                           nThreads, nThreads - 1) == 0) {
+        nThreads--;
+    }
+    job.operation = _operation;
+    job.dst = _dst;
+    job.a = _a;
+    job.b = _b;
+    job.nWords = _nWords;
+    job.minWords = _t->minWords;
+    job.nThreads = nThreads;
+    job.nonEmpty = 0;
+    for (size_t i = 0; i < nThreads; i++) {
+        workers[i].job = &job;
+        workers[i].self = i;
+        workers[i].result = 0;
+    }
+    if (nThreads == 1) {
+        job.taskWords = _nWords;
+        bufferTask(&workers[0], 0);
+        return (workers[0].result);
+    }
+
+    /* Whole cache lines per task, and the tasks of a chunk pushed last to
+     * first, so that its thread runs them in order */
+    job.taskWords = ((bufferPartition(&first, _nWords, _t->minWords, nThreads,
+                                      0) + BUFFER_THREAD_TASKS - 1)
+                     / BUFFER_THREAD_TASKS + 7) / 8 * 8;
+    for (size_t i = 0; i < nThreads; i++) {
+        size_t const chunk = bufferPartition(&first, _nWords, _t->minWords,
+                                             nThreads, i);
+
+        workDequeInit(&job.deques[i], job.tasks[i], BUFFER_THREAD_TASKS);
+        for (size_t j = (chunk + job.taskWords - 1) / job.taskWords; j > 0;
+                j--) {
+            atomicWorkDequePush(&job.deques[i],
+                                i * BUFFER_THREAD_TASKS + j - 1);
+        }
+        job.nonEmpty |= 1ULL << i;
+    }
+
+    for (size_t i = 1; i < nThreads; i++) {
+        pthread_attr_t attr;
+
+        started[i] = false;
+        if (pthread_attr_init(&attr) != 0) {
+            continue;
+        }
+#ifdef __linux__
+        if (pin) {
+            cpu_set_t cpus;
+            size_t cpu = 0;
+
+            /* The i-th CPU that the calling thread may run on */
+            for (size_t n = i % CPU_COUNT(&allowed);
+                    n > 0 || !CPU_ISSET(cpu, &allowed); cpu++) {
+                n -= CPU_ISSET(cpu, &allowed) ? 1 : 0;
+            }
+            CPU_ZERO(&cpus);
+            CPU_SET(cpu, &cpus);
+            pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+        }
+#endif
+        started[i] = (pthread_create(&threads[i], &attr, bufferThread,
+                                     &workers[i]) == 0);
+        pthread_attr_destroy(&attr);
+    }
+    bufferThread(&workers[0]);
+    for (size_t i = 1; i < nThreads; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+    /* The tasks of the threads that could not be started */
+    atomicWorkerRun(job.deques, &job.nonEmpty, nThreads, 0, bufferTask,
+                    &workers[0]);
+
+    for (size_t i = 0; i < nThreads; i++) {
+        result = (_operation == BUFFER_PARITY)
+                ? result ^ workers[i].result : result + workers[i].result;
+    }
+
+    return (result);
+}
+
+void
+parallelClearBits(BufferThreads const *const _t, uint64_t *const _dst,
+        size_t const _nWords)
+{
+    bufferRun(_t, BUFFER_CLEAR, _dst, NULL, NULL, _nWords);
+
+    return;
+}
+
+uint64_t
+parallelCountBits(BufferThreads const *const _t, uint64_t const *const _src,
+        size_t const _nWords)
+{
+    return (bufferRun(_t, BUFFER_COUNT, NULL, _src, NULL, _nWords));
+}
+
+bool
+parallelParityBits(BufferThreads const *const _t, uint64_t const *const _src,
+        size_t const _nWords)
+{
+    return (bufferRun(_t, BUFFER_PARITY, NULL, _src, NULL, _nWords) != 0);
+}
+
+void
+parallelAndBits(BufferThreads const *const _t, uint64_t *const _dst,
+        uint64_t const *const _a, uint64_t const *const _b,
+        size_t const _nWords)
+{
+    bufferRun(_t, BUFFER_AND, _dst, _a, _b, _nWords);
+
+    return;
+}
+
+void
+parallelOrBits(BufferThreads const *const _t, uint64_t *const _dst,
+        uint64_t const *const _a, uint64_t const *const _b,
+        size_t const _nWords)
+{
+    bufferRun(_t, BUFFER_OR, _dst, _a, _b, _nWords);
+
+    return;
+}
+
+void
+parallelXorBits(BufferThreads const *const _t, uint64_t *const _dst,
+        uint64_t const *const _a, uint64_t const *const _b,
+        size_t const _nWords)
+{
+    bufferRun(_t, BUFFER_XOR, _dst, _a, _b, _nWords);
+
+    return;
+}
+
+void
+parallelReverseBits(BufferThreads const *const _t, uint64_t *const _dst,
+        uint64_t const *const _src, size_t const _nWords)
+{
+    bufferRun(_t, BUFFER_REVERSE, _dst, _src, NULL, _nWords);
+
+    return;
+}
+#endif	/* BITOPERATIONS_THREADS */
+
+/********** Sorted sets *******************************************************/
+/**
+ * Find the first value of a sorted set that is not less than _x, from
+ * position _n on, with exponential steps and then a binary search.
+ */
+static size_t
+sortedGallop(uint32_t const *const _set, size_t const _n, size_t const _size,
+        uint32_t const _x)
+{
+    size_t lo = _n;
+    size_t step = 1;
+    size_t hi;
+
+    while (lo + step < _size && _set[lo + step] < _x) {
+        lo += step;
+        step *= 2;
+    }
+    hi = (lo + step < _size) ? lo + step : _size;
+    while (lo < hi) {
+        size_t const mid = lo + (hi - lo) / 2;
+
+        if (_set[mid] < _x) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return (lo);
+}
+
+/** Intersect a small sorted set with a large one by galloping. */
+static size_t
+intersectSortedGallop(uint32_t *const _dst, uint32_t const *const _small,
+        size_t const _nSmall, uint32_t const *const _large,
+        size_t const _nLarge)
+{
+    size_t n = 0;
+    size_t j = 0;
+
+    for (size_t i = 0; i < _nSmall && j < _nLarge; i++) {
+        j = sortedGallop(_large, j, _nLarge, _small[i]);
+        if (j < _nLarge && _large[j] == _small[i]) {
+            if (_dst != NULL) {
+                _dst[n] = _small[i];
+            }
+            n++;
+        }
+    }
+
+    return (n);
+}
+
+size_t
+intersectSorted(uint32_t *const _dst, uint32_t const *const _a,
+        size_t const _nA, uint32_t const *const _b, size_t const _nB)
+{
+    size_t n = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    if (_nA * SORTED_SET_GALLOP_RATIO < _nB) {
+        return (intersectSortedGallop(_dst, _a, _nA, _b, _nB));
+    }
+    if (_nB * SORTED_SET_GALLOP_RATIO < _nA) {
+        return (intersectSortedGallop(_dst, _b, _nB, _a, _nA));
+    }
+
+#ifdef BITOPERATIONS_USE_SSE2
+    while (i + 4 <= _nA && j + 4 <= _nB) {
+        __m128i const va = _mm_loadu_si128((__m128i const *)&_a[i]);
+        __m128i const vb = _mm_loadu_si128((__m128i const *)&_b[j]);
+        /* Compare every value of a with every value of b */
+        __m128i const eq = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                    _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x39))),
+                _mm_or_si128(
+                    _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x4E)),
+                    _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x93))));
+        uint32_t mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+        uint32_t const maxA = _a[i + 3];
+        uint32_t const maxB = _b[j + 3];
+
+        while (mask != 0) {
+            if (_dst != NULL) {
+                _dst[n] = _a[i + nTrailingZeros64(mask)];
+            }
+            n++;
+            mask &= mask - 1;
+        }
+        i += (maxA <= maxB) ? 4 : 0;
+        j += (maxB <= maxA) ? 4 : 0;
+    }
+#endif
+    while (i < _nA && j < _nB) {
+        uint32_t const x = _a[i];
+        uint32_t const y = _b[j];
+
+        if (x == y && _dst != NULL) {
+            _dst[n] = x;
+        }
+        n += (x == y);
+        i += (x <= y);
+        j += (y <= x);
+    }
+
+    return (n);
+}
+
+size_t
+uniteSorted(uint32_t *const _dst, uint32_t const *const _a,
+        size_t const _nA, uint32_t const *const _b, size_t const _nB)
+{
+    size_t n = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    if (_dst == NULL) {
+        return (_nA + _nB - intersectSorted(NULL, _a, _nA, _b, _nB));
+    }
+    while (i < _nA && j < _nB) {
+        uint32_t const x = _a[i];
+        uint32_t const y = _b[j];
+
+        _dst[n++] = (x <= y) ? x : y;
+        i += (x <= y);
+        j += (y <= x);
+    }
+    memcpy(&_dst[n], &_a[i], (_nA - i) * sizeof(*_dst));
+    n += _nA - i;
+    memcpy(&_dst[n], &_b[j], (_nB - j) * sizeof(*_dst));
+    n += _nB - j;
+
+    return (n);
+}
+
+size_t
+subtractSorted(uint32_t *const _dst, uint32_t const *const _a,
+        size_t const _nA, uint32_t const *const _b, size_t const _nB)
+{
+    size_t n = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    if (_dst == NULL) {
+        return (_nA - intersectSorted(NULL, _a, _nA, _b, _nB));
+    }
+    if (_nB * SORTED_SET_GALLOP_RATIO < _nA) {
+        /* Copy the runs of _a between the values of _b */
+        for (; j < _nB && i < _nA; j++) {
+            size_t const k = sortedGallop(_a, i, _nA, _b[j]);
+
+            memcpy(&_dst[n], &_a[i], (k - i) * sizeof(*_dst));
+            n += k - i;
+            i = (k < _nA && _a[k] == _b[j]) ? k + 1 : k;
+        }
+    } else if (_nA * SORTED_SET_GALLOP_RATIO < _nB) {
+        for (; i < _nA; i++) {
+            j = sortedGallop(_b, j, _nB, _a[i]);
+            if (j == _nB || _b[j] != _a[i]) {
+                _dst[n++] = _a[i];
+            }
+        }
+    } else {
+        while (i < _nA && j < _nB) {
+            uint32_t const x = _a[i];
+            uint32_t const y = _b[j];
+
+            if (x < y) {
+                _dst[n++] = x;
+            }
+            i += (x <= y);
+            j += (y <= x);
+        }
+    }
+    memcpy(&_dst[n], &_a[i], (_nA - i) * sizeof(*_dst));
+    n += _nA - i;
+
+    return (n);
+}
+
+void
+sortedToBits(uint64_t *const _bits, uint32_t const *const _values,
+        size_t const _n)
+{
+    for (size_t i = 0; i < _n; i++) {
+        BIT_SET(_bits[_values[i] / 64], _values[i] % 64);
+    }
+
+    return;
+}
+
+size_t
+bitsToSorted(uint32_t *const _values, uint64_t const *const _bits,
+        size_t const _nWords)
+{
+    size_t n = 0;
+
+    for (size_t w = 0; w < _nWords; w++) {
+        for (uint64_t v = _bits[w]; v != 0; v &= v - 1) {
+            _values[n++] = 64 * w + nTrailingZeros64(v);
+        }
+    }
+
+    return (n);
+}
+
+/********** Bit-sliced index **************************************************/
+size_t
+bitSlicedIndexNWords(size_t const _nRows, uint8_t const _nSlices)
+{
+    return (_nSlices * BITBUF_NWORDS(_nRows));
+}
+
+void
+bitSlicedIndexInit(BitSlicedIndex *const _x, uint64_t *const _slices,
+        size_t const _nRows, uint8_t const _nSlices)
+{
+    _x->slices = _slices;
+    _x->nRows = _nRows;
+    _x->nWords = BITBUF_NWORDS(_nRows);
+    _x->nSlices = _nSlices;
+    memset(_slices, 0, _nSlices * _x->nWords * sizeof(*_slices));
+
+    return;
+}
+
+void
+bitSlicedIndexLoad(BitSlicedIndex *const _x, uint32_t const *const _values,
+        size_t const _n)
+{
+    uint64_t m[64];
+
+    for (size_t w = 0; w < BITBUF_NWORDS(_n); w++) {
+        /* Row r of the matrix is a value, and row s of the transpose a slice */
+        for (uint8_t r = 0; r < 64; r++) {
+            m[r] = (64 * w + r < _n) ? _values[64 * w + r] : 0;
+        }
+        transposeBits64x64(m, m);
+        for (uint8_t s = 0; s < _x->nSlices; s++) {
+            uint64_t const rows = (64 * (w + 1) <= _n)
+                    ? ~0ULL : (1ULL << (_n % 64)) - 1;
+
+            _x->slices[s * _x->nWords + w] =
+                    (_x->slices[s * _x->nWords + w] & ~rows) | m[s];
+        }
+    }
+
+    return;
+}
+
+void
+bitSlicedIndexSet(BitSlicedIndex *const _x, size_t const _row,
+        uint32_t const _value)
+{
+    for (uint8_t s = 0; s < _x->nSlices; s++) {
+        uint64_t *const w = &_x->slices[s * _x->nWords + _row / 64];
+
+        *w = (*w & ~(1ULL << (_row % 64)))
+                | ((uint64_t)((_value >> s) & 1) << (_row % 64));
+    }
+
+    return;
+}
+
+uint32_t
+bitSlicedIndexGet(BitSlicedIndex const *const _x, size_t const _row)
+{
+    uint32_t v = 0;
+
+    for (uint8_t s = 0; s < _x->nSlices; s++) {
+        v |= (uint32_t)((_x->slices[s * _x->nWords + _row / 64]
+                         >> (_row % 64)) & 1) << s;
+    }
+
+    return (v);
+}
+
+size_t
+bitSlicedIndexBetween(BitSlicedIndex const *const _x, uint64_t *const _dst,
+        uint32_t const _lo, uint32_t const _hi)
+{
+    uint64_t lt[AGGREGATE_BLOCK_WORDS], eqHi[AGGREGATE_BLOCK_WORDS];
+    uint64_t gt[AGGREGATE_BLOCK_WORDS], eqLo[AGGREGATE_BLOCK_WORDS];
+    /* Bounds beyond the bits of the values select all or no rows */
+    bool const allBelowHi = ((uint64_t)_hi >> _x->nSlices) != 0;
+    bool const noneAboveLo = ((uint64_t)_lo >> _x->nSlices) != 0;
+    size_t n = 0;
+
+    for (size_t i = 0; i < _x->nWords; i += AGGREGATE_BLOCK_WORDS) {
+        size_t const words = (_x->nWords - i < AGGREGATE_BLOCK_WORDS)
+                ? _x->nWords - i : AGGREGATE_BLOCK_WORDS;
+
+        for (size_t w = 0; w < words; w++) {
+            lt[w] = 0;
+            gt[w] = 0;
+            eqHi[w] = ~0ULL;
+            eqLo[w] = ~0ULL;
+        }
+        /* Rows stay equal to a bound while their bits match it */
+        for (uint8_t s = _x->nSlices; s-- > 0;) {
+            uint64_t const *const b = &_x->slices[s * _x->nWords + i];
+
+            if ((_hi >> s) & 1) {
+                for (size_t w = 0; w < words; w++) {
+                    lt[w] |= eqHi[w] & ~b[w];
+                    eqHi[w] &= b[w];
+                }
+            } else {
+                for (size_t w = 0; w < words; w++) {
+                    eqHi[w] &= ~b[w];
+                }
+            }
+            if ((_lo >> s) & 1) {
+                for (size_t w = 0; w < words; w++) {
+                    eqLo[w] &= b[w];
+                }
+            } else {
+                for (size_t w = 0; w < words; w++) {
+                    gt[w] |= eqLo[w] & b[w];
+                    eqLo[w] &= ~b[w];
+                }
+            }
+        }
+        for (size_t w = 0; w < words; w++) {
+            uint64_t const rows = (64 * (i + w + 1) <= _x->nRows)
+                    ? ~0ULL : (1ULL << (_x->nRows % 64)) - 1;
+
+            _dst[i + w] = (allBelowHi ? rows : (lt[w] | eqHi[w]) & rows)
+                    & (noneAboveLo ? 0 : gt[w] | eqLo[w]);
+            n += nBitsSet64(_dst[i + w]);
+        }
+    }
+
+    return (n);
+}
+
+size_t
+bitSlicedIndexLess(BitSlicedIndex const *const _x, uint64_t *const _dst,
+        uint32_t const _c)
+{
+    if (_c == 0) {
+        memset(_dst, 0, _x->nWords * sizeof(*_dst));
+        return (0);
+    }
+
+    return (bitSlicedIndexBetween(_x, _dst, 0, _c - 1));
+}
+
+size_t
+bitSlicedIndexLessEqual(BitSlicedIndex const *const _x, uint64_t *const _dst,
+        uint32_t const _c)
+{
+    return (bitSlicedIndexBetween(_x, _dst, 0, _c));
+}
+
+size_t
+bitSlicedIndexEqual(BitSlicedIndex const *const _x, uint64_t *const _dst,
+        uint32_t const _c)
+{
+    return (bitSlicedIndexBetween(_x, _dst, _c, _c));
+}
+
+uint64_t
+bitSlicedIndexSum(BitSlicedIndex const *const _x,
+        uint64_t const *const _filter)
+{
+    uint64_t sum = 0;
+
+    for (uint8_t s = 0; s < _x->nSlices; s++) {
+        uint64_t const *const b = &_x->slices[s * _x->nWords];
+        uint64_t n = 0;
+
+        if (_filter == NULL) {
+            n = countBits(b, _x->nWords);
+        } else {
+            for (size_t i = 0; i < _x->nWords; i += AGGREGATE_BLOCK_WORDS) {
+                n += nBitsSetAnd(&b[i], &_filter[i],
+                                 (_x->nWords - i < AGGREGATE_BLOCK_WORDS)
+                                 ? _x->nWords - i : AGGREGATE_BLOCK_WORDS);
+            }
+        }
+        sum += n << s;
+    }
+
+    return (sum);
+}
+
+size_t
+bitSlicedIndexTopK(BitSlicedIndex const *const _x, uint64_t *const _dst,
+        uint64_t *const _scratch, size_t const _k)
+{
+    uint64_t *const e = _scratch;
+    size_t n = 0;
+
+    /* _dst holds the rows that are selected, e the rows that may be */
+    memset(_dst, 0, _x->nWords * sizeof(*_dst));
+    for (size_t w = 0; w < _x->nWords; w++) {
+        e[w] = (64 * (w + 1) <= _x->nRows)
+                ? ~0ULL : (1ULL << (_x->nRows % 64)) - 1;
+    }
+    for (uint8_t s = _x->nSlices; s-- > 0 && n < _k;) {
+        uint64_t const *const b = &_x->slices[s * _x->nWords];
+        size_t c = 0;
+
+        for (size_t w = 0; w < _x->nWords; w++) {
+            c += nBitsSet64(_dst[w] | (e[w] & b[w]));
+        }
+        if (c > _k) {
+            /* Too many rows have this bit set, so keep only those */
+            andBits(e, e, b, _x->nWords);
+        } else {
+            /* All rows with this bit set are selected */
+            for (size_t w = 0; w < _x->nWords; w++) {
+                _dst[w] |= e[w] & b[w];
+                e[w] &= ~b[w];
+            }
+            n = c;
+        }
+    }
+    /* Of the rows with equal values, select the first ones */
+    for (size_t w = 0; w < _x->nWords && n < _k; w++) {
+        for (uint64_t v = e[w]; v != 0 && n < _k; v &= v - 1) {
+            _dst[w] |= v & -v;
+            n++;
+        }
+    }
+
+    return (n);
+}
+
+/********** Predicates ********************************************************/
+/**
+ * Comparison to make for _op on integers: less equal, not equal and greater
+ * equal select the rows that greater, equal and less do not.
+ */
+static CompareOp
+selectBaseOp(CompareOp const _op)
+{
+    switch (_op) {
+    case COMPARE_LESS_EQUAL:
+        return (COMPARE_GREATER);
+    case COMPARE_NOT_EQUAL:
+        return (COMPARE_EQUAL);
+    case COMPARE_GREATER_EQUAL:
+        return (COMPARE_LESS);
+    default:
+        return (_op);
+    }
+}
+
+/**
+ * Combine the selection of the _k rows of word _w with the selection bitmap,
+ * and count the selected rows.
+ */
+static uint8_t
+selectStore(uint64_t *const _dst, uint64_t const *const _valid,
+        size_t const _w, uint64_t _m, uint8_t const _k,
+        SelectMode const _mode)
+{
+    uint64_t const rows = (_k == 64) ? ~0ULL : (1ULL << _k) - 1;
+
+    _m &= (_valid != NULL) ? _valid[_w] & rows : rows;
+    if (_mode == SELECT_AND) {
+        _m &= _dst[_w];
+    } else if (_mode == SELECT_OR) {
+        _m |= _dst[_w] & rows;
+    }
+    _dst[_w] = (_dst[_w] & ~rows) | _m;
+
+    return (nBitsSet64(_m));
+}
+
+/** Select the _k values of a block of 8-bit integers by a comparison. */
+static uint64_t
+selectBlockInt8(int8_t const *const _col, uint8_t const _k,
+        CompareOp const _op, int8_t const _c)
+{
+    CompareOp const op = selectBaseOp(_op);
+    uint64_t m = 0;
+#ifdef BITOPERATIONS_USE_AVX512BW
+    __m512i const vc = _mm512_set1_epi8(_c);
+
+    for (uint8_t j = 0; j < _k; j += 64) {
+        __mmask64 const load = (_k == 64) ? ~0ULL : (1ULL << _k) - 1;
+        __m512i const v = _mm512_maskz_loadu_epi8(load, &_col[j]);
+
+        if (op == COMPARE_LESS) {
+            m |= (uint64_t)_mm512_cmplt_epi8_mask(v, vc) << j;
+        } else if (op == COMPARE_EQUAL) {
+            m |= (uint64_t)_mm512_cmpeq_epi8_mask(v, vc) << j;
+        } else {
+            m |= (uint64_t)_mm512_cmpgt_epi8_mask(v, vc) << j;
+        }
+    }
+#else
+    if (op == COMPARE_LESS) {
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] < _c) << j;
+        }
+    } else if (op == COMPARE_EQUAL) {
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] == _c) << j;
+        }
+    } else {
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] > _c) << j;
+        }
+    }
+#endif
+
+    return ((op != _op) ? ~m : m);
+}
+
+size_t
+selectCompareInt8(uint64_t *const _dst, int8_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, CompareOp const _op,
+        int8_t const _c, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+
+        n += selectStore(_dst, _valid, i / 64,
+                         selectBlockInt8(&_col[i], k, _op, _c), k, _mode);
+    }
+
+    return (n);
+}
+
+size_t
+selectBetweenInt8(uint64_t *const _dst, int8_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, int8_t const _lo,
+        int8_t const _hi, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+        uint64_t const m
+                = selectBlockInt8(&_col[i], k, COMPARE_GREATER_EQUAL, _lo)
+                & selectBlockInt8(&_col[i], k, COMPARE_LESS_EQUAL, _hi);
+
+        n += selectStore(_dst, _valid, i / 64, m, k, _mode);
+    }
+
+    return (n);
+}
+
+size_t
+selectInInt8(uint64_t *const _dst, int8_t const *const _col,
+        uint64_t const *const _valid, size_t const _n,
+        int8_t const *const _set, size_t const _nSet, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+        uint64_t m = 0;
+
+        for (size_t s = 0; s < _nSet; s++) {
+            m |= selectBlockInt8(&_col[i], k, COMPARE_EQUAL, _set[s]);
+        }
+        n += selectStore(_dst, _valid, i / 64, m, k, _mode);
+    }
+
+    return (n);
+}
+
+/** Select the _k values of a block of 16-bit integers by a comparison. */
+static uint64_t
+selectBlockInt16(int16_t const *const _col, uint8_t const _k,
+        CompareOp const _op, int16_t const _c)
+{
+    CompareOp const op = selectBaseOp(_op);
+    uint64_t m = 0;
+#ifdef BITOPERATIONS_USE_AVX512BW
+    __m512i const vc = _mm512_set1_epi16(_c);
+
+    for (uint8_t j = 0; j < _k; j += 32) {
+        __mmask32 const load = (_k - j >= 32) ? (__mmask32)~0U
+                : (__mmask32)((1U << (_k - j)) - 1);
+        __m512i const v = _mm512_maskz_loadu_epi16(load, &_col[j]);
+
+        if (op == COMPARE_LESS) {
+            m |= (uint64_t)_mm512_cmplt_epi16_mask(v, vc) << j;
+        } else if (op == COMPARE_EQUAL) {
+            m |= (uint64_t)_mm512_cmpeq_epi16_mask(v, vc) << j;
+        } else {
+            m |= (uint64_t)_mm512_cmpgt_epi16_mask(v, vc) << j;
+        }
+    }
+#else
+    if (op == COMPARE_LESS) {
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] < _c) << j;
+        }
+    } else if (op == COMPARE_EQUAL) {
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] == _c) << j;
+        }
+    } else {
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] > _c) << j;
+        }
+    }
+#endif
+
+    return ((op != _op) ? ~m : m);
+}
+
+size_t
+selectCompareInt16(uint64_t *const _dst, int16_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, CompareOp const _op,
+        int16_t const _c, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+
+        n += selectStore(_dst, _valid, i / 64,
+                         selectBlockInt16(&_col[i], k, _op, _c), k, _mode);
+    }
+
+    return (n);
+}
+
+size_t
+selectBetweenInt16(uint64_t *const _dst, int16_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, int16_t const _lo,
+        int16_t const _hi, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+        uint64_t const m
+                = selectBlockInt16(&_col[i], k, COMPARE_GREATER_EQUAL, _lo)
+                & selectBlockInt16(&_col[i], k, COMPARE_LESS_EQUAL, _hi);
+
+        n += selectStore(_dst, _valid, i / 64, m, k, _mode);
+    }
+
+    return (n);
+}
+
+size_t
+selectInInt16(uint64_t *const _dst, int16_t const *const _col,
+        uint64_t const *const _valid, size_t const _n,
+        int16_t const *const _set, size_t const _nSet, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+        uint64_t m = 0;
+
+        for (size_t s = 0; s < _nSet; s++) {
+            m |= selectBlockInt16(&_col[i], k, COMPARE_EQUAL, _set[s]);
+        }
+        n += selectStore(_dst, _valid, i / 64, m, k, _mode);
+    }
+
+    return (n);
+}
+
+/** Select the _k values of a block of 32-bit integers by a comparison. */
+static uint64_t
+selectBlockInt32(int32_t const *const _col, uint8_t const _k,
+        CompareOp const _op, int32_t const _c)
+{
+    CompareOp const op = selectBaseOp(_op);
+    uint64_t m = 0;
+#ifdef BITOPERATIONS_USE_AVX512F
+    __m512i const vc = _mm512_set1_epi32(_c);
+
+    for (uint8_t j = 0; j < _k; j += 16) {
+        __mmask16 const load = (_k - j >= 16) ? (__mmask16)~0U
+                : (__mmask16)((1U << (_k - j)) - 1);
+        __m512i const v = _mm512_maskz_loadu_epi32(load, &_col[j]);
+
+        if (op == COMPARE_LESS) {
+            m |= (uint64_t)_mm512_cmplt_epi32_mask(v, vc) << j;
+        } else if (op == COMPARE_EQUAL) {
+            m |= (uint64_t)_mm512_cmpeq_epi32_mask(v, vc) << j;
+        } else {
+            m |= (uint64_t)_mm512_cmpgt_epi32_mask(v, vc) << j;
+        }
+    }
+#else
+    if (op == COMPARE_LESS) {
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] < _c) << j;
+        }
+    } else if (op == COMPARE_EQUAL) {
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] == _c) << j;
+        }
+    } else {
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] > _c) << j;
+        }
+    }
+#endif
+
+    return ((op != _op) ? ~m : m);
+}
+
+size_t
+selectCompareInt32(uint64_t *const _dst, int32_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, CompareOp const _op,
+        int32_t const _c, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+
+        n += selectStore(_dst, _valid, i / 64,
+                         selectBlockInt32(&_col[i], k, _op, _c), k, _mode);
+    }
+
+    return (n);
+}
+
+size_t
+selectBetweenInt32(uint64_t *const _dst, int32_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, int32_t const _lo,
+        int32_t const _hi, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+        uint64_t const m
+                = selectBlockInt32(&_col[i], k, COMPARE_GREATER_EQUAL, _lo)
+                & selectBlockInt32(&_col[i], k, COMPARE_LESS_EQUAL, _hi);
+
+        n += selectStore(_dst, _valid, i / 64, m, k, _mode);
+    }
+
+    return (n);
+}
+
+size_t
+selectInInt32(uint64_t *const _dst, int32_t const *const _col,
+        uint64_t const *const _valid, size_t const _n,
+        int32_t const *const _set, size_t const _nSet, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+        uint64_t m = 0;
+
+        for (size_t s = 0; s < _nSet; s++) {
+            m |= selectBlockInt32(&_col[i], k, COMPARE_EQUAL, _set[s]);
+        }
+        n += selectStore(_dst, _valid, i / 64, m, k, _mode);
+    }
+
+    return (n);
+}
+
+/** Select the _k values of a block of 64-bit integers by a comparison. */
+static uint64_t
+selectBlockInt64(int64_t const *const _col, uint8_t const _k,
+        CompareOp const _op, int64_t const _c)
+{
+    CompareOp const op = selectBaseOp(_op);
+    uint64_t m = 0;
+#ifdef BITOPERATIONS_USE_AVX512F
+    __m512i const vc = _mm512_set1_epi64(_c);
+
+    for (uint8_t j = 0; j < _k; j += 8) {
+        __mmask8 const load = (_k - j >= 8) ? (__mmask8)~0U
+                : (__mmask8)((1U << (_k - j)) - 1);
+        __m512i const v = _mm512_maskz_loadu_epi64(load, &_col[j]);
+
+        if (op == COMPARE_LESS) {
+            m |= (uint64_t)_mm512_cmplt_epi64_mask(v, vc) << j;
+        } else if (op == COMPARE_EQUAL) {
+            m |= (uint64_t)_mm512_cmpeq_epi64_mask(v, vc) << j;
+        } else {
+            m |= (uint64_t)_mm512_cmpgt_epi64_mask(v, vc) << j;
+        }
+    }
+#else
+    if (op == COMPARE_LESS) {
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] < _c) << j;
+        }
+    } else if (op == COMPARE_EQUAL) {
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] == _c) << j;
+        }
+    } else {
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] > _c) << j;
+        }
+    }
+#endif
+
+    return ((op != _op) ? ~m : m);
+}
+
+size_t
+selectCompareInt64(uint64_t *const _dst, int64_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, CompareOp const _op,
+        int64_t const _c, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+
+        n += selectStore(_dst, _valid, i / 64,
+                         selectBlockInt64(&_col[i], k, _op, _c), k, _mode);
+    }
+
+    return (n);
+}
+
+size_t
+selectBetweenInt64(uint64_t *const _dst, int64_t const *const _col,
+        uint64_t const *const _valid, size_t const _n, int64_t const _lo,
+        int64_t const _hi, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+        uint64_t const m
+                = selectBlockInt64(&_col[i], k, COMPARE_GREATER_EQUAL, _lo)
+                & selectBlockInt64(&_col[i], k, COMPARE_LESS_EQUAL, _hi);
+
+        n += selectStore(_dst, _valid, i / 64, m, k, _mode);
+    }
+
+    return (n);
+}
+
+size_t
+selectInInt64(uint64_t *const _dst, int64_t const *const _col,
+        uint64_t const *const _valid, size_t const _n,
+        int64_t const *const _set, size_t const _nSet, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+        uint64_t m = 0;
+
+        for (size_t s = 0; s < _nSet; s++) {
+            m |= selectBlockInt64(&_col[i], k, COMPARE_EQUAL, _set[s]);
+        }
+        n += selectStore(_dst, _valid, i / 64, m, k, _mode);
+    }
+
+    return (n);
+}
+
+/**
+ * Select the _k values of a block of floats by a comparison. Not equal is
+ * the complement of equal, which selects NaN as well; the other comparisons
+ * are made directly, as they do not select NaN.
+ */
+static uint64_t
+selectBlockFloat(float const *const _col, uint8_t const _k,
+        CompareOp const _op, float const _c)
+{
+    CompareOp const op = (_op == COMPARE_NOT_EQUAL) ? COMPARE_EQUAL : _op;
+    uint64_t m = 0;
+#ifdef BITOPERATIONS_USE_AVX512F
+    __m512 const vc = _mm512_set1_ps(_c);
+
+    for (uint8_t j = 0; j < _k; j += 16) {
+        __mmask16 const load = (_k - j >= 16) ? (__mmask16)~0U
+                : (__mmask16)((1U << (_k - j)) - 1);
+        __m512 const v = _mm512_maskz_loadu_ps(load, &_col[j]);
+
+        switch (op) {
+        case COMPARE_LESS:
+            m |= (uint64_t)_mm512_cmp_ps_mask(v, vc, _CMP_LT_OQ) << j;
+            break;
+        case COMPARE_LESS_EQUAL:
+            m |= (uint64_t)_mm512_cmp_ps_mask(v, vc, _CMP_LE_OQ) << j;
+            break;
+        case COMPARE_EQUAL:
+            m |= (uint64_t)_mm512_cmp_ps_mask(v, vc, _CMP_EQ_OQ) << j;
+            break;
+        case COMPARE_GREATER_EQUAL:
+            m |= (uint64_t)_mm512_cmp_ps_mask(v, vc, _CMP_GE_OQ) << j;
+            break;
+        default:
+            m |= (uint64_t)_mm512_cmp_ps_mask(v, vc, _CMP_GT_OQ) << j;
+            break;
+        }
+    }
+#else
+    switch (op) {
+    case COMPARE_LESS:
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] < _c) << j;
+        }
+        break;
+    case COMPARE_LESS_EQUAL:
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] <= _c) << j;
+        }
+        break;
+    case COMPARE_EQUAL:
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] == _c) << j;
+        }
+        break;
+    case COMPARE_GREATER_EQUAL:
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] >= _c) << j;
+        }
+        break;
+    default:
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] > _c) << j;
+        }
+        break;
+    }
+#endif
+
+    return ((op != _op) ? ~m : m);
+}
+
+size_t
+selectCompareFloat(uint64_t *const _dst, float const *const _col,
+        uint64_t const *const _valid, size_t const _n, CompareOp const _op,
+        float const _c, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+
+        n += selectStore(_dst, _valid, i / 64,
+                         selectBlockFloat(&_col[i], k, _op, _c), k, _mode);
+    }
+
+    return (n);
+}
+
+size_t
+selectBetweenFloat(uint64_t *const _dst, float const *const _col,
+        uint64_t const *const _valid, size_t const _n, float const _lo,
+        float const _hi, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+        uint64_t const m
+                = selectBlockFloat(&_col[i], k, COMPARE_GREATER_EQUAL, _lo)
+                & selectBlockFloat(&_col[i], k, COMPARE_LESS_EQUAL, _hi);
+
+        n += selectStore(_dst, _valid, i / 64, m, k, _mode);
+    }
+
+    return (n);
+}
+
+size_t
+selectInFloat(uint64_t *const _dst, float const *const _col,
+        uint64_t const *const _valid, size_t const _n,
+        float const *const _set, size_t const _nSet, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+        uint64_t m = 0;
+
+        for (size_t s = 0; s < _nSet; s++) {
+            m |= selectBlockFloat(&_col[i], k, COMPARE_EQUAL, _set[s]);
+        }
+        n += selectStore(_dst, _valid, i / 64, m, k, _mode);
+    }
+
+    return (n);
+}
+
+/**
+ * Select the _k values of a block of doubles by a comparison. Not equal is
+ * the complement of equal, which selects NaN as well; the other comparisons
+ * are made directly, as they do not select NaN.
+ */
+static uint64_t
+selectBlockDouble(double const *const _col, uint8_t const _k,
+        CompareOp const _op, double const _c)
+{
+    CompareOp const op = (_op == COMPARE_NOT_EQUAL) ? COMPARE_EQUAL : _op;
+    uint64_t m = 0;
+#ifdef BITOPERATIONS_USE_AVX512F
+    __m512d const vc = _mm512_set1_pd(_c);
+
+    for (uint8_t j = 0; j < _k; j += 8) {
+        __mmask8 const load = (_k - j >= 8) ? (__mmask8)~0U
+                : (__mmask8)((1U << (_k - j)) - 1);
+        __m512d const v = _mm512_maskz_loadu_pd(load, &_col[j]);
+
+        switch (op) {
+        case COMPARE_LESS:
+            m |= (uint64_t)_mm512_cmp_pd_mask(v, vc, _CMP_LT_OQ) << j;
+            break;
+        case COMPARE_LESS_EQUAL:
+            m |= (uint64_t)_mm512_cmp_pd_mask(v, vc, _CMP_LE_OQ) << j;
+            break;
+        case COMPARE_EQUAL:
+            m |= (uint64_t)_mm512_cmp_pd_mask(v, vc, _CMP_EQ_OQ) << j;
+            break;
+        case COMPARE_GREATER_EQUAL:
+            m |= (uint64_t)_mm512_cmp_pd_mask(v, vc, _CMP_GE_OQ) << j;
+            break;
+        default:
+            m |= (uint64_t)_mm512_cmp_pd_mask(v, vc, _CMP_GT_OQ) << j;
+            break;
+        }
+    }
+#else
+    switch (op) {
+    case COMPARE_LESS:
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] < _c) << j;
+        }
+        break;
+    case COMPARE_LESS_EQUAL:
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] <= _c) << j;
+        }
+        break;
+    case COMPARE_EQUAL:
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] == _c) << j;
+        }
+        break;
+    case COMPARE_GREATER_EQUAL:
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] >= _c) << j;
+        }
+        break;
+    default:
+        for (uint8_t j = 0; j < _k; j++) {
+            m |= (uint64_t)(_col[j] > _c) << j;
+        }
+        break;
+    }
+#endif
+
+    return ((op != _op) ? ~m : m);
+}
+
+size_t
+selectCompareDouble(uint64_t *const _dst, double const *const _col,
+        uint64_t const *const _valid, size_t const _n, CompareOp const _op,
+        double const _c, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+
+        n += selectStore(_dst, _valid, i / 64,
+                         selectBlockDouble(&_col[i], k, _op, _c), k, _mode);
+    }
+
+    return (n);
+}
+
+size_t
+selectBetweenDouble(uint64_t *const _dst, double const *const _col,
+        uint64_t const *const _valid, size_t const _n, double const _lo,
+        double const _hi, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+        uint64_t const m
+                = selectBlockDouble(&_col[i], k, COMPARE_GREATER_EQUAL, _lo)
+                & selectBlockDouble(&_col[i], k, COMPARE_LESS_EQUAL, _hi);
+
+        n += selectStore(_dst, _valid, i / 64, m, k, _mode);
+    }
+
+    return (n);
+}
+
+size_t
+selectInDouble(uint64_t *const _dst, double const *const _col,
+        uint64_t const *const _valid, size_t const _n,
+        double const *const _set, size_t const _nSet, SelectMode const _mode)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _n; i += 64) {
+        uint8_t const k = (_n - i < 64) ? _n - i : 64;
+        uint64_t m = 0;
+
+        for (size_t s = 0; s < _nSet; s++) {
+            m |= selectBlockDouble(&_col[i], k, COMPARE_EQUAL, _set[s]);
+        }
+        n += selectStore(_dst, _valid, i / 64, m, k, _mode);
+    }
+
+    return (n);
+}
+
+/********** Eytzinger search **************************************************/
+/**
+ * Fill the subtree of node _k in order with the keys from _src[_i] on, and
+ * return the index of the next key.
+ */
+static size_t
+eytzingerFill(uint32_t *const _dst, size_t *const _order,
+        uint32_t const *const _src, size_t _i, size_t const _k,
+        size_t const _n)
+{
+    if (_k <= _n) {
+        _i = eytzingerFill(_dst, _order, _src, _i, 2 * _k, _n);
+        _dst[_k] = _src[_i];
+        if (_order != NULL) {
+            _order[_k] = _i;
+        }
+        _i = eytzingerFill(_dst, _order, _src, _i + 1, 2 * _k + 1, _n);
+    }
+
+    return (_i);
+}
+
+void
+eytzingerBuild(uint32_t *const _dst, size_t *const _order,
+        uint32_t const *const _src, size_t const _n)
+{
+    _dst[0] = 0;
+    eytzingerFill(_dst, _order, _src, 0, 1, _n);
+
+    return;
+}
+
+size_t
+eytzingerLowerBound(uint32_t const *const _keys, size_t const _n,
+        uint32_t const _x)
+{
+    uint64_t k = 1;
+
+    while (k <= _n) {
+        /* The 16 descendants four levels down share a cache line */
+        PREFETCH(&_keys[16 * k]);
+        k = 2 * k + (_keys[k] < _x);
+    }
+
+    return (k >> (nTrailingZeros64(~k) + 1));
+}
+
 /* End of file BitOperations.c */